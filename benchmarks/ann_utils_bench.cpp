@@ -0,0 +1,80 @@
+// Recall and latency of HnswIndex against the exact brute-force similarity path.
+// Usage: ann_utils_bench [gallery_size] [dim] [num_queries]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/ann_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    const size_t gallery_size = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const size_t dim = argc > 2 ? std::stoul(argv[2]) : 128;
+    const size_t num_queries = argc > 3 ? std::stoul(argv[3]) : 200;
+    const size_t k = 10;
+
+    // Clustered embeddings: one cluster per identity, several views each
+    cv::RNG rng(1);
+    const size_t identities = std::max<size_t>(1, gallery_size / 20);
+    std::vector<float> centers(identities * dim), gallery(gallery_size * dim), queries(num_queries * dim);
+    for (auto &v : centers)
+        v = rng.uniform(-1.f, 1.f);
+    for (size_t i = 0; i < gallery_size; ++i)
+        for (size_t d = 0; d < dim; ++d)
+            gallery[i * dim + d] = centers[(i % identities) * dim + d] + rng.gaussian(1.0f);
+    for (size_t q = 0; q < num_queries; ++q)
+        for (size_t d = 0; d < dim; ++d)
+            queries[q * dim + d] = centers[(q * 7 % identities) * dim + d] + rng.gaussian(1.0f);
+    normalizeRows(gallery.data(), gallery_size, dim);
+    normalizeRows(queries.data(), num_queries, dim);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "gallery " << gallery_size << " x " << dim << ", " << num_queries << " queries, top-" << k << "\n";
+
+    // Exact reference
+    std::vector<float> similarities(gallery_size);
+    std::vector<std::vector<int64_t>> exact(num_queries);
+    auto start = Clock::now();
+    for (size_t q = 0; q < num_queries; ++q)
+    {
+        cosineSimilarityMatrix(queries.data() + q * dim, 1, gallery.data(), gallery_size, dim, similarities.data());
+        std::vector<int64_t> order(gallery_size);
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int64_t a, int64_t b)
+                          { return similarities[a] > similarities[b]; });
+        exact[q].assign(order.begin(), order.begin() + k);
+    }
+    std::cout << "brute force:  " << elapsedMs(start) / num_queries << " ms/query\n";
+
+    start = Clock::now();
+    HnswIndex index(dim);
+    for (size_t i = 0; i < gallery_size; ++i)
+        index.insert(static_cast<int64_t>(i), gallery.data() + i * dim);
+    std::cout << "hnsw build:   " << elapsedMs(start) / 1000.0 << " s\n";
+
+    for (size_t ef : {16, 32, 64, 128, 256})
+    {
+        index.setEfSearch(ef);
+
+        std::vector<AnnResult> results;
+        size_t hits = 0;
+        start = Clock::now();
+        for (size_t q = 0; q < num_queries; ++q)
+        {
+            index.search(queries.data() + q * dim, k, 0.f, results);
+            for (const auto &result : results)
+                hits += std::count(exact[q].begin(), exact[q].end(), result.track_id);
+        }
+        const double latency = elapsedMs(start) / num_queries;
+        std::cout << "hnsw ef=" << std::setw(3) << ef << ":  " << latency << " ms/query, recall@" << k << " "
+                  << static_cast<double>(hits) / (num_queries * k) << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Detection-to-track assignment from 10x10 to 2000x2000: a textbook Munkres (Hungarian) solver
+// against the dense LAPJV solveAssignment, plus the gated sparse mode on a box-overlap candidate
+// list of a tracking-like scene. Munkres is skipped above naive_max, where it takes seconds.
+// Usage: assignment_utils_bench [max_size] [naive_max] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/assignment_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+// Munkres with starred and primed zeros and line covers, as commonly hand-written for trackers
+static double munkres(const std::vector<float> &input, size_t n, std::vector<int> &row_to_col)
+{
+    std::vector<double> cost(input.begin(), input.end());
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double min = *std::min_element(cost.begin() + i * n, cost.begin() + (i + 1) * n);
+        for (size_t j = 0; j < n; ++j)
+            cost[i * n + j] -= min;
+    }
+
+    std::vector<uint8_t> mark(n * n, 0); // 1 starred, 2 primed
+    std::vector<uint8_t> row_cover(n, 0), col_cover(n, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (cost[i * n + j] == 0.0 && !row_cover[i] && !col_cover[j])
+            {
+                mark[i * n + j] = 1;
+                row_cover[i] = col_cover[j] = 1;
+            }
+        }
+    }
+    std::fill(row_cover.begin(), row_cover.end(), 0);
+
+    std::vector<std::pair<size_t, size_t>> path;
+    while (true)
+    {
+        std::fill(col_cover.begin(), col_cover.end(), 0);
+        size_t covered = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                if (mark[i * n + j] == 1 && !col_cover[j])
+                {
+                    col_cover[j] = 1;
+                    ++covered;
+                }
+        if (covered == n)
+            break;
+
+        while (true)
+        {
+            // Find an uncovered zero, or shift the uncovered minimum into the covered lines
+            size_t zi = n, zj = n;
+            for (size_t i = 0; i < n && zi == n; ++i)
+                if (!row_cover[i])
+                    for (size_t j = 0; j < n; ++j)
+                        if (!col_cover[j] && cost[i * n + j] == 0.0)
+                        {
+                            zi = i;
+                            zj = j;
+                            break;
+                        }
+            if (zi == n)
+            {
+                double min = std::numeric_limits<double>::max();
+                for (size_t i = 0; i < n; ++i)
+                    if (!row_cover[i])
+                        for (size_t j = 0; j < n; ++j)
+                            if (!col_cover[j])
+                                min = std::min(min, cost[i * n + j]);
+                for (size_t i = 0; i < n; ++i)
+                    for (size_t j = 0; j < n; ++j)
+                        cost[i * n + j] += (row_cover[i] ? min : 0.0) - (col_cover[j] ? 0.0 : min);
+                continue;
+            }
+
+            mark[zi * n + zj] = 2;
+            size_t star = n;
+            for (size_t j = 0; j < n; ++j)
+                if (mark[zi * n + j] == 1)
+                    star = j;
+            if (star < n)
+            {
+                row_cover[zi] = 1;
+                col_cover[star] = 0;
+                continue;
+            }
+
+            // Alternating path of primes and stars starting at the uncovered prime
+            path.assign(1, {zi, zj});
+            while (true)
+            {
+                size_t row = n;
+                for (size_t i = 0; i < n; ++i)
+                    if (mark[i * n + path.back().second] == 1)
+                        row = i;
+                if (row == n)
+                    break;
+                path.emplace_back(row, path.back().second);
+                for (size_t j = 0; j < n; ++j)
+                    if (mark[row * n + j] == 2)
+                        path.emplace_back(row, j);
+            }
+            for (const auto &[i, j] : path)
+                mark[i * n + j] = mark[i * n + j] == 1 ? 0 : 1;
+            for (uint8_t &m : mark)
+                if (m == 2)
+                    m = 0;
+            std::fill(row_cover.begin(), row_cover.end(), 0);
+            break;
+        }
+    }
+
+    double total = 0.0;
+    row_to_col.assign(n, -1);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            if (mark[i * n + j] == 1)
+            {
+                row_to_col[i] = static_cast<int>(j);
+                total += input[i * n + j];
+            }
+    return total;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t max_size = argc > 1 ? std::stoul(argv[1]) : 2000;
+    const size_t naive_max = argc > 2 ? std::stoul(argv[2]) : 200;
+    const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 3;
+    const float no_gate = std::numeric_limits<float>::infinity();
+
+    cv::RNG rng(1);
+    AssignmentWorkspace ws;
+    std::vector<int> row_to_col, col_to_row;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "dense uniform costs, ms per solve\n";
+    std::cout << "      n     munkres      lapjv\n";
+    for (size_t n : {10, 50, 100, 200, 500, 1000, 2000})
+    {
+        if (n > max_size)
+            break;
+        std::vector<float> cost(n * n);
+        for (float &c : cost)
+            c = rng.uniform(0.f, 1.f);
+
+        double naive_ms = -1.0, naive_total = 0.0;
+        if (n <= naive_max)
+        {
+            auto start = Clock::now();
+            for (size_t it = 0; it < iterations; ++it)
+                naive_total = munkres(cost, n, row_to_col);
+            naive_ms = elapsedMs(start, iterations);
+        }
+
+        auto start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            solveAssignment(cost.data(), n, n, no_gate, ws, row_to_col, col_to_row);
+        const double lapjv_ms = elapsedMs(start, iterations);
+
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i)
+            total += cost[i * n + row_to_col[i]];
+
+        std::cout << std::setw(7) << n << std::setw(12);
+        if (naive_ms < 0.0)
+            std::cout << "-";
+        else
+            std::cout << naive_ms;
+        std::cout << std::setw(11) << lapjv_ms
+                  << (naive_ms >= 0.0 && std::abs(total - naive_total) > 1e-3 * n ? "  (cost mismatch)" : "") << "\n";
+    }
+
+    // Tracking scene: tracks spread over a 4K frame, detections are the tracks jittered, with
+    // 10% of the tracks lost and as many new detections; gated at IoU 0.3
+    std::cout << "tracking scene, 1 - IoU gated at 0.7, ms per frame\n";
+    std::cout << "      n  dense IoU+lapjv  overlaps+sparse\n";
+    std::vector<float> cost;
+    std::vector<BoxOverlap> overlaps;
+    for (size_t n : {10, 100, 500, 1000, 2000})
+    {
+        if (n > max_size)
+            break;
+        std::vector<cv::Rect2f> tracks(n), detections;
+        for (auto &box : tracks)
+            box = cv::Rect2f(rng.uniform(0.f, 3800.f), rng.uniform(0.f, 2100.f), rng.uniform(20.f, 60.f), rng.uniform(40.f, 120.f));
+        for (size_t i = 0; i < n; ++i)
+        {
+            cv::Rect2f box = tracks[i];
+            if (i % 10 == 0)
+                box = cv::Rect2f(rng.uniform(0.f, 3800.f), rng.uniform(0.f, 2100.f), box.width, box.height);
+            detections.push_back(cv::Rect2f(box.x + rng.uniform(-4.f, 4.f), box.y + rng.uniform(-4.f, 4.f), box.width, box.height));
+        }
+
+        size_t dense_matches = 0, sparse_matches = 0;
+        auto start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+        {
+            cost.resize(n * n);
+            getIoUMatrix(tracks, detections, cost.data());
+            for (float &c : cost)
+                c = 1.f - c;
+            dense_matches = solveAssignment(cost.data(), n, n, 0.7f, ws, row_to_col, col_to_row);
+        }
+        const double dense_ms = elapsedMs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+        {
+            findOverlaps(tracks, detections, 0.f, overlaps);
+            sparse_matches = solveAssignment(overlaps, n, n, 0.7f, ws, row_to_col, col_to_row);
+        }
+        const double sparse_ms = elapsedMs(start, iterations);
+
+        std::cout << std::setw(7) << n << std::setw(17) << dense_ms << std::setw(17) << sparse_ms
+                  << (dense_matches == sparse_matches ? "" : "  (match count mismatch)") << "\n";
+    }
+
+    return 0;
+}
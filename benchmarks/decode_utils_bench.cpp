@@ -0,0 +1,92 @@
+// decodeDetections on a YOLOv8-sized output against per-anchor std::vector copies with vector_ops::argmax
+// and manual letterbox undoing, at each SIMD level.
+// Usage: decode_utils_bench [anchors] [classes] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/decode_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_anchors = argc > 1 ? std::stoul(argv[1]) : 8400;
+    const int num_classes = argc > 2 ? std::stoi(argv[2]) : 80;
+    const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 200;
+
+    // Attributes-first output with mostly low scores, as from a real scene
+    const size_t num_attributes = 4 + static_cast<size_t>(num_classes);
+    std::vector<float> output(num_attributes * num_anchors);
+    cv::RNG rng(1);
+    for (size_t a = 0; a < num_anchors; ++a)
+    {
+        output[a] = rng.uniform(0.f, 640.f);
+        output[num_anchors + a] = rng.uniform(0.f, 640.f);
+        output[2 * num_anchors + a] = rng.uniform(8.f, 200.f);
+        output[3 * num_anchors + a] = rng.uniform(8.f, 200.f);
+        for (size_t k = 4; k < num_attributes; ++k)
+            output[k * num_anchors + a] = rng.uniform(0.f, 0.05f);
+        if (a % 100 == 0)
+            output[(4 + a % num_classes) * num_anchors + a] = 0.9f;
+    }
+
+    LetterboxParams letterbox_params;
+    const LetterboxInfo info = getLetterboxInfo(cv::Size(1920, 1080), letterbox_params);
+    DecodeParams params;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << num_anchors << " anchors x " << num_classes << " classes, ms per image\n";
+
+    size_t naive_count = 0;
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        std::vector<Detection> detections;
+        for (size_t a = 0; a < num_anchors; ++a)
+        {
+            std::vector<float> scores(num_classes);
+            for (int c = 0; c < num_classes; ++c)
+                scores[c] = output[(4 + c) * num_anchors + a];
+            const size_t best = vector_ops::argmax(scores);
+            if (scores[best] < params.score_threshold)
+                continue;
+
+            Detection det;
+            det.class_id = static_cast<int>(best);
+            det.confidence = scores[best];
+            const float w = output[2 * num_anchors + a], h = output[3 * num_anchors + a];
+            det.bbox = info.toSource(cv::Rect2f(output[a] - w / 2, output[num_anchors + a] - h / 2, w, h));
+            detections.push_back(det);
+        }
+        naive_count = detections.size();
+    }
+    std::cout << "per-anchor vectors   " << std::setw(10) << elapsedMs(start, iterations) << "\n";
+
+    const std::pair<simd::Level, const char *> levels[] = {
+        {simd::Level::Scalar, "scalar"}, {simd::Level::SSE4, "sse4"}, {simd::Level::AVX2, "avx2"}, {simd::Level::AVX512, "avx512"}};
+    DecodeWorkspace ws;
+    DetectionBatch batch;
+    for (const auto &[level, name] : levels)
+    {
+        if (level > simd::detectLevel())
+            continue;
+        simd::setLevel(level);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+        {
+            batch.clear();
+            decodeDetections(output.data(), num_anchors, num_classes, params, info, ws, batch);
+        }
+        std::cout << "decodeDetections " << std::setw(6) << name << std::setw(8) << elapsedMs(start, iterations)
+                  << (batch.size() == naive_count ? "" : "  (count mismatch)") << "\n";
+    }
+    simd::setLevel(simd::detectLevel());
+
+    return 0;
+}
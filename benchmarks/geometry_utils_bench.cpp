@@ -0,0 +1,87 @@
+// ReID association cost: tracks x detections cosine similarity with pairwise cosineSimilarity on
+// std::vector features against cosineSimilarityMatrix on normalized contiguous rows, at each SIMD
+// level and with several threads.
+// Usage: geometry_utils_bench [tracks] [detections] [dim] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/geometry_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_tracks = argc > 1 ? std::stoul(argv[1]) : 500;
+    const size_t num_detections = argc > 2 ? std::stoul(argv[2]) : 300;
+    const size_t dim = argc > 3 ? std::stoul(argv[3]) : 512;
+    const size_t iterations = argc > 4 ? std::stoul(argv[4]) : 10;
+
+    cv::RNG rng(1);
+    std::vector<std::vector<float>> tracks(num_tracks, std::vector<float>(dim)), detections(num_detections, std::vector<float>(dim));
+    for (auto &features : tracks)
+        for (float &v : features)
+            v = rng.uniform(-1.f, 1.f);
+    for (auto &features : detections)
+        for (float &v : features)
+            v = rng.uniform(-1.f, 1.f);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << num_tracks << " tracks x " << num_detections << " detections x " << dim << "-d, ms per matrix\n";
+
+    std::vector<float> reference(num_tracks * num_detections);
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        for (size_t i = 0; i < num_tracks; ++i)
+            for (size_t j = 0; j < num_detections; ++j)
+                reference[i * num_detections + j] = cosineSimilarity(tracks[i], detections[j]);
+    std::cout << "pairwise cosineSimilarity      " << std::setw(10) << elapsedMs(start, iterations) << "\n";
+
+    // Contiguous rows, normalized once (tracks would keep them normalized between frames)
+    std::vector<float> gallery(num_tracks * dim), query(num_detections * dim), matrix(num_tracks * num_detections);
+    for (size_t i = 0; i < num_tracks; ++i)
+        std::copy(tracks[i].begin(), tracks[i].end(), gallery.begin() + i * dim);
+    for (size_t j = 0; j < num_detections; ++j)
+        std::copy(detections[j].begin(), detections[j].end(), query.begin() + j * dim);
+    start = Clock::now();
+    normalizeRows(gallery.data(), num_tracks, dim);
+    normalizeRows(query.data(), num_detections, dim);
+    std::cout << "normalizeRows (both sets)      " << std::setw(10) << elapsedMs(start, 1) << "\n";
+
+    auto max_error = [&]()
+    {
+        float error = 0.f;
+        for (size_t k = 0; k < matrix.size(); ++k)
+            error = std::max(error, std::abs(matrix[k] - reference[k]));
+        return error;
+    };
+
+    const std::pair<simd::Level, const char *> levels[] = {{simd::Level::Scalar, "scalar"}, {simd::Level::AVX2, "avx2"}};
+    for (const auto &[level, name] : levels)
+    {
+        if (level > simd::detectLevel())
+            continue;
+        simd::setLevel(level);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            cosineSimilarityMatrix(gallery.data(), num_tracks, query.data(), num_detections, dim, matrix.data());
+        std::cout << "cosineSimilarityMatrix " << std::setw(6) << name << "  " << std::setw(10) << elapsedMs(start, iterations)
+                  << "  (max error " << std::scientific << std::setprecision(1) << max_error() << std::fixed << std::setprecision(3) << ")\n";
+    }
+    simd::setLevel(simd::detectLevel());
+
+    for (size_t threads : {2, 4})
+    {
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            cosineSimilarityMatrix(gallery.data(), num_tracks, query.data(), num_detections, dim, matrix.data(), threads);
+        std::cout << "cosineSimilarityMatrix " << threads << " threads" << std::setw(10) << elapsedMs(start, iterations) << "\n";
+    }
+
+    return 0;
+}
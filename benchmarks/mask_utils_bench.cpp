@@ -0,0 +1,124 @@
+// Instance masks for a 4K frame: full-frame dense masks (prototype mask + getAbsoluteMask) against
+// ROI-local decodeMasks into BitMasks, plus the pairwise mask IoU matrix on both representations.
+// Usage: mask_utils_bench [masks] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/mask_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_masks = argc > 1 ? std::stoul(argv[1]) : 100;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 3;
+
+    const int num_protos = 32;
+    const cv::Size proto_size(160, 160);
+    const size_t plane = static_cast<size_t>(proto_size.area());
+    LetterboxParams letterbox_params;
+    const LetterboxInfo info = getLetterboxInfo(cv::Size(3840, 2160), letterbox_params);
+
+    cv::RNG rng(1);
+    std::vector<float> protos(num_protos * plane);
+    for (float &value : protos)
+        value = rng.uniform(-1.f, 1.f);
+    std::vector<float> coefficients(num_masks * num_protos);
+    for (float &value : coefficients)
+        value = rng.uniform(-0.5f, 0.5f);
+    std::vector<cv::Rect2f> boxes(num_masks);
+    for (auto &box : boxes)
+        box = cv::Rect2f(rng.uniform(0.f, 3400.f), rng.uniform(0.f, 1800.f), rng.uniform(40.f, 400.f), rng.uniform(80.f, 400.f));
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << num_masks << " masks on a 4K frame, " << num_protos << "x" << proto_size.width << "x" << proto_size.height << " prototypes\n";
+
+    // Dense: the whole prototype grid per instance, upsampled to the full frame
+    std::vector<cv::Mat> dense(num_masks);
+    cv::Mat probabilities(proto_size, CV_32F);
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (size_t i = 0; i < num_masks; ++i)
+        {
+            float *values = probabilities.ptr<float>();
+            std::fill(values, values + plane, 0.f);
+            for (int k = 0; k < num_protos; ++k)
+                for (size_t p = 0; p < plane; ++p)
+                    values[p] += coefficients[i * num_protos + k] * protos[k * plane + p];
+            vector_ops::sigmoid(values, plane, values);
+            cv::Mat full = getAbsoluteMask(probabilities, info.shape);
+            dense[i] = getAbsoluteMask(full(cv::Rect(info.left, info.top, info.resized.width, info.resized.height)), info.source);
+        }
+    }
+    const double dense_ms = elapsedMs(start, iterations);
+
+    MaskWorkspace ws;
+    std::vector<BitMask> masks;
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        decodeMasks(protos.data(), num_protos, proto_size, coefficients.data(), boxes.data(), num_masks, info, ws, masks);
+    const double packed_ms = elapsedMs(start, iterations);
+
+    size_t dense_bytes = 0, packed_bytes = 0, rle_bytes = 0;
+    for (size_t i = 0; i < num_masks; ++i)
+    {
+        dense_bytes += dense[i].total();
+        packed_bytes += masks[i].bytes();
+        rle_bytes += rleToString(encodeRle(masks[i])).size();
+    }
+
+    std::cout << "decode, ms per frame\n";
+    std::cout << "  dense full-frame    " << std::setw(10) << dense_ms << "\n";
+    std::cout << "  decodeMasks         " << std::setw(10) << packed_ms << "\n";
+    std::cout << "memory, MB\n";
+    std::cout << "  dense CV_8U         " << std::setw(10) << dense_bytes / 1e6 << "\n";
+    std::cout << "  BitMask             " << std::setw(10) << packed_bytes / 1e6 << "\n";
+    std::cout << "  COCO RLE string     " << std::setw(10) << rle_bytes / 1e6 << "\n";
+
+    // Pairwise IoU: byte loops over the box overlap of dense masks against popcount over overlapping words
+    std::vector<float> matrix(num_masks * num_masks);
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        std::vector<size_t> areas(num_masks, 0);
+        for (size_t i = 0; i < num_masks; ++i)
+            for (int y = masks[i].roi.y; y < masks[i].roi.y + masks[i].roi.height; ++y)
+                for (int x = masks[i].roi.x; x < masks[i].roi.x + masks[i].roi.width; ++x)
+                    areas[i] += dense[i].at<uchar>(y, x);
+
+        for (size_t i = 0; i < num_masks; ++i)
+        {
+            for (size_t j = 0; j < num_masks; ++j)
+            {
+                const cv::Rect overlap = masks[i].roi & masks[j].roi;
+                size_t intersection = 0;
+                for (int y = overlap.y; y < overlap.y + overlap.height; ++y)
+                {
+                    const uchar *a = dense[i].ptr<uchar>(y), *b = dense[j].ptr<uchar>(y);
+                    for (int x = overlap.x; x < overlap.x + overlap.width; ++x)
+                        intersection += a[x] & b[x];
+                }
+                const size_t union_area = areas[i] + areas[j] - intersection;
+                matrix[i * num_masks + j] = union_area ? static_cast<float>(intersection) / static_cast<float>(union_area) : 0.f;
+            }
+        }
+    }
+    const double dense_iou_ms = elapsedMs(start, iterations);
+
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        maskIoUMatrix(masks, masks, matrix.data());
+    const double packed_iou_ms = elapsedMs(start, iterations);
+
+    std::cout << "IoU matrix, ms\n";
+    std::cout << "  dense box overlap   " << std::setw(10) << dense_iou_ms << "\n";
+    std::cout << "  BitMask popcount    " << std::setw(10) << packed_iou_ms << "\n";
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Throughput of the parallel MOT loader, the async writer and the binary detection log
+// against operator>> / operator<<.
+// Usage: mot_utils_bench [num_lines] [num_threads]
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <utils/detection_log_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_lines = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    const size_t num_threads = argc > 2 ? std::stoul(argv[2]) : 0;
+    const std::string path = "mot_utils_bench.txt";
+
+    cv::RNG rng(1);
+    {
+        std::ofstream file(path);
+        for (size_t i = 0; i < num_lines; ++i)
+        {
+            file << i / 50 + 1 << "," << i % 50 << "," << rng.uniform(0.f, 1920.f) << "," << rng.uniform(0.f, 1080.f) << ","
+                 << rng.uniform(10.f, 200.f) << "," << rng.uniform(10.f, 400.f) << "," << rng.uniform(0.f, 1.f)
+                 << ",-1,-1,-1\n";
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << num_lines << " lines\n";
+
+    auto start = Clock::now();
+    std::vector<Detection> detections;
+    {
+        std::ifstream file(path);
+        Detection det;
+        while (file >> det)
+            detections.push_back(det);
+    }
+    std::cout << "operator>>:      " << elapsedMs(start) << " ms\n";
+
+    for (size_t threads : {size_t{1}, num_threads})
+    {
+        DetectionBatch batch;
+        std::vector<MotParseError> errors;
+        start = Clock::now();
+        loadMot(path, batch, errors, threads);
+        std::cout << "loadMot threads=" << threads << ": " << elapsedMs(start) << " ms (" << batch.size() << " rows, "
+                  << errors.size() << " errors)\n";
+    }
+
+    start = Clock::now();
+    {
+        std::ofstream file(path);
+        for (const auto &det : detections)
+            file << det << "\n";
+    }
+    std::cout << "operator<<:      " << elapsedMs(start) << " ms\n";
+
+    const DetectionBatch batch = DetectionBatch::fromDetections(detections);
+    start = Clock::now();
+    {
+        MotWriter writer(path);
+        writer.write(batch);
+    }
+    std::cout << "MotWriter:       " << elapsedMs(start) << " ms\n";
+
+    const std::string log_path = "mot_utils_bench.bin";
+    {
+        DetectionLogWriter writer(log_path);
+        writer.write(batch);
+    }
+    start = Clock::now();
+    {
+        DetectionLogReader reader(log_path);
+        DetectionBatch loaded = reader.read(0, INT64_MAX);
+        std::cout << "DetectionLog:    " << elapsedMs(start) << " ms (" << loaded.size() << " rows, " << reader.size()
+                  << " frames)\n";
+    }
+
+    std::remove(log_path.c_str());
+    std::remove(path.c_str());
+    return 0;
+}
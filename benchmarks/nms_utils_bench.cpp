@@ -0,0 +1,136 @@
+// NMS on 8400 raw YOLO candidates: a hand-written O(N^2) loop over std::vector<Detection> with getIoU
+// against nms() with a reused workspace, in every mode and at each SIMD level for the greedy path.
+// Candidates cluster around a few objects and are mostly low-scored background, as a detection head produces them.
+// Usage: nms_utils_bench [candidates] [score_threshold] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/nms_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+// Class-aware greedy NMS as commonly written inline by consumers
+static std::vector<Detection> naiveNms(std::vector<Detection> detections, float iou_threshold, float score_threshold, size_t max_det)
+{
+    detections.erase(std::remove_if(detections.begin(), detections.end(), [score_threshold](const Detection &det)
+                                    { return det.confidence < score_threshold; }),
+                     detections.end());
+    std::sort(detections.begin(), detections.end(), [](const Detection &a, const Detection &b)
+              { return a.confidence > b.confidence; });
+
+    std::vector<bool> suppressed(detections.size(), false);
+    std::vector<Detection> result;
+    for (size_t i = 0; i < detections.size() && result.size() < max_det; ++i)
+    {
+        if (suppressed[i])
+            continue;
+        result.push_back(detections[i]);
+        for (size_t j = i + 1; j < detections.size(); ++j)
+        {
+            if (detections[j].class_id == detections[i].class_id && getIoU(detections[i].bbox, detections[j].bbox) > iou_threshold)
+                suppressed[j] = true;
+        }
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_candidates = argc > 1 ? std::stoul(argv[1]) : 8400;
+    const float score_threshold = argc > 2 ? std::stof(argv[2]) : 0.25f;
+    const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 100;
+
+    // As from a detection head: 60 objects with 20 confident, jittered candidates each over 10 classes,
+    // every other anchor is background with a low score. A score threshold of 0 keeps all of them.
+    cv::RNG rng(1);
+    std::vector<Detection> detections(num_candidates);
+    std::vector<cv::Rect2f> objects(60);
+    for (auto &box : objects)
+        box = cv::Rect2f(rng.uniform(0.f, 600.f), rng.uniform(0.f, 600.f), rng.uniform(10.f, 150.f), rng.uniform(10.f, 150.f));
+    for (size_t i = 0; i < num_candidates; ++i)
+    {
+        Detection &det = detections[i];
+        if (i % 7 == 0 && i / 7 < objects.size() * 20)
+        {
+            const size_t object = (i / 7) % objects.size();
+            const cv::Rect2f &box = objects[object];
+            det.bbox = cv::Rect2f(box.x + rng.uniform(-0.1f, 0.1f) * box.width, box.y + rng.uniform(-0.1f, 0.1f) * box.height,
+                                  box.width * rng.uniform(0.9f, 1.1f), box.height * rng.uniform(0.9f, 1.1f));
+            det.class_id = static_cast<int>(object % 10);
+            det.confidence = rng.uniform(0.3f, 0.95f);
+        }
+        else
+        {
+            det.bbox = cv::Rect2f(rng.uniform(0.f, 600.f), rng.uniform(0.f, 600.f), rng.uniform(10.f, 150.f), rng.uniform(10.f, 150.f));
+            det.class_id = rng.uniform(0, 10);
+            det.confidence = rng.uniform(0.f, 0.1f);
+        }
+    }
+    const DetectionBatch batch = DetectionBatch::fromDetections(detections);
+
+    NmsParams params;
+    params.score_threshold = score_threshold;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << num_candidates << " candidates, score threshold " << score_threshold << ", ms per image\n";
+
+    size_t naive_count = 0;
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        naive_count = naiveNms(detections, params.iou_threshold, params.score_threshold, params.max_det).size();
+    std::cout << "naive O(N^2) loop       " << std::setw(10) << elapsedMs(start, iterations) << "\n";
+
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+
+    const std::pair<simd::Level, const char *> levels[] = {
+        {simd::Level::Scalar, "scalar"}, {simd::Level::SSE4, "sse4"}, {simd::Level::AVX2, "avx2"}};
+    for (const auto &[level, name] : levels)
+    {
+        if (level > simd::detectLevel())
+            continue;
+        simd::setLevel(level);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            nms(batch, params, ws, keep, keep_scores);
+        std::cout << "greedy " << std::setw(6) << name << "           " << std::setw(10) << elapsedMs(start, iterations)
+                  << (keep.size() == naive_count ? "" : "  (count mismatch)") << "\n";
+    }
+    simd::setLevel(simd::detectLevel());
+
+    struct Mode
+    {
+        const char *name;
+        NmsMode mode;
+        NmsDecay decay;
+        bool class_agnostic;
+    };
+    const Mode modes[] = {
+        {"greedy class-agnostic", NmsMode::Greedy, NmsDecay::Linear, true},
+        {"batched", NmsMode::Batched, NmsDecay::Linear, false},
+        {"soft linear", NmsMode::Soft, NmsDecay::Linear, false},
+        {"soft gaussian", NmsMode::Soft, NmsDecay::Gaussian, false},
+        {"matrix gaussian", NmsMode::Matrix, NmsDecay::Gaussian, false}};
+    for (const Mode &mode : modes)
+    {
+        NmsParams mode_params = params;
+        mode_params.mode = mode.mode;
+        mode_params.decay = mode.decay;
+        mode_params.class_agnostic = mode.class_agnostic;
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            nms(batch, mode_params, ws, keep, keep_scores);
+        std::cout << std::left << std::setw(24) << mode.name << std::right << std::setw(11) << elapsedMs(start, iterations)
+                  << "  (" << keep.size() << " kept)\n";
+    }
+
+    return 0;
+}
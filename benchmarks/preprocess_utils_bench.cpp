@@ -0,0 +1,95 @@
+// Fused letterboxToTensor against letterbox() + cv::dnn::blobFromImage(), and BatchPreprocessor
+// throughput by thread count.
+// Usage: preprocess_utils_bench [input width] [input height] [model size] [iterations] [batch size]
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <utils/preprocess_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const int width = argc > 1 ? std::stoi(argv[1]) : 1920;
+    const int height = argc > 2 ? std::stoi(argv[2]) : 1080;
+    const int model_size = argc > 3 ? std::stoi(argv[3]) : 640;
+    const size_t iterations = argc > 4 ? std::stoul(argv[4]) : 100;
+    const size_t batch_size = argc > 5 ? std::stoul(argv[5]) : 16;
+
+    cv::RNG rng(1);
+    cv::Mat input(height, width, CV_8UC3);
+    for (int y = 0; y < height; ++y)
+    {
+        uchar *row = input.ptr<uchar>(y);
+        for (int x = 0; x < 3 * width; ++x)
+            row[x] = static_cast<uchar>(rng.uniform(0, 256));
+    }
+
+    LetterboxParams params;
+    params.new_shape = cv::Size(model_size, model_size);
+    TensorParams tensor_params;
+
+    auto start = Clock::now();
+    cv::Mat blob;
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        cv::Mat boxed = letterbox(input, params);
+        blob = cv::dnn::blobFromImage(boxed, tensor_params.scale, cv::Size(), cv::Scalar(), tensor_params.swap_rb, false);
+    }
+    const double baseline = elapsedMs(start, iterations);
+
+    std::vector<float> tensor(getTensorSize(input.size(), params));
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        letterboxToTensor(input, tensor.data(), params, tensor_params);
+    const double fused = elapsedMs(start, iterations);
+
+    std::vector<uint16_t> half(tensor.size());
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        letterboxToTensor(input, half.data(), params, tensor_params);
+    const double fused_half = elapsedMs(start, iterations);
+
+    float max_error = 0.f;
+    const float *expected = blob.ptr<float>();
+    for (size_t i = 0; i < tensor.size(); ++i)
+        max_error = std::max(max_error, std::abs(tensor[i] - expected[i]));
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << width << "x" << height << " -> " << model_size << "x" << model_size << ", ms per image\n";
+    std::cout << "letterbox + blobFromImage  " << std::setw(8) << baseline << "\n";
+    std::cout << "letterboxToTensor float    " << std::setw(8) << fused << "\n";
+    std::cout << "letterboxToTensor fp16     " << std::setw(8) << fused_half << "\n";
+    std::cout << std::setprecision(4) << "max abs difference         " << std::setw(8) << max_error << "\n";
+
+    std::vector<Frame> frames(batch_size, Frame(input));
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << std::setprecision(2) << "\nbatch of " << batch_size << ", ms per batch, speedup over 1 thread\n";
+    double single = 0.0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        BatchPreprocessParams batch_params;
+        batch_params.letterbox = params;
+        batch_params.tensor = tensor_params;
+        batch_params.num_threads = threads;
+        BatchPreprocessor preprocessor(batch_params);
+        std::vector<float> batch(preprocessor.tensorSize(batch_size));
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            preprocessor.process(frames, batch.data());
+        const double ms = elapsedMs(start, iterations);
+        if (threads == 1)
+            single = ms;
+        std::cout << std::setw(3) << threads << " threads " << std::setw(14) << ms << std::setw(8) << single / ms << "x\n";
+    }
+
+    return 0;
+}
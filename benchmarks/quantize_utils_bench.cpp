@@ -0,0 +1,127 @@
+// Accuracy and speed of fp16 / int8 feature storage against float cosineSimilarity,
+// scanning a gallery with one query at every SIMD level the CPU supports.
+// Usage: quantize_utils_bench [gallery size] [dim] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <utils/quantize_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedNs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+// Index of the best match and the error of every score against the float reference
+struct ScanResult
+{
+    size_t best{0};
+    float max_error{0.f};
+    double mean_error{0.0};
+};
+
+template <typename Features>
+static ScanResult scan(const std::vector<Features> &gallery, const Features &query, const std::vector<float> &reference)
+{
+    ScanResult result;
+    float best = -1.f;
+    for (size_t g = 0; g < gallery.size(); ++g)
+    {
+        const float similarity = cosineSimilarity(gallery[g], query);
+        if (similarity > best)
+        {
+            best = similarity;
+            result.best = g;
+        }
+        const float error = std::abs(similarity - reference[g]);
+        result.max_error = std::max(result.max_error, error);
+        result.mean_error += error / static_cast<double>(gallery.size());
+    }
+    return result;
+}
+
+template <typename Features>
+static double timeScan(const std::vector<Features> &gallery, const Features &query, size_t iterations)
+{
+    volatile float sink = 0.f;
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+    {
+        for (const auto &features : gallery)
+            sink = sink + cosineSimilarity(features, query);
+    }
+    return elapsedNs(start, iterations * gallery.size());
+}
+
+int main(int argc, char **argv)
+{
+    const size_t gallery_size = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const size_t dim = argc > 2 ? std::stoul(argv[2]) : 512;
+    const size_t iterations = argc > 3 ? std::stoul(argv[3]) : 20;
+
+    // ReID-like features: non-negative after ReLU, with a query close to one gallery entry
+    cv::RNG rng(1);
+    std::vector<std::vector<float>> gallery(gallery_size, std::vector<float>(dim));
+    for (auto &features : gallery)
+    {
+        for (float &value : features)
+            value = std::max(0.f, rng.uniform(-0.5f, 1.f));
+    }
+    std::vector<float> query = gallery[gallery_size / 2];
+    for (float &value : query)
+        value = std::max(0.f, value + rng.uniform(-0.3f, 0.3f));
+
+    std::vector<HalfFeatures> half_gallery;
+    std::vector<Int8Features> int8_gallery;
+    for (const auto &features : gallery)
+    {
+        half_gallery.push_back(quantizeHalf(features));
+        int8_gallery.push_back(quantizeInt8(features));
+    }
+    const HalfFeatures half_query = quantizeHalf(query);
+    const Int8Features int8_query = quantizeInt8(query);
+
+    std::vector<float> reference(gallery_size);
+    size_t reference_best = 0;
+    for (size_t g = 0; g < gallery_size; ++g)
+    {
+        reference[g] = cosineSimilarity(gallery[g], query);
+        if (reference[g] > reference[reference_best])
+            reference_best = g;
+    }
+
+    const ScanResult half_result = scan(half_gallery, half_query, reference);
+    const ScanResult int8_result = scan(int8_gallery, int8_query, reference);
+
+    std::cout << "gallery " << gallery_size << " x " << dim << "\n";
+    std::cout << "format  bytes/vector  max error  mean error  top-1\n";
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "float   " << std::setw(12) << dim * sizeof(float) << "          -           -  " << reference_best << "\n";
+    std::cout << "fp16    " << std::setw(12) << dim * sizeof(uint16_t) << std::setw(11) << half_result.max_error
+              << std::setw(12) << half_result.mean_error << "  " << half_result.best << "\n";
+    std::cout << "int8    " << std::setw(12) << dim * sizeof(int8_t) + sizeof(float) << std::setw(11) << int8_result.max_error
+              << std::setw(12) << int8_result.mean_error << "  " << int8_result.best << "\n\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "ns per cosine similarity\n";
+    std::cout << "level     float     fp16     int8\n";
+
+    const char *names[] = {"scalar", "sse4", "avx2", "avx512"};
+    for (auto level : {simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512})
+    {
+        if (level > simd::detectLevel())
+            break;
+        simd::setLevel(level);
+
+        const double float_ns = timeScan(gallery, query, iterations);
+        const double half_ns = timeScan(half_gallery, half_query, iterations);
+        const double int8_ns = timeScan(int8_gallery, int8_query, iterations);
+
+        std::cout << std::left << std::setw(7) << names[static_cast<int>(level)] << std::right << std::setw(9) << float_ns
+                  << std::setw(9) << half_ns << std::setw(9) << int8_ns << "\n";
+    }
+
+    return 0;
+}
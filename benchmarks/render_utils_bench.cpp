@@ -0,0 +1,55 @@
+// Time to annotate a 4K frame with OverlayRenderer, in place and into a reused output buffer.
+// Usage: render_utils_bench [detections] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <utils/render_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t num_detections = argc > 1 ? std::stoul(argv[1]) : 50;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    const cv::Size size(3840, 2160);
+    cv::Mat image(size, CV_8UC3, cv::Scalar(90, 120, 150));
+
+    cv::RNG rng(1);
+    std::vector<Detection> detections(num_detections);
+    for (size_t i = 0; i < num_detections; ++i)
+    {
+        Detection &det = detections[i];
+        det.bbox = cv::Rect2f(rng.uniform(0.f, 0.9f), rng.uniform(0.f, 0.9f), rng.uniform(0.02f, 0.1f), rng.uniform(0.05f, 0.1f));
+        det.class_id = static_cast<int>(i % 10);
+        det.class_name = "class_" + std::to_string(det.class_id);
+        det.track_id = static_cast<int64_t>(i);
+        det.confidence = rng.uniform(0.3f, 1.f);
+        if (i % 2 == 0)
+            det.mask = cv::Mat(28, 28, CV_32F, cv::Scalar(1.0));
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "4K frame, " << num_detections << " detections (half with masks), ms per frame\n";
+
+    OverlayRenderer renderer;
+    cv::Mat output;
+    auto start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        renderer.render(image, detections, output);
+    std::cout << "copy + render  " << std::setw(8) << elapsedMs(start, iterations) << "\n";
+
+    cv::Mat canvas = image.clone();
+    start = Clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        renderer.render(canvas, detections);
+    std::cout << "in place       " << std::setw(8) << elapsedMs(start, iterations) << "\n";
+
+    return 0;
+}
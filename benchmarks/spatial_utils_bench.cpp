@@ -0,0 +1,80 @@
+// Sparse box overlaps from 500 to 5000 small boxes on a 1080p frame: the dense getIoUMatrix followed
+// by a threshold scan against findOverlaps on the uniform grid, for two sets and within one set.
+// Usage: spatial_utils_bench [max_size] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utils/spatial_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t max_size = argc > 1 ? std::stoul(argv[1]) : 5000;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 20;
+    const float iou_threshold = 0.1f;
+
+    cv::RNG rng(1);
+    std::vector<float> matrix;
+    std::vector<BoxOverlap> overlaps;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "ms per call, IoU > " << iou_threshold << "\n";
+    std::cout << "      n  dense matrix  findOverlaps  dense self  findOverlaps self\n";
+    for (size_t n : {500, 1000, 2000, 5000})
+    {
+        if (n > max_size)
+            break;
+        std::vector<cv::Rect2f> boxes1(n), boxes2(n);
+        for (auto &box : boxes1)
+            box = cv::Rect2f(rng.uniform(0.f, 1880.f), rng.uniform(0.f, 1040.f), rng.uniform(8.f, 40.f), rng.uniform(8.f, 40.f));
+        for (auto &box : boxes2)
+            box = cv::Rect2f(rng.uniform(0.f, 1880.f), rng.uniform(0.f, 1040.f), rng.uniform(8.f, 40.f), rng.uniform(8.f, 40.f));
+
+        size_t dense_count = 0;
+        matrix.resize(n * n);
+        auto start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+        {
+            getIoUMatrix(boxes1, boxes2, matrix.data());
+            dense_count = 0;
+            for (float iou : matrix)
+                dense_count += iou > iou_threshold;
+        }
+        const double dense_ms = elapsedMs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            findOverlaps(boxes1, boxes2, iou_threshold, overlaps);
+        const double sparse_ms = elapsedMs(start, iterations);
+        const bool mismatch = overlaps.size() != dense_count;
+
+        size_t dense_self_count = 0;
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+        {
+            getIoUMatrix(boxes1, boxes1, matrix.data());
+            dense_self_count = 0;
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = i + 1; j < n; ++j)
+                    dense_self_count += matrix[i * n + j] > iou_threshold;
+        }
+        const double dense_self_ms = elapsedMs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            findOverlaps(boxes1, iou_threshold, overlaps);
+        const double sparse_self_ms = elapsedMs(start, iterations);
+
+        std::cout << std::setw(7) << n << std::setw(14) << dense_ms << std::setw(14) << sparse_ms
+                  << std::setw(12) << dense_self_ms << std::setw(19) << sparse_self_ms
+                  << (mismatch || overlaps.size() != dense_self_count ? "  (count mismatch)" : "") << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Throughput of the vector_ops float kernels at every SIMD level the CPU supports.
+// Usage: vector_utils_bench [size] [iterations]
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <utils/vector_utils.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedNs(Clock::time_point start, size_t iterations)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(iterations);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t size = argc > 1 ? std::stoul(argv[1]) : 1024;
+    const size_t iterations = argc > 2 ? std::stoul(argv[2]) : 20000;
+
+    cv::RNG rng(1);
+    std::vector<float> a(size), b(size), out(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        a[i] = rng.uniform(-10.f, 10.f);
+        b[i] = rng.uniform(-1.f, 1.f);
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "size " << size << ", ns per call\n";
+    std::cout << "level      dot      sum      exp  sigmoid  softmax\n";
+
+    const char *names[] = {"scalar", "sse4", "avx2", "avx512"};
+    for (auto level : {simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512})
+    {
+        if (level > simd::detectLevel())
+            break;
+        simd::setLevel(level);
+
+        volatile float sink = 0.f;
+        auto start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            sink = sink + vector_ops::dot(a.data(), b.data(), size);
+        const double dot = elapsedNs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            sink = sink + vector_ops::sum(a.data(), size);
+        const double sum = elapsedNs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            vector_ops::exp(a.data(), size, out.data());
+        const double exp = elapsedNs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            vector_ops::sigmoid(a.data(), size, out.data());
+        const double sigmoid = elapsedNs(start, iterations);
+
+        start = Clock::now();
+        for (size_t it = 0; it < iterations; ++it)
+            vector_ops::softmax(a.data(), size, out.data());
+        const double softmax = elapsedNs(start, iterations);
+
+        std::cout << std::left << std::setw(7) << names[static_cast<int>(level)] << std::right << std::setw(8) << dot
+                  << std::setw(9) << sum << std::setw(9) << exp << std::setw(9) << sigmoid << std::setw(9) << softmax << "\n";
+    }
+
+    return 0;
+}
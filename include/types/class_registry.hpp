@@ -0,0 +1,349 @@
+#pragma once
+
+#include <set>
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <memory_resource>
+#include <initializer_list>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace detail
+{
+    // Process-wide pool of class names, each stored once and never moved or freed
+    inline std::string_view internClassName(std::string_view name)
+    {
+        static std::mutex mutex;
+        static std::set<std::string, std::less<>> pool;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pool.find(name);
+        if (it == pool.end())
+            it = pool.emplace(name).first;
+        return *it;
+    }
+} // namespace detail
+
+// Interned class name: a string_view into a process-wide pool, so copies never allocate
+// and any string assigned to it (including temporaries) stays valid. Meant for the bounded
+// set of class and label names, every distinct name is kept until exit.
+class ClassName
+{
+public:
+    ClassName() = default;
+    ClassName(std::string_view name) : name_(name.empty() ? std::string_view() : detail::internClassName(name)) {}
+    ClassName(const std::string &name) : ClassName(std::string_view(name)) {}
+    ClassName(const char *name) : ClassName(std::string_view(name)) {}
+
+    std::string_view view() const { return name_; }
+    operator std::string_view() const { return name_; }
+    std::string str() const { return std::string(name_); }
+
+    bool empty() const { return name_.empty(); }
+    size_t size() const { return name_.size(); }
+    const char *data() const { return name_.data(); }
+
+    // Interned names are equal exactly when they share storage
+    friend bool operator==(const ClassName &a, const ClassName &b) { return a.name_.data() == b.name_.data(); }
+    friend bool operator!=(const ClassName &a, const ClassName &b) { return !(a == b); }
+    friend bool operator==(const ClassName &a, std::string_view b) { return a.name_ == b; }
+    friend bool operator!=(const ClassName &a, std::string_view b) { return a.name_ != b; }
+    friend bool operator==(const ClassName &a, const char *b) { return a.name_ == b; }
+    friend bool operator!=(const ClassName &a, const char *b) { return a.name_ != b; }
+    friend bool operator==(const ClassName &a, const std::string &b) { return a.name_ == b; }
+    friend bool operator!=(const ClassName &a, const std::string &b) { return a.name_ != b; }
+
+    friend std::ostream &operator<<(std::ostream &os, const ClassName &name) { return os << name.name_; }
+
+private:
+    std::string_view name_{};
+};
+
+// Class id to name table (e.g. the label file of a model). Lookups may run concurrently from
+// any thread, registration takes a writer lock.
+class ClassRegistry
+{
+public:
+    ClassRegistry() = default;
+
+    // Names for ids 0 .. names.size() - 1
+    explicit ClassRegistry(const std::vector<std::string> &names)
+    {
+        for (size_t id = 0; id < names.size(); ++id)
+            set(static_cast<int>(id), names[id]);
+    }
+
+    ClassRegistry(const ClassRegistry &other)
+    {
+        std::shared_lock<std::shared_mutex> lock(other.mutex_);
+        names_ = other.names_;
+        ids_ = other.ids_;
+    }
+
+    ClassRegistry &operator=(const ClassRegistry &other)
+    {
+        if (this != &other)
+        {
+            std::scoped_lock lock(mutex_, other.mutex_);
+            names_ = other.names_;
+            ids_ = other.ids_;
+        }
+        return *this;
+    }
+
+    // Name an id, replacing any previous name. Names may repeat (e.g. "N/A" placeholders in label
+    // files), id(name) then returns the lowest id.
+    void set(int id, ClassName name)
+    {
+        if (id < 0)
+            throw std::invalid_argument("Class ids must be non-negative");
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (static_cast<size_t>(id) >= names_.size())
+            names_.resize(static_cast<size_t>(id) + 1);
+        const ClassName old_name = names_[id];
+        names_[id] = name;
+
+        if (!old_name.empty() && old_name != name)
+        {
+            // Hand the old name over to the next id still using it
+            auto it = ids_.find(old_name.view());
+            if (it != ids_.end() && it->second == id)
+            {
+                ids_.erase(it);
+                for (size_t other = static_cast<size_t>(id) + 1; other < names_.size(); ++other)
+                {
+                    if (names_[other] == old_name)
+                    {
+                        ids_.emplace(old_name.view(), static_cast<int>(other));
+                        break;
+                    }
+                }
+            }
+        }
+        if (!name.empty())
+        {
+            auto [it, inserted] = ids_.emplace(name.view(), id);
+            if (!inserted && id < it->second)
+                it->second = id;
+        }
+    }
+
+    // Id of name, registering it after the highest id when it is new
+    int add(ClassName name)
+    {
+        if (name.empty())
+            throw std::invalid_argument("Class names must not be empty");
+
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = ids_.find(name.view());
+            if (it != ids_.end())
+                return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name.view());
+        if (it != ids_.end())
+            return it->second;
+        const int id = static_cast<int>(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name.view(), id);
+        return id;
+    }
+
+    // Empty when the id has no name
+    ClassName name(int id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return id >= 0 && static_cast<size_t>(id) < names_.size() ? names_[id] : ClassName();
+    }
+
+    // -1 when the name is not registered
+    int id(std::string_view name) const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        return it == ids_.end() ? -1 : it->second;
+    }
+
+    // One past the highest registered id
+    size_t size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return names_.size();
+    }
+
+    void clear()
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        names_.clear();
+        ids_.clear();
+    }
+
+    // Default registry used to name detections that only carry a class id
+    static ClassRegistry &global()
+    {
+        static ClassRegistry registry;
+        return registry;
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::vector<ClassName> names_{};
+    std::unordered_map<std::string_view, int> ids_{};
+};
+
+// Multi-label results as (class id, name) pairs sorted by id. Up to four labels live inline in
+// the object, so copying a detection does not allocate or chase nodes for the common case.
+// Larger sets spill to a std::pmr vector, e.g. in the arena of the frame they belong to.
+class LabelSet
+{
+public:
+    using value_type = std::pair<int, ClassName>;
+    using const_iterator = const value_type *;
+    using iterator = value_type *;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    static constexpr size_t INLINE_CAPACITY = 4;
+
+    LabelSet() = default;
+
+    explicit LabelSet(const allocator_type &alloc) : heap_(alloc) {}
+
+    LabelSet(std::initializer_list<value_type> labels)
+    {
+        for (const auto &label : labels)
+            (*this)[label.first] = label.second;
+    }
+
+    LabelSet(const LabelSet &other) = default;
+
+    LabelSet(const LabelSet &other, const allocator_type &alloc)
+        : inline_(other.inline_), heap_(other.heap_, alloc), size_(other.size_) {}
+
+    LabelSet(LabelSet &&other) noexcept
+        : inline_(other.inline_), heap_(std::move(other.heap_)), size_(std::exchange(other.size_, 0))
+    {
+        other.heap_.clear();
+    }
+
+    LabelSet(LabelSet &&other, const allocator_type &alloc)
+        : inline_(other.inline_), heap_(std::move(other.heap_), alloc), size_(std::exchange(other.size_, 0))
+    {
+        other.heap_.clear();
+    }
+
+    LabelSet &operator=(const LabelSet &other) = default;
+
+    // Keeps this set's allocator, as std::pmr containers do
+    LabelSet &operator=(LabelSet &&other)
+    {
+        if (this != &other)
+        {
+            inline_ = other.inline_;
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+            other.heap_.clear();
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const { return heap_.get_allocator(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+
+    const_iterator find(int id) const
+    {
+        const_iterator it = lowerBound(id);
+        return it != end() && it->first == id ? it : end();
+    }
+
+    size_t count(int id) const { return find(id) != end() ? 1 : 0; }
+
+    // Name of id, inserting an empty name when missing
+    ClassName &operator[](int id)
+    {
+        iterator it = const_cast<iterator>(lowerBound(id));
+        if (it != end() && it->first == id)
+            return it->second;
+        return insert(static_cast<size_t>(it - begin()), value_type(id, ClassName()))->second;
+    }
+
+    // Insert unless id is present, returns whether it was inserted
+    bool emplace(int id, ClassName name)
+    {
+        const_iterator it = lowerBound(id);
+        if (it != end() && it->first == id)
+            return false;
+        insert(static_cast<size_t>(it - begin()), value_type(id, name));
+        return true;
+    }
+
+    size_t erase(int id)
+    {
+        const_iterator it = find(id);
+        if (it == end())
+            return 0;
+        std::move(const_cast<iterator>(it) + 1, end(), const_cast<iterator>(it));
+        --size_;
+        if (!heap_.empty())
+            heap_.pop_back();
+        return 1;
+    }
+
+    void clear()
+    {
+        size_ = 0;
+        heap_.clear();
+    }
+
+    friend bool operator==(const LabelSet &a, const LabelSet &b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend bool operator!=(const LabelSet &a, const LabelSet &b) { return !(a == b); }
+
+private:
+    const value_type *data() const { return heap_.empty() ? inline_.data() : heap_.data(); }
+    value_type *data() { return heap_.empty() ? inline_.data() : heap_.data(); }
+
+    const_iterator lowerBound(int id) const
+    {
+        return std::lower_bound(begin(), end(), id, [](const value_type &label, int key)
+                                { return label.first < key; });
+    }
+
+    iterator insert(size_t index, const value_type &label)
+    {
+        if (heap_.empty() && size_ < INLINE_CAPACITY)
+        {
+            std::move_backward(inline_.begin() + index, inline_.begin() + size_, inline_.begin() + size_ + 1);
+            inline_[index] = label;
+            ++size_;
+            return inline_.data() + index;
+        }
+        if (heap_.empty())
+            heap_.assign(inline_.begin(), inline_.begin() + size_);
+        heap_.insert(heap_.begin() + index, label);
+        ++size_;
+        return heap_.data() + index;
+    }
+
+    std::array<value_type, INLINE_CAPACITY> inline_{};
+    std::pmr::vector<value_type> heap_{}; // all labels once there are more than INLINE_CAPACITY
+    size_t size_{0};
+};
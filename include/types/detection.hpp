@@ -1,16 +1,24 @@
 #pragma once
 
-#include <map>
+#include <array>
 #include <vector>
 #include <iostream>
+#include <memory_resource>
 #include <opencv2/opencv.hpp>
 
+#include <types/class_registry.hpp>
+#include <utils/parse_utils.hpp>
+
+// Allocator-aware: in a std::pmr container (e.g. std::pmr::vector<Detection> on a FrameArena)
+// features and spilled labels are allocated from the container's memory resource.
 struct Detection
 {
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
     int class_id{-1};
     float confidence{0.f};
     cv::Rect2f bbox{};
-    std::string class_name{};
+    ClassName class_name{}; // optional, getClassName() falls back to the registry
     cv::Mat mask{};
 
     // MOT specific
@@ -19,65 +27,86 @@ struct Detection
     cv::Point3f position{0.0f, 0.0f, 0.0f};
 
     // Reid specific
-    std::vector<float> features{};
+    std::pmr::vector<float> features{};
 
     // Multi-label classification
-    std::map<int, std::string> labels{};
+    LabelSet labels{};
 
     // Display
     cv::Size size{}; // set for absolute bbox
 
-    cv::Scalar getClassColor() const
+    Detection() = default;
+
+    explicit Detection(const allocator_type &alloc) : features(alloc), labels(alloc) {}
+
+    Detection(const Detection &other) = default;
+    Detection(Detection &&other) = default;
+
+    Detection(const Detection &other, const allocator_type &alloc) : Detection(alloc) { *this = other; }
+    Detection(Detection &&other, const allocator_type &alloc) : Detection(alloc) { *this = std::move(other); }
+
+    // Assignment keeps this detection's allocator
+    Detection &operator=(const Detection &other) = default;
+    Detection &operator=(Detection &&other) = default;
+
+    allocator_type get_allocator() const { return features.get_allocator(); }
+
+    // class_name when set, otherwise the registry name of class_id (empty if unknown)
+    ClassName getClassName(const ClassRegistry &registry = ClassRegistry::global()) const
+    {
+        return class_name.empty() ? registry.name(class_id) : class_name;
+    }
+
+    const cv::Scalar &getClassColor() const
     {
         return getColorById(class_id);
     }
 
-    cv::Scalar getTrackColor() const
+    const cv::Scalar &getTrackColor() const
     {
         return getColorById(track_id);
     }
 
-    static cv::Scalar getColorById(int id)
+    // Lookup in a fixed 256-color palette, the same id always maps to the same color
+    static const cv::Scalar &getColorById(int64_t id)
     {
-        srand(id);
-        return cv::Scalar(rand() % 256, rand() % 256, rand() % 256);
+        static const std::array<cv::Scalar, 256> palette = []()
+        {
+            std::array<cv::Scalar, 256> colors;
+            uint64_t state = 0;
+            for (auto &color : colors)
+            {
+                // splitmix64
+                uint64_t bits = (state += 0x9e3779b97f4a7c15ull);
+                bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ull;
+                bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebull;
+                bits ^= bits >> 31;
+                color = cv::Scalar(bits & 0xff, (bits >> 8) & 0xff, (bits >> 16) & 0xff);
+            }
+            return colors;
+        }();
+        return palette[static_cast<uint64_t>(id) % palette.size()];
     }
 
-    // For MOT file I/O
+    // For MOT file I/O, reads one line and sets failbit if it is malformed
     friend std::istream &operator>>(std::istream &is, Detection &detection)
     {
-        std::string field;
-
-        std::getline(is, field, ',');
-        detection.frame_id = std::stoi(field);
-
-        std::getline(is, field, ',');
-        detection.track_id = std::stoi(field);
-
-        std::getline(is, field, ',');
-        detection.bbox.x = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.bbox.y = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.bbox.width = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.bbox.height = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.confidence = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.position.x = std::stof(field);
-
-        std::getline(is, field, ',');
-        detection.position.y = std::stof(field);
-
-        std::getline(is, field);
-        detection.position.z = std::stof(field);
-
+        thread_local std::string line;
+        if (!std::getline(is, line))
+            return is;
+
+        MotRecord record;
+        if (!parseMotRecord(line.data(), line.data() + line.size(), record))
+        {
+            is.setstate(std::ios::failbit);
+            return is;
+        }
+
+        detection.frame_id = record.frame_id;
+        detection.track_id = record.track_id;
+        detection.bbox = cv::Rect2f(record.x, record.y, record.width, record.height);
+        detection.confidence = record.confidence;
+        detection.position = cv::Point3f(record.pos_x, record.pos_y, record.pos_z);
         detection.size = cv::Size(detection.bbox.width, detection.bbox.height);
 
         return is;
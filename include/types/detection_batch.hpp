@@ -0,0 +1,254 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <stdexcept>
+#include <memory_resource>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection.hpp>
+
+// Columnar (structure-of-arrays) storage for many detections.
+// Row i of every column describes the same detection.
+// Columns are std::pmr containers, construct the batch with a FrameArena allocator to keep
+// per-frame results off the global heap.
+struct DetectionBatch
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::vector<cv::Rect2f> bboxes{};
+    std::pmr::vector<float> confidences{};
+    std::pmr::vector<int> class_ids{};
+
+    // MOT specific
+    std::pmr::vector<int64_t> frame_ids{};
+    std::pmr::vector<int64_t> track_ids{};
+    std::pmr::vector<cv::Point3f> positions{};
+
+    // Display
+    std::pmr::vector<cv::Size> sizes{};
+
+    // Reid specific: row-major [size() x feature_dim], rows without features are zero-filled
+    size_t feature_dim{0};
+    std::pmr::vector<float> features{};
+
+    // Optional mask pool: mask_ids[i] indexes masks, or is -1 when row i has no mask
+    std::pmr::vector<int> mask_ids{};
+    std::pmr::vector<cv::Mat> masks{};
+
+    // Class names are shared by every row with the same class_id
+    std::pmr::map<int, ClassName> class_names{};
+
+    DetectionBatch() = default;
+
+    explicit DetectionBatch(const allocator_type &alloc)
+        : bboxes(alloc), confidences(alloc), class_ids(alloc), frame_ids(alloc), track_ids(alloc), positions(alloc),
+          sizes(alloc), features(alloc), mask_ids(alloc), masks(alloc), class_names(alloc) {}
+
+    DetectionBatch(const DetectionBatch &other) = default;
+    DetectionBatch(DetectionBatch &&other) = default;
+
+    DetectionBatch(const DetectionBatch &other, const allocator_type &alloc) : DetectionBatch(alloc) { *this = other; }
+    DetectionBatch(DetectionBatch &&other, const allocator_type &alloc) : DetectionBatch(alloc) { *this = std::move(other); }
+
+    // Assignment keeps this batch's allocator
+    DetectionBatch &operator=(const DetectionBatch &other) = default;
+    DetectionBatch &operator=(DetectionBatch &&other) = default;
+
+    allocator_type get_allocator() const { return bboxes.get_allocator(); }
+
+    size_t size() const { return bboxes.size(); }
+    bool empty() const { return bboxes.empty(); }
+
+    void reserve(size_t n)
+    {
+        bboxes.reserve(n);
+        confidences.reserve(n);
+        class_ids.reserve(n);
+        frame_ids.reserve(n);
+        track_ids.reserve(n);
+        positions.reserve(n);
+        sizes.reserve(n);
+        mask_ids.reserve(n);
+        features.reserve(n * feature_dim);
+    }
+
+    // Drop all rows but keep the allocated capacity for the next frame
+    void clear()
+    {
+        bboxes.clear();
+        confidences.clear();
+        class_ids.clear();
+        frame_ids.clear();
+        track_ids.clear();
+        positions.clear();
+        sizes.clear();
+        features.clear();
+        mask_ids.clear();
+        masks.clear();
+    }
+
+    const float *feature(size_t i) const { return features.data() + i * feature_dim; }
+    float *feature(size_t i) { return features.data() + i * feature_dim; }
+
+    const cv::Mat &mask(size_t i) const
+    {
+        static const cv::Mat no_mask;
+        return mask_ids[i] < 0 ? no_mask : masks[mask_ids[i]];
+    }
+
+    void push_back(const Detection &det)
+    {
+        if (!det.features.empty())
+        {
+            if (feature_dim == 0)
+            {
+                feature_dim = det.features.size();
+                features.assign(size() * feature_dim, 0.f);
+            }
+            else if (det.features.size() != feature_dim)
+            {
+                throw std::invalid_argument("Feature size does not match batch feature dimension");
+            }
+        }
+
+        bboxes.push_back(det.bbox);
+        confidences.push_back(det.confidence);
+        class_ids.push_back(det.class_id);
+        frame_ids.push_back(det.frame_id);
+        track_ids.push_back(det.track_id);
+        positions.push_back(det.position);
+        sizes.push_back(det.size);
+
+        if (det.features.empty())
+            features.resize(features.size() + feature_dim, 0.f);
+        else
+            features.insert(features.end(), det.features.begin(), det.features.end());
+
+        if (det.mask.empty())
+        {
+            mask_ids.push_back(-1);
+        }
+        else
+        {
+            mask_ids.push_back(static_cast<int>(masks.size()));
+            masks.push_back(det.mask);
+        }
+
+        if (!det.class_name.empty())
+            class_names.emplace(det.class_id, det.class_name);
+    }
+
+    // Append a plain row (no track, features, mask or name) without building a Detection
+    void emplace_back(const cv::Rect2f &bbox, float confidence, int class_id, int64_t frame_id = -1, cv::Size size = {})
+    {
+        bboxes.push_back(bbox);
+        confidences.push_back(confidence);
+        class_ids.push_back(class_id);
+        frame_ids.push_back(frame_id);
+        track_ids.push_back(-1);
+        positions.emplace_back(0.f, 0.f, 0.f);
+        sizes.push_back(size);
+        features.resize(features.size() + feature_dim, 0.f);
+        mask_ids.push_back(-1);
+    }
+
+    void append(const DetectionBatch &other)
+    {
+        if (other.empty())
+            return;
+
+        if (feature_dim == 0 && other.feature_dim != 0)
+        {
+            feature_dim = other.feature_dim;
+            features.assign(size() * feature_dim, 0.f);
+        }
+        else if (other.feature_dim == 0)
+        {
+            features.resize(features.size() + other.size() * feature_dim, 0.f);
+        }
+        else if (other.feature_dim != feature_dim)
+        {
+            throw std::invalid_argument("Feature size does not match batch feature dimension");
+        }
+
+        if (other.feature_dim != 0)
+            features.insert(features.end(), other.features.begin(), other.features.end());
+
+        bboxes.insert(bboxes.end(), other.bboxes.begin(), other.bboxes.end());
+        confidences.insert(confidences.end(), other.confidences.begin(), other.confidences.end());
+        class_ids.insert(class_ids.end(), other.class_ids.begin(), other.class_ids.end());
+        frame_ids.insert(frame_ids.end(), other.frame_ids.begin(), other.frame_ids.end());
+        track_ids.insert(track_ids.end(), other.track_ids.begin(), other.track_ids.end());
+        positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+        sizes.insert(sizes.end(), other.sizes.begin(), other.sizes.end());
+
+        const int mask_offset = static_cast<int>(masks.size());
+        for (int id : other.mask_ids)
+            mask_ids.push_back(id < 0 ? -1 : id + mask_offset);
+        masks.insert(masks.end(), other.masks.begin(), other.masks.end());
+
+        class_names.insert(other.class_names.begin(), other.class_names.end());
+    }
+
+    // Materialize row i as a standalone Detection
+    Detection operator[](size_t i) const
+    {
+        Detection det;
+        copyRow(i, det);
+        return det;
+    }
+
+    // Overwrite det with row i, reusing its feature storage and allocator
+    void copyRow(size_t i, Detection &det) const
+    {
+        det.class_id = class_ids[i];
+        det.confidence = confidences[i];
+        det.bbox = bboxes[i];
+        det.frame_id = frame_ids[i];
+        det.track_id = track_ids[i];
+        det.position = positions[i];
+        det.size = sizes[i];
+        det.mask = mask(i);
+        det.labels.clear();
+
+        if (feature_dim != 0)
+            det.features.assign(feature(i), feature(i) + feature_dim);
+        else
+            det.features.clear();
+
+        auto it = class_names.find(det.class_id);
+        det.class_name = it != class_names.end() ? it->second : ClassName();
+    }
+
+    // Multi-label results are not carried by the batch
+    template <typename Alloc>
+    static DetectionBatch fromDetections(const std::vector<Detection, Alloc> &detections, const allocator_type &alloc = {})
+    {
+        DetectionBatch batch(alloc);
+        batch.reserve(detections.size());
+        for (const auto &det : detections)
+        {
+            batch.push_back(det);
+        }
+        return batch;
+    }
+
+    std::vector<Detection> toDetections() const
+    {
+        std::vector<Detection> detections;
+        toDetections(detections);
+        return detections;
+    }
+
+    // Fill detections in place, for a std::pmr::vector rows are allocated from its resource
+    template <typename Alloc>
+    void toDetections(std::vector<Detection, Alloc> &detections) const
+    {
+        detections.resize(size());
+        for (size_t i = 0; i < size(); ++i)
+        {
+            copyRow(i, detections[i]);
+        }
+    }
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include <utils/simd_utils.hpp>
+#include <utils/vector_utils.hpp>
+#include <utils/geometry_utils.hpp>
+
+namespace detail
+{
+#ifdef VISION_CORE_X86_SIMD
+
+    VISION_CORE_AVX512_WARNINGS_PUSH
+
+    // Fixed-size kernels: N is a compile-time constant, so the loops are fully unrolled
+    // and every load is aligned (Embedding storage is 64-byte aligned)
+
+    template <size_t N>
+    VISION_CORE_TARGET("avx512f") inline float embeddingDotAvx512(const float *a, const float *b)
+    {
+        __m512 acc[4] = {_mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps()};
+        _Pragma("GCC unroll 32")
+        for (size_t i = 0; i < N / 16; ++i)
+            acc[i % 4] = _mm512_fmadd_ps(_mm512_load_ps(a + 16 * i), _mm512_load_ps(b + 16 * i), acc[i % 4]);
+        return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc[0], acc[1]), _mm512_add_ps(acc[2], acc[3])));
+    }
+
+    VISION_CORE_AVX512_WARNINGS_POP
+
+    template <size_t N>
+    VISION_CORE_TARGET("avx2,fma") inline float embeddingDotAvx2(const float *a, const float *b)
+    {
+        __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+        _Pragma("GCC unroll 64")
+        for (size_t i = 0; i < N / 8; ++i)
+            acc[i % 4] = _mm256_fmadd_ps(_mm256_load_ps(a + 8 * i), _mm256_load_ps(b + 8 * i), acc[i % 4]);
+        return simd::hsum(_mm256_add_ps(_mm256_add_ps(acc[0], acc[1]), _mm256_add_ps(acc[2], acc[3])));
+    }
+
+    template <size_t N>
+    VISION_CORE_TARGET("sse4.1") inline float embeddingDotSse4(const float *a, const float *b)
+    {
+        __m128 acc[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+        _Pragma("GCC unroll 64")
+        for (size_t i = 0; i < N / 4; ++i)
+            acc[i % 4] = _mm_add_ps(acc[i % 4], _mm_mul_ps(_mm_load_ps(a + 4 * i), _mm_load_ps(b + 4 * i)));
+        return simd::hsum(_mm_add_ps(_mm_add_ps(acc[0], acc[1]), _mm_add_ps(acc[2], acc[3])));
+    }
+
+#endif
+
+    // Eight partial sums break the dependency chain so the compiler can vectorize for the baseline ISA
+    template <size_t N>
+    inline float embeddingDotScalar(const float *a, const float *b)
+    {
+        float acc[8] = {};
+        for (size_t i = 0; i < N / 8 * 8; i += 8)
+        {
+            VISION_CORE_UNROLL
+            for (size_t k = 0; k < 8; ++k)
+                acc[k] += a[i + k] * b[i + k];
+        }
+        if constexpr (N % 8 != 0)
+        {
+            for (size_t i = N / 8 * 8; i < N; ++i)
+                acc[0] += a[i] * b[i];
+        }
+        return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    }
+
+    template <size_t N>
+    inline float embeddingDot(const float *a, const float *b)
+    {
+#ifdef VISION_CORE_X86_SIMD
+        const simd::Level level = simd::level();
+        if constexpr (N % 16 == 0)
+        {
+            if (level == simd::Level::AVX512)
+                return embeddingDotAvx512<N>(a, b);
+        }
+        if constexpr (N % 8 == 0)
+        {
+            if (level >= simd::Level::AVX2)
+                return embeddingDotAvx2<N>(a, b);
+        }
+        if constexpr (N % 4 == 0)
+        {
+            if (level >= simd::Level::SSE4)
+                return embeddingDotSse4<N>(a, b);
+        }
+#endif
+        return embeddingDotScalar<N>(a, b);
+    }
+} // namespace detail
+
+// Fixed-dimension ReID embedding stored inline, e.g. Embedding<128>, Embedding<256> or Embedding<512>.
+// Unlike Detection::features it needs no heap allocation and its kernels need no size checks.
+template <size_t N>
+struct Embedding
+{
+    static_assert(N > 0, "Embedding dimension must be positive");
+
+    alignas(64) std::array<float, N> values{};
+
+    Embedding() = default;
+
+    explicit Embedding(const float *features)
+    {
+        std::copy(features, features + N, values.begin());
+    }
+
+    template <typename Alloc = std::allocator<float>>
+    explicit Embedding(const std::vector<float, Alloc> &features)
+    {
+        if (features.size() != N)
+        {
+            throw std::invalid_argument("Feature size does not match embedding dimension");
+        }
+        std::copy(features.begin(), features.end(), values.begin());
+    }
+
+    static constexpr size_t size() { return N; }
+
+    float *data() { return values.data(); }
+    const float *data() const { return values.data(); }
+
+    float &operator[](size_t i) { return values[i]; }
+    const float &operator[](size_t i) const { return values[i]; }
+
+    auto begin() { return values.begin(); }
+    auto end() { return values.end(); }
+    auto begin() const { return values.begin(); }
+    auto end() const { return values.end(); }
+
+    std::vector<float> toVector() const
+    {
+        return std::vector<float>(values.begin(), values.end());
+    }
+
+    float dot(const Embedding &other) const
+    {
+        return detail::embeddingDot<N>(data(), other.data());
+    }
+
+    float norm() const
+    {
+        return std::sqrt(dot(*this));
+    }
+
+    // Scale to unit L2 norm, a zero embedding is left untouched
+    void normalize()
+    {
+        const float n = norm();
+        if (n < EPSILON)
+            return;
+
+        const float inv_norm = 1.f / n;
+        for (float &value : values)
+            value *= inv_norm;
+    }
+
+    bool operator==(const Embedding &other) const { return values == other.values; }
+    bool operator!=(const Embedding &other) const { return values != other.values; }
+};
+
+namespace vector_ops
+{
+
+    template <size_t N>
+    inline float dot(const Embedding<N> &a, const Embedding<N> &b)
+    {
+        return a.dot(b);
+    }
+
+    template <size_t N>
+    inline Embedding<N> normalize(const Embedding<N> &embedding)
+    {
+        Embedding<N> result = embedding;
+        result.normalize();
+        return result;
+    }
+
+    // Weighted average alpha * a + (1 - alpha) * b, e.g. for an exponential moving average of track features
+    template <size_t N>
+    inline Embedding<N> compose(const Embedding<N> &a, const Embedding<N> &b, float alpha)
+    {
+        Embedding<N> result;
+        compose(a.data(), b.data(), N, alpha, result.data());
+        return result;
+    }
+
+} // namespace vector_ops
+
+// Same convention as cosineSimilarity(const float *, const float *, size_t): (1 + cos) / 2, 0 for zero vectors
+template <size_t N>
+inline float cosineSimilarity(const Embedding<N> &a, const Embedding<N> &b)
+{
+    const float norms = std::sqrt(a.dot(a) * b.dot(b));
+    if (norms < EPSILON * EPSILON)
+    {
+        return 0.f;
+    }
+    return (1.f + a.dot(b) / norms) / 2.f;
+}
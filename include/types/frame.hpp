@@ -1,27 +1,71 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <chrono>
 #include <opencv2/opencv.hpp>
 
 #include <types/detection.hpp>
+#include <types/frame_arena.hpp>
 #include <utils/detection_utils.hpp>
+#include <utils/render_utils.hpp>
 
 using TimePoint = std::chrono::system_clock::time_point;
+using SteadyTimePoint = std::chrono::steady_clock::time_point;
+
+// Frame numbering for one video stream, e.g. one camera. Each capture thread owns its stream,
+// ids are a relaxed atomic increment and the counter sits on its own cache line.
+class FrameStream
+{
+public:
+    // Streams are numbered automatically from 1, 0 is the default stream of Frame::frame_counter
+    FrameStream() : id_(nextStreamId()) {}
+
+    explicit FrameStream(int64_t stream_id) : id_(stream_id) {}
+
+    FrameStream(const FrameStream &) = delete;
+    FrameStream &operator=(const FrameStream &) = delete;
+
+    int64_t id() const { return id_; }
+
+    int64_t nextFrameId() { return next_frame_id_.fetch_add(1, std::memory_order_relaxed); }
+
+    void reset(int64_t next_frame_id = 0) { next_frame_id_.store(next_frame_id, std::memory_order_relaxed); }
+
+private:
+    static int64_t nextStreamId()
+    {
+        static std::atomic<int64_t> next_stream_id{1};
+        return next_stream_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int64_t id_;
+    alignas(64) std::atomic<int64_t> next_frame_id_{0};
+};
 
 struct Frame
 {
     cv::Mat image;
     cv::Size size;
-    TimePoint timestamp;
+    TimePoint timestamp;          // wall clock, for display and logs
+    SteadyTimePoint capture_time; // monotonic, for latency and frame intervals
     int64_t id;
+    int64_t stream_id{0};
+    std::shared_ptr<FrameArena> arena{}; // optional, from a FrameArenaPool and shared by all copies
 
-    static int64_t frame_counter;
+    // Ids of frames built without a FrameStream, shared by all threads
+    inline static std::atomic<int64_t> frame_counter{0};
 
-    Frame() : image(), size(0, 0), timestamp(std::chrono::system_clock::now()), id(frame_counter++) {}
+    Frame() : image(), size(0, 0), timestamp(std::chrono::system_clock::now()),
+              capture_time(std::chrono::steady_clock::now()), id(nextFrameId()) {}
 
     Frame(const cv::Mat &img, TimePoint ts = std::chrono::system_clock::now())
-        : image(img), size(img.size()), timestamp(ts), id(frame_counter++) {}
+        : image(img), size(img.size()), timestamp(ts), capture_time(std::chrono::steady_clock::now()), id(nextFrameId()) {}
+
+    Frame(const cv::Mat &img, FrameStream &stream, TimePoint ts = std::chrono::system_clock::now(),
+          SteadyTimePoint capture = std::chrono::steady_clock::now())
+        : image(img), size(img.size()), timestamp(ts), capture_time(capture), id(stream.nextFrameId()), stream_id(stream.id()) {}
 
     friend Frame &operator>>(cv::VideoCapture &cap, Frame &frame)
     {
@@ -32,11 +76,15 @@ struct Frame
             frame.image = img;
             frame.size = img.size();
             frame.timestamp = std::chrono::system_clock::now();
-            frame.id = frame_counter++;
+            frame.capture_time = std::chrono::steady_clock::now();
+            frame.id = nextFrameId();
+            frame.stream_id = 0;
         }
         return frame;
     }
 
+    static int64_t nextFrameId() { return frame_counter.fetch_add(1, std::memory_order_relaxed); }
+
     cv::Mat operator()(const cv::Rect &rect) const
     {
         cv::Rect safe_rect = rect & cv::Rect(0, 0, width(), height());
@@ -65,68 +113,31 @@ struct Frame
 
     int64_t getId() const { return id; }
 
-    cv::Mat draw(const std::vector<Detection> &detections, bool use_track_colors = false, bool draw_labels = true) const
-    {
-        cv::Mat output = image.clone();
-        cv::Mat mask_overlay = cv::Mat::zeros(size, CV_8UC3);
+    int64_t getStreamId() const { return stream_id; }
 
-        for (const auto &det : detections)
-        {
-            // Get appropriate color based on user preference
-            cv::Scalar color = use_track_colors ? det.getTrackColor() : det.getClassColor();
-
-            // Convert relative coordinates to absolute
-            cv::Rect abs_bbox = det.size.empty() ? getAbsoluteBbox(det.bbox, size) : cv::Rect(det.bbox);
-            cv::Mat abs_mask = getAbsoluteMask(det.mask, abs_bbox.size());
-
-            // Draw mask if available
-            if (!det.mask.empty())
-            {
-                cv::Mat color_mask(abs_bbox.size(), CV_8UC3, color);
-                cv::Mat roi_mask = mask_overlay(abs_bbox);
-                color_mask.copyTo(roi_mask, abs_mask);
-            }
-
-            // Draw bounding box
-            cv::rectangle(output, abs_bbox, color, 2);
-
-            // Draw label if requested
-            if (draw_labels)
-            {
-                // Construct label text
-                std::string label = det.class_name;
-                if (det.track_id >= 0)
-                {
-                    label += " [" + std::to_string(det.track_id) + "]";
-                }
-                if (det.confidence > 0)
-                {
-                    label += " " + std::to_string(static_cast<int>(det.confidence * 100)) + "%";
-                }
-
-                // Draw text with background
-                int baseline = 0;
-                cv::Size text_size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, 0.5, 2, &baseline);
-                cv::Point text_origin(abs_bbox.x, abs_bbox.y - 5);
-
-                cv::rectangle(output,
-                              cv::Point(text_origin.x, text_origin.y - text_size.height),
-                              cv::Point(text_origin.x + text_size.width, text_origin.y + baseline),
-                              color, -1);
-
-                cv::putText(output, label, text_origin,
-                            cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 0), 2);
-            }
-        }
+    SteadyTimePoint getCaptureTime() const { return capture_time; }
 
-        // Apply the final mask overlay
-        if (!mask_overlay.empty())
-        {
-            cv::addWeighted(output, 0.9, mask_overlay, 0.3, 0, output);
-        }
+    // Memory for this frame's detections and temporaries: the arena when attached, else the default resource
+    std::pmr::memory_resource *resource() const
+    {
+        return arena ? arena->resource() : std::pmr::get_default_resource();
+    }
 
+    // Annotated copy of the image. For video, keep an OverlayRenderer and use the overload below.
+    cv::Mat draw(const std::vector<Detection> &detections, bool use_track_colors = false, bool draw_labels = true) const
+    {
+        OverlayParams params;
+        params.use_track_colors = use_track_colors;
+        params.draw_labels = draw_labels;
+
+        cv::Mat output;
+        OverlayRenderer(params).render(image, detections, output);
         return output;
     }
-};
 
-int64_t Frame::frame_counter = 0;
\ No newline at end of file
+    // Annotate into output, reusing its buffer and the renderer's label cache across frames
+    void draw(const std::vector<Detection> &detections, OverlayRenderer &renderer, cv::Mat &output) const
+    {
+        renderer.render(image, detections, output);
+    }
+};
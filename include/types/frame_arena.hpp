@@ -0,0 +1,145 @@
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <memory_resource>
+
+namespace detail
+{
+    // Upstream of a FrameArena: counts what spills past the arena's own buffer into the heap
+    class ArenaUpstream : public std::pmr::memory_resource
+    {
+    public:
+        size_t bytes() const { return bytes_; }
+        void clear() { bytes_ = 0; }
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            bytes_ += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        size_t bytes_{0};
+    };
+} // namespace detail
+
+// Monotonic memory for the short-lived containers of one frame (detections, features, labels,
+// vector_ops results). Deallocation is a no-op, reset() frees everything at once. A frame that
+// outgrows the buffer spills to the heap, and the next reset() grows the buffer by the spill,
+// so after a few frames the steady state does not touch the global heap at all.
+// Not thread-safe: one thread allocates from an arena at a time.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity = 64 * 1024)
+        : capacity_(roundCapacity(capacity)), buffer_(new std::byte[capacity_])
+    {
+        resource_.emplace(buffer_.get(), capacity_, &upstream_);
+    }
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &*resource_; }
+
+    // For std::pmr containers and allocator-aware types such as Detection and DetectionBatch
+    std::pmr::polymorphic_allocator<std::byte> allocator() { return resource(); }
+
+    // Size of the arena's own buffer
+    size_t capacity() const { return capacity_; }
+
+    // Bytes taken from the heap since the last reset because the buffer was full
+    size_t overflow() const { return upstream_.bytes(); }
+
+    // Free every allocation at once. Containers using the arena must be gone or never touched again.
+    void reset()
+    {
+        const size_t overflow = upstream_.bytes();
+        resource_.reset();
+        upstream_.clear();
+        if (overflow > 0)
+        {
+            capacity_ = roundCapacity(capacity_ + overflow);
+            buffer_.reset(new std::byte[capacity_]);
+        }
+        resource_.emplace(buffer_.get(), capacity_, &upstream_);
+    }
+
+private:
+    static size_t roundCapacity(size_t bytes)
+    {
+        const size_t page = 4096;
+        return (std::max(bytes, size_t(1)) + page - 1) / page * page;
+    }
+
+    detail::ArenaUpstream upstream_;
+    size_t capacity_;
+    std::unique_ptr<std::byte[]> buffer_;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
+
+// Recycles arenas across frames: attach one to each Frame (frame.arena = pool.acquire()).
+// An arena is reset wholesale and handed out again once the last Frame copy holding it is gone,
+// so per-frame containers must not outlive the frame they were allocated for.
+// Thread-safe, frames may be retired on any thread.
+class FrameArenaPool
+{
+public:
+    // capacity is the initial buffer size of each arena, arenas grow to the frames they serve
+    explicit FrameArenaPool(size_t capacity = 64 * 1024) : capacity_(capacity) {}
+
+    std::shared_ptr<FrameArena> acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto &arena : arenas_)
+        {
+            // Only the pool holds it: the frame was retired and nobody can take a new reference
+            if (arena.use_count() == 1)
+            {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                arena->reset();
+                return arena;
+            }
+        }
+        arenas_.push_back(std::make_shared<FrameArena>(capacity_));
+        return arenas_.back();
+    }
+
+    // Number of arenas, in use or idle
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return arenas_.size();
+    }
+
+    // Memory held by all arenas, excluding the spill of frames in flight
+    size_t bytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto &arena : arenas_)
+            total += arena->capacity();
+        return total;
+    }
+
+private:
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<FrameArena>> arenas_;
+};
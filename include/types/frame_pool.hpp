@@ -0,0 +1,257 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <opencv2/opencv.hpp>
+
+#include <types/frame.hpp>
+
+struct FramePoolStats
+{
+    size_t hits{0};   // buffers served from the free list
+    size_t misses{0}; // buffers that had to be allocated
+    size_t in_use{0}; // buffers referenced by at least one cv::Mat
+    size_t free{0};   // buffers waiting to be reused
+    size_t bytes{0};  // memory held by the pool, in use or free
+};
+
+namespace detail
+{
+    // cv::MatAllocator whose buffers go back to a free list when the last cv::Mat referencing
+    // them is released. Every live buffer keeps the allocator alive, so Mats may outlive the pool.
+    // cv::Mat::allocator is a raw pointer that survives release(), so FramePool never leaves it
+    // set on the Mats it hands out: a later create() on them allocates from the default allocator.
+    class FramePoolAllocator : public cv::MatAllocator, public std::enable_shared_from_this<FramePoolAllocator>
+    {
+    public:
+        explicit FramePoolAllocator(size_t max_free) : max_free_(max_free) {}
+
+        ~FramePoolAllocator() override
+        {
+            for (const Buffer &buffer : free_)
+                cv::fastFree(buffer.data);
+        }
+
+        cv::UMatData *allocate(int dims, const int *sizes, int type, void *data0, size_t *step,
+                               cv::AccessFlag, cv::UMatUsageFlags) const override
+        {
+            size_t total = CV_ELEM_SIZE(type);
+            for (int i = dims - 1; i >= 0; --i)
+            {
+                if (step)
+                {
+                    if (data0 && step[i] != CV_AUTOSTEP)
+                        total = step[i];
+                    else
+                        step[i] = total;
+                }
+                total *= static_cast<size_t>(sizes[i]);
+            }
+
+            cv::UMatData *u = new cv::UMatData(this);
+            u->size = total;
+            if (data0)
+            {
+                u->data = u->origdata = static_cast<uchar *>(data0);
+                u->flags |= cv::UMatData::USER_ALLOCATED;
+            }
+            else
+            {
+                u->data = u->origdata = acquire(total);
+                u->userdata = new std::shared_ptr<const FramePoolAllocator>(shared_from_this());
+            }
+            return u;
+        }
+
+        bool allocate(cv::UMatData *u, cv::AccessFlag, cv::UMatUsageFlags) const override
+        {
+            return u != nullptr;
+        }
+
+        void deallocate(cv::UMatData *u) const override
+        {
+            if (!u)
+                return;
+
+            // Released last: dropping the final reference may destroy this allocator
+            std::unique_ptr<std::shared_ptr<const FramePoolAllocator>> owner(
+                static_cast<std::shared_ptr<const FramePoolAllocator> *>(u->userdata));
+            if (!(u->flags & cv::UMatData::USER_ALLOCATED))
+                recycle(u->origdata, u->size);
+            delete u;
+        }
+
+        // Allocate count buffers of the given size up front
+        void reserve(size_t bytes, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < count; ++i)
+            {
+                free_.push_back({static_cast<uchar *>(cv::fastMalloc(bytes)), bytes});
+                stats_.bytes += bytes;
+            }
+            stats_.free = free_.size();
+        }
+
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const Buffer &buffer : free_)
+            {
+                cv::fastFree(buffer.data);
+                stats_.bytes -= buffer.size;
+            }
+            free_.clear();
+            stats_.free = 0;
+        }
+
+        FramePoolStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        struct Buffer
+        {
+            uchar *data;
+            size_t size;
+        };
+
+        uchar *acquire(size_t bytes) const
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.in_use;
+                for (auto it = free_.begin(); it != free_.end(); ++it)
+                {
+                    if (it->size == bytes)
+                    {
+                        uchar *data = it->data;
+                        free_.erase(it);
+                        ++stats_.hits;
+                        stats_.free = free_.size();
+                        return data;
+                    }
+                }
+                ++stats_.misses;
+                stats_.bytes += bytes;
+            }
+            return static_cast<uchar *>(cv::fastMalloc(bytes));
+        }
+
+        void recycle(uchar *data, size_t bytes) const
+        {
+            Buffer evicted{nullptr, 0};
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --stats_.in_use;
+                free_.push_back({data, bytes});
+                // Keep the most recently used buffers, e.g. after a resolution change
+                if (free_.size() > max_free_)
+                {
+                    evicted = free_.front();
+                    free_.pop_front();
+                    stats_.bytes -= evicted.size;
+                }
+                stats_.free = free_.size();
+            }
+            if (evicted.data)
+                cv::fastFree(evicted.data);
+        }
+
+        size_t max_free_;
+        mutable std::mutex mutex_;
+        mutable std::deque<Buffer> free_;
+        mutable FramePoolStats stats_;
+    };
+} // namespace detail
+
+// Recycles image buffers across frames: images allocated through the pool return to it
+// when the last cv::Mat (and so the last Frame copy) referencing them is released.
+// Thread-safe, buffers may be released on any thread.
+class FramePool
+{
+public:
+    // max_free bounds the number of idle buffers kept for reuse
+    explicit FramePool(size_t max_free = 8)
+        : allocator_(std::make_shared<detail::FramePoolAllocator>(max_free)) {}
+
+    // Preallocate count images, e.g. the capture resolution times the pipeline depth
+    void reserve(cv::Size size, int type, size_t count)
+    {
+        allocator_->reserve(static_cast<size_t>(size.area()) * CV_ELEM_SIZE(type), count);
+    }
+
+    cv::Mat acquire(cv::Size size, int type)
+    {
+        cv::Mat image;
+        image.allocator = allocator_.get();
+        image.create(size, type);
+        image.allocator = nullptr;
+        return image;
+    }
+
+    // Decode the frame already grabbed by cap into pooled storage
+    bool retrieve(cv::VideoCapture &cap, cv::Mat &image)
+    {
+        return decodeInto(image, [&cap](cv::Mat &out)
+                          { return cap.retrieve(out); });
+    }
+
+    // Same as operator>>(cv::VideoCapture &, Frame &), but the capture decodes into pooled storage
+    bool read(cv::VideoCapture &cap, Frame &frame)
+    {
+        cv::Mat image;
+        if (!readImage(cap, image))
+            return false;
+
+        frame = Frame(image);
+        return true;
+    }
+
+    bool read(cv::VideoCapture &cap, Frame &frame, FrameStream &stream)
+    {
+        cv::Mat image;
+        if (!readImage(cap, image))
+            return false;
+
+        frame = Frame(image, stream);
+        return true;
+    }
+
+    // Free the idle buffers, buffers still in use return to the pool as usual
+    void clear() { allocator_->clear(); }
+
+    FramePoolStats stats() const { return allocator_->stats(); }
+
+private:
+    bool readImage(cv::VideoCapture &cap, cv::Mat &image)
+    {
+        return decodeInto(image, [&cap](cv::Mat &out)
+                          { return cap.read(out); });
+    }
+
+    // The allocator is only set while decode runs, the image never keeps a pointer to it
+    template <typename Decode>
+    bool decodeInto(cv::Mat &image, Decode &&decode)
+    {
+        image.release();
+        image.allocator = allocator_.get();
+        bool ok = false;
+        try
+        {
+            ok = decode(image) && !image.empty();
+        }
+        catch (...)
+        {
+            image.allocator = nullptr;
+            throw;
+        }
+        image.allocator = nullptr;
+        return ok;
+    }
+
+    std::shared_ptr<detail::FramePoolAllocator> allocator_;
+};
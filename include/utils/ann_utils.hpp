@@ -0,0 +1,530 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <unordered_map>
+
+#include <utils/geometry_utils.hpp>
+#include <utils/vector_utils.hpp>
+
+struct AnnResult
+{
+    int64_t track_id;
+    float similarity; // same (1 + cos) / 2 convention as cosineSimilarity
+};
+
+struct HnswParams
+{
+    size_t M{16};                // graph degree on upper layers, 2 * M on the base layer
+    size_t ef_construction{200}; // candidate list size while inserting
+    size_t ef_search{64};        // candidate list size while searching, raised to k when smaller
+    uint32_t seed{42};
+};
+
+// Hierarchical navigable small world graph over L2-normalized feature vectors.
+// Several embeddings can share a track_id; erasing a track tombstones all of them,
+// tombstoned nodes keep routing searches but are never returned.
+// Searches may run concurrently with each other, but not with insert or erase.
+class HnswIndex
+{
+public:
+    explicit HnswIndex(size_t dim, const HnswParams &params = HnswParams())
+        : dim_(dim), params_(params), level_mult_(1.0 / std::log(static_cast<double>(std::max<size_t>(params.M, 2)))),
+          rng_(params.seed)
+    {
+        if (dim_ == 0)
+            throw std::invalid_argument("Feature dimension must be positive");
+    }
+
+    size_t dim() const { return dim_; }
+    size_t size() const { return live_; }
+    bool empty() const { return live_ == 0; }
+    const HnswParams &params() const { return params_; }
+
+    // Trade recall for latency without rebuilding the graph
+    void setEfSearch(size_t ef_search) { params_.ef_search = ef_search; }
+
+    template <typename Alloc = std::allocator<float>>
+    void insert(int64_t track_id, const std::vector<float, Alloc> &features)
+    {
+        if (features.size() != dim_)
+            throw std::invalid_argument("Feature size does not match index dimension");
+        insert(track_id, features.data());
+    }
+
+    void insert(int64_t track_id, const float *features)
+    {
+        const float norm = std::sqrt(vector_ops::dot(features, features, dim_));
+        if (norm < EPSILON)
+            throw std::invalid_argument("Cannot index a zero feature vector");
+
+        const uint32_t node = static_cast<uint32_t>(track_ids_.size());
+        const int level = randomLevel();
+
+        data_.resize(data_.size() + dim_);
+        float *vec = data_.data() + static_cast<size_t>(node) * dim_;
+        for (size_t k = 0; k < dim_; ++k)
+            vec[k] = features[k] / norm;
+
+        track_ids_.push_back(track_id);
+        levels_.push_back(level);
+        deleted_.push_back(0);
+        links_.emplace_back(linkOffset(level + 1), 0u);
+        track_nodes_[track_id].push_back(node);
+        ++live_;
+
+        if (node == 0)
+        {
+            entry_ = node;
+            max_level_ = level;
+            return;
+        }
+
+        uint32_t current = entry_;
+        float current_dist = distance(vec, current);
+        for (int l = max_level_; l > level; --l)
+            greedyDescend(vec, l, current, current_dist);
+
+        SearchScratch &scratch = searchScratch();
+        for (int l = std::min(level, max_level_); l >= 0; --l)
+        {
+            searchLayer(vec, current, params_.ef_construction, l, scratch);
+            std::sort_heap(scratch.results.begin(), scratch.results.end());
+
+            selectNeighbors(scratch.results, params_.M, scratch.selected);
+            uint32_t *block = linkBlock(node, l);
+            block[0] = static_cast<uint32_t>(scratch.selected.size());
+            for (size_t n = 0; n < scratch.selected.size(); ++n)
+            {
+                block[n + 1] = scratch.selected[n].second;
+            }
+
+            for (const auto &neighbor : scratch.selected)
+            {
+                connect(neighbor.second, node, l, scratch);
+            }
+            current = scratch.results.front().second;
+        }
+
+        if (level > max_level_)
+        {
+            entry_ = node;
+            max_level_ = level;
+        }
+    }
+
+    // Tombstone every embedding of a track, returns how many were removed
+    size_t erase(int64_t track_id)
+    {
+        auto it = track_nodes_.find(track_id);
+        if (it == track_nodes_.end())
+            return 0;
+
+        size_t removed = 0;
+        for (uint32_t node : it->second)
+        {
+            if (!deleted_[node])
+            {
+                deleted_[node] = 1;
+                ++removed;
+            }
+        }
+        live_ -= removed;
+        track_nodes_.erase(it);
+        return removed;
+    }
+
+    // Up to k live embeddings most similar to query with similarity >= min_similarity, best first
+    void search(const float *query, size_t k, float min_similarity, std::vector<AnnResult> &out) const
+    {
+        out.clear();
+        if (live_ == 0 || k == 0)
+            return;
+
+        SearchScratch &scratch = searchScratch();
+        scratch.query.resize(dim_);
+        const float norm = std::sqrt(vector_ops::dot(query, query, dim_));
+        if (norm < EPSILON)
+            return;
+        for (size_t d = 0; d < dim_; ++d)
+            scratch.query[d] = query[d] / norm;
+        const float *q = scratch.query.data();
+
+        uint32_t current = entry_;
+        float current_dist = distance(q, current);
+        for (int l = max_level_; l > 0; --l)
+            greedyDescend(q, l, current, current_dist);
+
+        searchLayer(q, current, std::max(params_.ef_search, k), 0, scratch);
+        std::sort_heap(scratch.results.begin(), scratch.results.end());
+
+        for (const auto &candidate : scratch.results)
+        {
+            if (out.size() == k)
+                break;
+            if (deleted_[candidate.second])
+                continue;
+
+            float similarity = 1.f - candidate.first / 2.f;
+            if (similarity < min_similarity)
+                break;
+            out.push_back({track_ids_[candidate.second], similarity});
+        }
+    }
+
+    template <typename Alloc = std::allocator<float>>
+    std::vector<AnnResult> search(const std::vector<float, Alloc> &query, size_t k, float min_similarity = 0.f) const
+    {
+        if (query.size() != dim_)
+            throw std::invalid_argument("Feature size does not match index dimension");
+
+        std::vector<AnnResult> out;
+        search(query.data(), k, min_similarity, out);
+        return out;
+    }
+
+    // Compact binary dump in native byte order, tombstones included
+    void save(const std::string &path) const
+    {
+        std::ofstream os(path, std::ios::binary);
+        if (!os)
+            throw std::runtime_error("Cannot open " + path + " for writing");
+
+        const uint64_t count = track_ids_.size();
+        os.write(MAGIC, sizeof(MAGIC));
+        writePod(os, static_cast<uint64_t>(dim_));
+        writePod(os, static_cast<uint64_t>(params_.M));
+        writePod(os, static_cast<uint64_t>(params_.ef_construction));
+        writePod(os, static_cast<uint64_t>(params_.ef_search));
+        writePod(os, params_.seed);
+        writePod(os, count);
+        writePod(os, entry_);
+        writePod(os, max_level_);
+
+        os.write(reinterpret_cast<const char *>(data_.data()), static_cast<std::streamsize>(data_.size() * sizeof(float)));
+        os.write(reinterpret_cast<const char *>(track_ids_.data()), static_cast<std::streamsize>(count * sizeof(int64_t)));
+        os.write(reinterpret_cast<const char *>(levels_.data()), static_cast<std::streamsize>(count * sizeof(int)));
+        os.write(reinterpret_cast<const char *>(deleted_.data()), static_cast<std::streamsize>(count));
+        for (const auto &links : links_)
+        {
+            os.write(reinterpret_cast<const char *>(links.data()), static_cast<std::streamsize>(links.size() * sizeof(uint32_t)));
+        }
+
+        if (!os)
+            throw std::runtime_error("Failed to write " + path);
+    }
+
+    // Throws std::runtime_error on a file that is truncated or whose graph is inconsistent
+    static HnswIndex load(const std::string &path)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is)
+            throw std::runtime_error("Cannot open " + path + " for reading");
+
+        char magic[sizeof(MAGIC)];
+        is.read(magic, sizeof(magic));
+        if (!is || !std::equal(magic, magic + sizeof(magic), MAGIC))
+            throw std::runtime_error(path + " is not an HNSW index file");
+
+        HnswParams params;
+        uint64_t dim = readPod<uint64_t>(is);
+        params.M = readPod<uint64_t>(is);
+        params.ef_construction = readPod<uint64_t>(is);
+        params.ef_search = readPod<uint64_t>(is);
+        params.seed = readPod<uint32_t>(is);
+        const uint64_t count = readPod<uint64_t>(is);
+        const uint32_t entry = readPod<uint32_t>(is);
+        const int max_level = readPod<int>(is);
+        if (!is)
+            throw std::runtime_error("Truncated HNSW index file " + path);
+
+        auto corrupt = [&path](const std::string &what)
+        { return std::runtime_error("Corrupt HNSW index file " + path + ": " + what); };
+
+        if (dim == 0 || params.M == 0 || params.M > MAX_M)
+            throw corrupt("invalid parameters");
+
+        // Bound count by the file size before allocating, each node takes at least its level 0 block
+        const std::streampos body = is.tellg();
+        is.seekg(0, std::ios::end);
+        const uint64_t remaining = static_cast<uint64_t>(is.tellg() - body);
+        is.seekg(body);
+        if (count > 0 && dim > remaining / sizeof(float))
+            throw std::runtime_error("Truncated HNSW index file " + path);
+        const uint64_t node_bytes = dim * sizeof(float) + sizeof(int64_t) + sizeof(int) + 1 + (2 * params.M + 1) * sizeof(uint32_t);
+        if (count > remaining / node_bytes || count > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error("Truncated HNSW index file " + path);
+
+        HnswIndex index(dim, params);
+        index.entry_ = entry;
+        index.max_level_ = max_level;
+        if (count == 0 ? (entry != 0 || max_level != 0) : entry >= count)
+            throw corrupt("invalid entry point");
+
+        index.data_.resize(count * dim);
+        index.track_ids_.resize(count);
+        index.levels_.resize(count);
+        index.deleted_.resize(count);
+        is.read(reinterpret_cast<char *>(index.data_.data()), static_cast<std::streamsize>(index.data_.size() * sizeof(float)));
+        is.read(reinterpret_cast<char *>(index.track_ids_.data()), static_cast<std::streamsize>(count * sizeof(int64_t)));
+        is.read(reinterpret_cast<char *>(index.levels_.data()), static_cast<std::streamsize>(count * sizeof(int)));
+        is.read(reinterpret_cast<char *>(index.deleted_.data()), static_cast<std::streamsize>(count));
+        if (!is)
+            throw std::runtime_error("Truncated HNSW index file " + path);
+
+        // Levels are bounded like randomLevel(), the entry point sits on the top level
+        if (max_level < 0 || max_level > static_cast<int>(-std::log(1e-12) * index.level_mult_))
+            throw corrupt("invalid node level");
+        for (int level : index.levels_)
+        {
+            if (level < 0 || level > max_level)
+                throw corrupt("invalid node level");
+        }
+        if (count > 0 && index.levels_[entry] != max_level)
+            throw corrupt("invalid entry point");
+
+        index.links_.resize(count);
+        for (uint64_t node = 0; node < count; ++node)
+        {
+            index.links_[node].resize(index.linkOffset(index.levels_[node] + 1));
+            is.read(reinterpret_cast<char *>(index.links_[node].data()), static_cast<std::streamsize>(index.links_[node].size() * sizeof(uint32_t)));
+            if (!is)
+                throw std::runtime_error("Truncated HNSW index file " + path);
+
+            // Searches at level l only follow links to nodes that have that level
+            for (int level = 0; level <= index.levels_[node]; ++level)
+            {
+                const uint32_t *block = index.linkBlock(static_cast<uint32_t>(node), level);
+                if (block[0] > index.maxLinks(level))
+                    throw corrupt("invalid link count");
+                for (uint32_t n = 1; n <= block[0]; ++n)
+                {
+                    if (block[n] >= count || index.levels_[block[n]] < level)
+                        throw corrupt("invalid link");
+                }
+            }
+
+            if (!index.deleted_[node])
+            {
+                index.track_nodes_[index.track_ids_[node]].push_back(static_cast<uint32_t>(node));
+                ++index.live_;
+            }
+        }
+
+        // Keep the level sequence of further inserts independent from the save point
+        index.rng_.seed(params.seed + static_cast<uint32_t>(count));
+        return index;
+    }
+
+private:
+    using Candidate = std::pair<float, uint32_t>; // (distance, node)
+
+    struct SearchScratch
+    {
+        std::vector<Candidate> candidates; // min-heap on distance
+        std::vector<Candidate> results;    // max-heap on distance
+        std::vector<Candidate> selected;
+        std::vector<Candidate> pruned;
+        std::vector<uint32_t> visited;
+        std::vector<float> query;
+        uint32_t stamp{0};
+    };
+
+    static constexpr char MAGIC[8] = {'V', 'C', 'H', 'N', 'S', 'W', '0', '1'};
+    static constexpr size_t MAX_M = 4096; // sanity bound for loaded files
+
+    static SearchScratch &searchScratch()
+    {
+        thread_local SearchScratch scratch;
+        return scratch;
+    }
+
+    template <typename T>
+    static void writePod(std::ostream &os, const T &value)
+    {
+        os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static T readPod(std::istream &is)
+    {
+        T value{};
+        is.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return value;
+    }
+
+    int randomLevel()
+    {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        double r = std::max(uniform(rng_), 1e-12);
+        return static_cast<int>(-std::log(r) * level_mult_);
+    }
+
+    size_t maxLinks(int level) const { return level == 0 ? 2 * params_.M : params_.M; }
+
+    // Per-node link storage: level 0 block then upper level blocks, each [count, ids...]
+    size_t linkOffset(int level) const
+    {
+        return level == 0 ? 0 : (2 * params_.M + 1) + static_cast<size_t>(level - 1) * (params_.M + 1);
+    }
+
+    uint32_t *linkBlock(uint32_t node, int level) { return links_[node].data() + linkOffset(level); }
+    const uint32_t *linkBlock(uint32_t node, int level) const { return links_[node].data() + linkOffset(level); }
+
+    const float *features(uint32_t node) const { return data_.data() + static_cast<size_t>(node) * dim_; }
+
+    float distance(const float *query, uint32_t node) const
+    {
+        return 1.f - vector_ops::dot(query, features(node), dim_);
+    }
+
+    void greedyDescend(const float *query, int level, uint32_t &current, float &current_dist) const
+    {
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            const uint32_t *block = linkBlock(current, level);
+            for (uint32_t n = 1; n <= block[0]; ++n)
+            {
+                float d = distance(query, block[n]);
+                if (d < current_dist)
+                {
+                    current_dist = d;
+                    current = block[n];
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Best-first search of one layer, leaves the ef closest nodes as a max-heap in scratch.results
+    void searchLayer(const float *query, uint32_t entry, size_t ef, int level, SearchScratch &scratch) const
+    {
+        if (scratch.visited.size() < track_ids_.size())
+            scratch.visited.resize(track_ids_.size(), 0);
+        if (++scratch.stamp == 0)
+        {
+            std::fill(scratch.visited.begin(), scratch.visited.end(), 0);
+            scratch.stamp = 1;
+        }
+
+        auto &candidates = scratch.candidates;
+        auto &results = scratch.results;
+        candidates.clear();
+        results.clear();
+
+        const float entry_dist = distance(query, entry);
+        candidates.emplace_back(entry_dist, entry);
+        results.emplace_back(entry_dist, entry);
+        scratch.visited[entry] = scratch.stamp;
+
+        while (!candidates.empty())
+        {
+            std::pop_heap(candidates.begin(), candidates.end(), std::greater<>());
+            const Candidate closest = candidates.back();
+            candidates.pop_back();
+            if (closest.first > results.front().first && results.size() >= ef)
+                break;
+
+            const uint32_t *block = linkBlock(closest.second, level);
+            for (uint32_t n = 1; n <= block[0]; ++n)
+            {
+                const uint32_t neighbor = block[n];
+                if (scratch.visited[neighbor] == scratch.stamp)
+                    continue;
+                scratch.visited[neighbor] = scratch.stamp;
+
+                const float d = distance(query, neighbor);
+                if (results.size() < ef || d < results.front().first)
+                {
+                    candidates.emplace_back(d, neighbor);
+                    std::push_heap(candidates.begin(), candidates.end(), std::greater<>());
+                    results.emplace_back(d, neighbor);
+                    std::push_heap(results.begin(), results.end());
+                    if (results.size() > ef)
+                    {
+                        std::pop_heap(results.begin(), results.end());
+                        results.pop_back();
+                    }
+                }
+            }
+        }
+    }
+
+    // Neighbor selection heuristic: keep a candidate only if it is closer to the base than to every kept neighbor
+    void selectNeighbors(const std::vector<Candidate> &sorted, size_t max_count, std::vector<Candidate> &selected) const
+    {
+        selected.clear();
+        for (const auto &candidate : sorted)
+        {
+            if (selected.size() >= max_count)
+                break;
+
+            bool diverse = true;
+            for (const auto &kept : selected)
+            {
+                if (1.f - vector_ops::dot(features(candidate.second), features(kept.second), dim_) < candidate.first)
+                {
+                    diverse = false;
+                    break;
+                }
+            }
+            if (diverse)
+                selected.push_back(candidate);
+        }
+    }
+
+    void connect(uint32_t node, uint32_t neighbor, int level, SearchScratch &scratch)
+    {
+        uint32_t *block = linkBlock(node, level);
+        const size_t capacity = maxLinks(level);
+        if (block[0] < capacity)
+        {
+            block[++block[0]] = neighbor;
+            return;
+        }
+
+        // Full: re-select among the existing links plus the new one
+        std::vector<Candidate> &pool = scratch.candidates;
+        pool.clear();
+        const float *base = features(node);
+        pool.emplace_back(distance(base, neighbor), neighbor);
+        for (uint32_t n = 1; n <= block[0]; ++n)
+        {
+            pool.emplace_back(distance(base, block[n]), block[n]);
+        }
+        std::sort(pool.begin(), pool.end());
+
+        std::vector<Candidate> &kept = scratch.pruned;
+        selectNeighbors(pool, capacity, kept);
+        block[0] = static_cast<uint32_t>(kept.size());
+        for (size_t n = 0; n < kept.size(); ++n)
+        {
+            block[n + 1] = kept[n].second;
+        }
+    }
+
+    size_t dim_;
+    HnswParams params_;
+    double level_mult_;
+    std::mt19937 rng_;
+
+    std::vector<float> data_{};
+    std::vector<int64_t> track_ids_{};
+    std::vector<int> levels_{};
+    std::vector<uint8_t> deleted_{};
+    std::vector<std::vector<uint32_t>> links_{};
+    std::unordered_map<int64_t, std::vector<uint32_t>> track_nodes_{};
+
+    uint32_t entry_{0};
+    int max_level_{0};
+    size_t live_{0};
+};
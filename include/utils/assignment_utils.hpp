@@ -0,0 +1,480 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+#include <utils/spatial_utils.hpp>
+
+// Sparse cost entry, pairs that are not listed are never matched
+struct AssignmentCandidate
+{
+    int row;
+    int col;
+    float cost;
+};
+
+// Cost matrix and Jonker-Volgenant state of solveAssignment (dense and sparse), one per tracker
+struct AssignmentWorkspace
+{
+    // Dense: square cost matrix, column prices and Jonker-Volgenant bookkeeping
+    std::vector<float> cost{};
+    std::vector<double> v{}, d{};
+    std::vector<int> row_sol{}, col_sol{}, pred{}, col_list{}, free_rows{}, matches{};
+
+    // Sparse: candidates by row (CSR), shortest path labels and heap
+    std::vector<int> row_start{}, edge_col{}, touched{}, ready{};
+    std::vector<float> edge_cost{}, pred_cost{}, row_cost{};
+    std::vector<uint8_t> done{};
+    std::vector<std::pair<double, int>> heap{};
+
+    // BoxOverlap input converted to candidates
+    std::vector<AssignmentCandidate> candidates{};
+};
+
+namespace detail
+{
+    // Jonker-Volgenant on the n x n matrix in ws.cost: column reduction, reduction transfer,
+    // two rounds of augmenting row reduction, then shortest augmenting paths for the free rows
+    inline void lapjv(size_t n, AssignmentWorkspace &ws)
+    {
+        const float *cost = ws.cost.data();
+        const double big = std::numeric_limits<double>::max();
+        std::vector<double> &v = ws.v, &d = ws.d;
+        std::vector<int> &row_sol = ws.row_sol, &col_sol = ws.col_sol, &free_rows = ws.free_rows;
+        v.assign(n, 0.0);
+        d.resize(n);
+        row_sol.assign(n, -1);
+        col_sol.assign(n, -1);
+        ws.matches.assign(n, 0);
+        ws.pred.resize(n);
+        ws.col_list.resize(n);
+        free_rows.resize(n);
+
+        if (n == 1)
+        {
+            row_sol[0] = col_sol[0] = 0;
+            return;
+        }
+
+        // Column reduction: each column goes to its cheapest row, a row keeps its cheapest column
+        for (size_t jj = n; jj-- > 0;)
+        {
+            const int j = static_cast<int>(jj);
+            double min = cost[j];
+            int imin = 0;
+            for (size_t i = 1; i < n; ++i)
+            {
+                if (cost[i * n + j] < min)
+                {
+                    min = cost[i * n + j];
+                    imin = static_cast<int>(i);
+                }
+            }
+            v[j] = min;
+            if (++ws.matches[imin] == 1)
+            {
+                row_sol[imin] = j;
+                col_sol[j] = imin;
+            }
+            else if (v[j] < v[row_sol[imin]])
+            {
+                const int j1 = row_sol[imin];
+                row_sol[imin] = j;
+                col_sol[j] = imin;
+                col_sol[j1] = -1;
+            }
+        }
+
+        // Reduction transfer: lower the price of singly assigned columns as far as the row allows
+        size_t num_free = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (ws.matches[i] == 0)
+            {
+                free_rows[num_free++] = static_cast<int>(i);
+            }
+            else if (ws.matches[i] == 1)
+            {
+                const int j1 = row_sol[i];
+                const float *row = cost + i * n;
+                double min = big;
+                for (size_t j = 0; j < n; ++j)
+                    if (static_cast<int>(j) != j1)
+                        min = std::min(min, row[j] - v[j]);
+                v[j1] -= min;
+            }
+        }
+
+        // Augmenting row reduction, bounded so that near-ties cannot make it crawl
+        for (int round = 0; round < 2 && num_free > 0; ++round)
+        {
+            const size_t previous = num_free;
+            size_t k = 0, steps = 0;
+            num_free = 0;
+            while (k < previous)
+            {
+                if (++steps > 4 * n)
+                {
+                    while (k < previous)
+                        free_rows[num_free++] = free_rows[k++];
+                    break;
+                }
+
+                const int i = free_rows[k++];
+                const float *row = cost + static_cast<size_t>(i) * n;
+                double umin = row[0] - v[0], usubmin = big;
+                int j1 = 0, j2 = 0;
+                for (size_t j = 1; j < n; ++j)
+                {
+                    const double h = row[j] - v[j];
+                    if (h < usubmin)
+                    {
+                        if (h >= umin)
+                        {
+                            usubmin = h;
+                            j2 = static_cast<int>(j);
+                        }
+                        else
+                        {
+                            usubmin = umin;
+                            umin = h;
+                            j2 = j1;
+                            j1 = static_cast<int>(j);
+                        }
+                    }
+                }
+
+                int i0 = col_sol[j1];
+                if (umin < usubmin)
+                {
+                    v[j1] -= usubmin - umin;
+                }
+                else if (i0 >= 0)
+                {
+                    j1 = j2;
+                    i0 = col_sol[j2];
+                }
+                if (row_sol[i] >= 0 && col_sol[row_sol[i]] == i)
+                    col_sol[row_sol[i]] = -1;
+                row_sol[i] = j1;
+                col_sol[j1] = i;
+
+                if (i0 >= 0)
+                {
+                    row_sol[i0] = -1;
+                    if (umin < usubmin)
+                        free_rows[--k] = i0;
+                    else
+                        free_rows[num_free++] = i0;
+                }
+            }
+        }
+
+        // Augmentation: Dijkstra over reduced costs from each remaining free row
+        std::vector<int> &pred = ws.pred, &col_list = ws.col_list;
+        for (size_t f = 0; f < num_free; ++f)
+        {
+            const int free_row = free_rows[f];
+            const float *row = cost + static_cast<size_t>(free_row) * n;
+            for (size_t j = 0; j < n; ++j)
+            {
+                d[j] = row[j] - v[j];
+                pred[j] = free_row;
+                col_list[j] = static_cast<int>(j);
+            }
+
+            // col_list[0, low) are scanned, [low, up) are at the current minimum distance
+            size_t low = 0, up = 0, last = 0;
+            int end_of_path = -1;
+            double min = 0.0;
+            while (end_of_path < 0)
+            {
+                if (up == low)
+                {
+                    last = low;
+                    min = d[col_list[up++]];
+                    for (size_t k = up; k < n; ++k)
+                    {
+                        const int j = col_list[k];
+                        const double h = d[j];
+                        if (h <= min)
+                        {
+                            if (h < min)
+                            {
+                                up = low;
+                                min = h;
+                            }
+                            col_list[k] = col_list[up];
+                            col_list[up++] = j;
+                        }
+                    }
+                    for (size_t k = low; k < up; ++k)
+                    {
+                        if (col_sol[col_list[k]] < 0)
+                        {
+                            end_of_path = col_list[k];
+                            break;
+                        }
+                    }
+                }
+
+                if (end_of_path < 0)
+                {
+                    const int j1 = col_list[low++];
+                    const int i = col_sol[j1];
+                    const float *row_i = cost + static_cast<size_t>(i) * n;
+                    const double h = row_i[j1] - v[j1] - min;
+                    for (size_t k = up; k < n; ++k)
+                    {
+                        const int j = col_list[k];
+                        const double v2 = row_i[j] - v[j] - h;
+                        if (v2 < d[j])
+                        {
+                            pred[j] = i;
+                            if (v2 == min)
+                            {
+                                if (col_sol[j] < 0)
+                                {
+                                    end_of_path = j;
+                                    break;
+                                }
+                                col_list[k] = col_list[up];
+                                col_list[up++] = j;
+                            }
+                            d[j] = v2;
+                        }
+                    }
+                }
+            }
+
+            // Columns scanned before the last minimum search keep reduced costs non-negative
+            for (size_t k = 0; k < last; ++k)
+            {
+                const int j = col_list[k];
+                v[j] += d[j] - min;
+            }
+
+            int i;
+            do
+            {
+                i = pred[end_of_path];
+                col_sol[end_of_path] = i;
+                std::swap(end_of_path, row_sol[i]);
+            } while (i != free_row);
+        }
+    }
+
+    inline void finishAssignment(size_t rows, size_t cols, std::vector<int> &row_to_col, std::vector<int> &col_to_row)
+    {
+        col_to_row.assign(cols, -1);
+        for (size_t i = 0; i < rows; ++i)
+            if (row_to_col[i] >= 0)
+                col_to_row[row_to_col[i]] = static_cast<int>(i);
+    }
+} // namespace detail
+
+// Minimum-cost matching of rows (e.g. tracks) to columns (e.g. detections) with the
+// Jonker-Volgenant algorithm on a dense row-major [rows x cols] cost matrix, e.g. 1 - IoU
+// or 1 - cosine similarity. Rectangular matrices leave the surplus rows or columns unmatched.
+// With a finite max_cost, pairs costing more are never matched and any row or column may stay
+// unmatched when that is cheaper (every match saves max_cost against leaving both sides open).
+// Costs must be finite. Unmatched entries of row_to_col and col_to_row are -1, returns the number of matches.
+inline size_t solveAssignment(const float *cost, size_t rows, size_t cols, float max_cost, AssignmentWorkspace &ws,
+                              std::vector<int> &row_to_col, std::vector<int> &col_to_row)
+{
+    row_to_col.assign(rows, -1);
+    col_to_row.assign(cols, -1);
+    if (rows == 0 || cols == 0)
+        return 0;
+    if (std::isnan(max_cost))
+        throw std::invalid_argument("max_cost must not be NaN");
+
+    // Square by zero-cost padding; gating by clamping to max_cost, which has the same optimum as
+    // leaving a row and a column unmatched for max_cost / 2 each without doubling the matrix
+    const size_t n = std::max(rows, cols);
+    ws.cost.assign(n * n, 0.f);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const float *src = cost + i * cols;
+        float *dst = ws.cost.data() + i * n;
+        for (size_t j = 0; j < cols; ++j)
+            dst[j] = std::min(src[j], max_cost);
+    }
+
+    detail::lapjv(n, ws);
+
+    size_t matches = 0;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const int j = ws.row_sol[i];
+        if (j < static_cast<int>(cols) && cost[i * cols + j] <= max_cost)
+        {
+            row_to_col[i] = j;
+            ++matches;
+        }
+    }
+    detail::finishAssignment(rows, cols, row_to_col, col_to_row);
+    return matches;
+}
+
+// Same matching over a sparse candidate list, e.g. track and detection pairs whose boxes overlap.
+// Unlisted pairs and pairs costing more than max_cost are never matched, max_cost must be finite.
+// Shortest augmenting paths only visit the candidates, so sparse frames cost far less than the dense solver.
+inline size_t solveAssignment(const AssignmentCandidate *candidates, size_t count, size_t rows, size_t cols, float max_cost,
+                              AssignmentWorkspace &ws, std::vector<int> &row_to_col, std::vector<int> &col_to_row)
+{
+    if (!std::isfinite(max_cost))
+        throw std::invalid_argument("Sparse assignment needs a finite max_cost");
+
+    // Candidates by row, at cost - max_cost so that every eligible match pays off against
+    // the private zero-cost dummy column cols + i that leaves row i unmatched
+    ws.row_start.assign(rows + 1, 0);
+    for (size_t e = 0; e < count; ++e)
+    {
+        const AssignmentCandidate &candidate = candidates[e];
+        if (candidate.row < 0 || static_cast<size_t>(candidate.row) >= rows || candidate.col < 0 || static_cast<size_t>(candidate.col) >= cols)
+            throw std::invalid_argument("Assignment candidate out of range");
+        if (candidate.cost <= max_cost)
+            ++ws.row_start[candidate.row + 1];
+    }
+    for (size_t i = 0; i < rows; ++i)
+        ws.row_start[i + 1] += ws.row_start[i];
+    ws.edge_col.resize(ws.row_start[rows]);
+    ws.edge_cost.resize(ws.row_start[rows]);
+    ws.touched.assign(ws.row_start.begin(), ws.row_start.end() - 1); // fill cursor per row
+    for (size_t e = 0; e < count; ++e)
+    {
+        const AssignmentCandidate &candidate = candidates[e];
+        if (candidate.cost <= max_cost)
+        {
+            const int slot = ws.touched[candidate.row]++;
+            ws.edge_col[slot] = candidate.col;
+            ws.edge_cost[slot] = candidate.cost - max_cost;
+        }
+    }
+
+    const size_t num_cols = cols + rows;
+    const double infinity = std::numeric_limits<double>::infinity();
+    ws.v.assign(num_cols, 0.0);
+    ws.d.assign(num_cols, infinity);
+    ws.done.assign(num_cols, 0);
+    ws.col_sol.assign(num_cols, -1);
+    ws.pred.resize(num_cols);
+    ws.pred_cost.resize(num_cols);
+    ws.row_sol.assign(rows, -1);
+    ws.row_cost.assign(rows, 0.f);
+    ws.touched.clear();
+
+    auto relax = [&](int j, double distance, int i, float edge_cost)
+    {
+        if (ws.done[j] || distance >= ws.d[j])
+            return;
+        if (ws.d[j] == infinity)
+            ws.touched.push_back(j);
+        ws.d[j] = distance;
+        ws.pred[j] = i;
+        ws.pred_cost[j] = edge_cost;
+        ws.heap.emplace_back(distance, j);
+        std::push_heap(ws.heap.begin(), ws.heap.end(), std::greater<>());
+    };
+
+    // Relax the candidates of row i and its dummy column, base is the distance to row i
+    auto scanRow = [&](int i, double base)
+    {
+        for (int e = ws.row_start[i]; e < ws.row_start[i + 1]; ++e)
+            relax(ws.edge_col[e], base + ws.edge_cost[e] - ws.v[ws.edge_col[e]], i, ws.edge_cost[e]);
+        const int dummy = static_cast<int>(cols) + i;
+        relax(dummy, base - ws.v[dummy], i, 0.f);
+    };
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const int free_row = static_cast<int>(r);
+        ws.heap.clear();
+        ws.ready.clear();
+        scanRow(free_row, 0.0);
+
+        // The row's own dummy column is free, so a path always exists
+        int sink = -1;
+        double min = 0.0;
+        while (sink < 0)
+        {
+            std::pop_heap(ws.heap.begin(), ws.heap.end(), std::greater<>());
+            const auto [distance, j] = ws.heap.back();
+            ws.heap.pop_back();
+            if (ws.done[j] || distance > ws.d[j])
+                continue;
+
+            ws.done[j] = 1;
+            ws.ready.push_back(j);
+            const int i = ws.col_sol[j];
+            if (i < 0)
+            {
+                sink = j;
+                min = distance;
+            }
+            else
+            {
+                scanRow(i, distance - (ws.row_cost[i] - ws.v[j]));
+            }
+        }
+
+        for (int j : ws.ready)
+            ws.v[j] += ws.d[j] - min;
+
+        for (int j = sink;;)
+        {
+            const int i = ws.pred[j];
+            const int previous = ws.row_sol[i];
+            ws.col_sol[j] = i;
+            ws.row_sol[i] = j;
+            ws.row_cost[i] = ws.pred_cost[j];
+            if (i == free_row)
+                break;
+            j = previous;
+        }
+
+        for (int j : ws.touched)
+        {
+            ws.d[j] = infinity;
+            ws.done[j] = 0;
+        }
+        ws.touched.clear();
+    }
+
+    size_t matches = 0;
+    row_to_col.assign(rows, -1);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        if (ws.row_sol[i] < static_cast<int>(cols))
+        {
+            row_to_col[i] = ws.row_sol[i];
+            ++matches;
+        }
+    }
+    detail::finishAssignment(rows, cols, row_to_col, col_to_row);
+    return matches;
+}
+
+inline size_t solveAssignment(const std::vector<AssignmentCandidate> &candidates, size_t rows, size_t cols, float max_cost,
+                              AssignmentWorkspace &ws, std::vector<int> &row_to_col, std::vector<int> &col_to_row)
+{
+    return solveAssignment(candidates.data(), candidates.size(), rows, cols, max_cost, ws, row_to_col, col_to_row);
+}
+
+// IoU matching from findOverlaps(tracks, detections, ...) output at cost 1 - IoU, which maximizes
+// the total IoU of the matches. Pairs costing more than max_cost (IoU below 1 - max_cost) are never matched.
+inline size_t solveAssignment(const std::vector<BoxOverlap> &overlaps, size_t rows, size_t cols, float max_cost,
+                              AssignmentWorkspace &ws, std::vector<int> &row_to_col, std::vector<int> &col_to_row)
+{
+    ws.candidates.resize(overlaps.size());
+    for (size_t k = 0; k < overlaps.size(); ++k)
+        ws.candidates[k] = {overlaps[k].first, overlaps[k].second, 1.f - overlaps[k].iou};
+    return solveAssignment(ws.candidates.data(), ws.candidates.size(), rows, cols, max_cost, ws, row_to_col, col_to_row);
+}
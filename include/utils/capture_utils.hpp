@@ -0,0 +1,146 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <exception>
+#include <opencv2/opencv.hpp>
+
+#include <types/frame.hpp>
+#include <types/frame_pool.hpp>
+#include <utils/thread_utils.hpp>
+
+struct AsyncCaptureParams
+{
+    size_t capacity{4};                          // decoded frames buffered for the consumer
+    QueuePolicy policy{QueuePolicy::DropOldest}; // DropOldest keeps live streams current, Block suits files
+    int64_t stream_id{-1};                       // Frame::stream_id, -1 numbers the stream automatically
+};
+
+struct AsyncCaptureStats
+{
+    size_t captured{0}; // frames decoded and handed to the queue
+    size_t dropped{0};  // frames rejected or evicted because the consumer fell behind
+    size_t depth{0};    // frames waiting for the consumer
+};
+
+// Decodes a cv::VideoCapture on a background thread into a bounded queue of Frames.
+// Frames are timestamped right after grab(), numbered on the capture's own FrameStream
+// and decoded into pooled image buffers.
+class AsyncCapture
+{
+public:
+    explicit AsyncCapture(const std::string &source, const AsyncCaptureParams &params = {})
+        : AsyncCapture(std::make_unique<cv::VideoCapture>(source), params)
+    {
+    }
+
+    explicit AsyncCapture(int device, const AsyncCaptureParams &params = {})
+        : AsyncCapture(std::make_unique<cv::VideoCapture>(device), params)
+    {
+    }
+
+    // Takes over an already configured capture
+    explicit AsyncCapture(std::unique_ptr<cv::VideoCapture> capture, const AsyncCaptureParams &params = {})
+        : capture_(std::move(capture)), stream_(params.stream_id >= 0 ? FrameStream(params.stream_id) : FrameStream()),
+          pool_(params.capacity + 2), queue_(params.capacity, params.policy)
+    {
+        if (!capture_ || !capture_->isOpened())
+            throw std::runtime_error("Failed to open video capture");
+
+        worker_ = std::thread([this]()
+                              { run(); });
+    }
+
+    AsyncCapture(const AsyncCapture &) = delete;
+    AsyncCapture &operator=(const AsyncCapture &) = delete;
+
+    ~AsyncCapture()
+    {
+        stop();
+    }
+
+    // Block until the next frame, false once the stream ended or stop() was called
+    // and the queued frames are drained. Rethrows a failure of the decode thread.
+    bool read(Frame &frame)
+    {
+        if (queue_.pop(frame))
+            return true;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failure_)
+            std::rethrow_exception(failure_);
+        return false;
+    }
+
+    // Non-blocking read, false when no frame is queued
+    bool tryRead(Frame &frame)
+    {
+        return queue_.tryPop(frame);
+    }
+
+    // Stop decoding, frames already queued can still be read
+    void stop()
+    {
+        stopping_ = true;
+        queue_.close();
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    AsyncCaptureStats stats() const
+    {
+        return {captured_.load(std::memory_order_acquire), queue_.dropped(), queue_.size()};
+    }
+
+    FramePoolStats poolStats() const { return pool_.stats(); }
+
+    int64_t streamId() const { return stream_.id(); }
+
+private:
+    void run()
+    {
+        try
+        {
+            while (!stopping_)
+            {
+                if (!capture_->grab())
+                    break;
+                const TimePoint timestamp = std::chrono::system_clock::now();
+                const SteadyTimePoint capture_time = std::chrono::steady_clock::now();
+
+                cv::Mat image;
+                if (!pool_.retrieve(*capture_, image))
+                    break;
+
+                // Counted once queued or dropped, so stats() never runs ahead of the queue.
+                // A frame refused because stop() closed the queue is not counted.
+                bool closed = false;
+                queue_.push(Frame(image, stream_, timestamp, capture_time), closed);
+                if (closed)
+                    break;
+                captured_.fetch_add(1, std::memory_order_release);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failure_ = std::current_exception();
+        }
+        queue_.close();
+    }
+
+    std::unique_ptr<cv::VideoCapture> capture_;
+    FrameStream stream_;
+    FramePool pool_;
+    BoundedQueue<Frame> queue_;
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<size_t> captured_{0};
+    std::exception_ptr failure_{};
+    std::mutex mutex_;
+    std::thread worker_{};
+};
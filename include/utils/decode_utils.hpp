@@ -0,0 +1,336 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection_batch.hpp>
+#include <utils/simd_utils.hpp>
+#include <utils/vector_utils.hpp>
+#include <utils/detection_utils.hpp>
+
+// Memory order of one image's raw detector output
+enum class DecodeLayout
+{
+    AttributesFirst, // [attributes][anchors], e.g. YOLOv8 1x84x8400
+    AnchorsFirst     // [anchors][attributes], e.g. YOLOv5 1x25200x85 or a transposed YOLOv8 output
+};
+
+enum class BoxEncoding
+{
+    CxCyWh, // center and size (YOLO)
+    XyXy    // corners (SSD and exported end-to-end models)
+};
+
+// Attributes per anchor are 4 box values, an optional objectness, then num_classes class scores
+struct DecodeParams
+{
+    DecodeLayout layout{DecodeLayout::AttributesFirst};
+    BoxEncoding box_encoding{BoxEncoding::CxCyWh};
+    bool has_objectness{false};   // YOLOv5 style, score = objectness * class score
+    bool apply_sigmoid{false};    // scores are logits
+    bool normalized_boxes{false}; // box values are fractions of the model input size (SSD)
+    bool clip_boxes{true};        // clip to the source image
+    float score_threshold{0.25f};
+    int background_class{-1}; // class never reported, e.g. 0 for SSD
+};
+
+// Per-anchor class maxima of the attributes-first path, one per inference thread
+struct DecodeWorkspace
+{
+    std::vector<float> best{};    // per-anchor maximum class score
+    std::vector<int> best_class{}; // per-anchor class of that maximum
+};
+
+namespace detail
+{
+#ifdef VISION_CORE_X86_SIMD
+
+    // Running per-anchor maximum over class rows of an attributes-first output, many anchors at
+    // once. A class replaces the current best only if strictly greater, so ties keep the lowest
+    // class like argmax. Returns the number of anchors processed.
+    VISION_CORE_AVX512_WARNINGS_PUSH
+
+    VISION_CORE_TARGET("avx512f") inline size_t classMaxAvx512(const float *rows, size_t stride, int first_class, int num_classes,
+                                                                size_t count, float *best, int *best_class)
+    {
+        size_t a = 0;
+        for (; a + 32 <= count; a += 32)
+        {
+            __m512 best0 = _mm512_loadu_ps(best + a), best1 = _mm512_loadu_ps(best + a + 16);
+            __m512i class0 = _mm512_loadu_si512(best_class + a), class1 = _mm512_loadu_si512(best_class + a + 16);
+            const float *row = rows + a;
+            for (int c = first_class; c < first_class + num_classes; ++c, row += stride)
+            {
+                const __m512i id = _mm512_set1_epi32(c);
+                __m512 v0 = _mm512_loadu_ps(row), v1 = _mm512_loadu_ps(row + 16);
+                __mmask16 m0 = _mm512_cmp_ps_mask(v0, best0, _CMP_GT_OQ), m1 = _mm512_cmp_ps_mask(v1, best1, _CMP_GT_OQ);
+                best0 = _mm512_mask_mov_ps(best0, m0, v0);
+                best1 = _mm512_mask_mov_ps(best1, m1, v1);
+                class0 = _mm512_mask_mov_epi32(class0, m0, id);
+                class1 = _mm512_mask_mov_epi32(class1, m1, id);
+            }
+            _mm512_storeu_ps(best + a, best0);
+            _mm512_storeu_ps(best + a + 16, best1);
+            _mm512_storeu_si512(best_class + a, class0);
+            _mm512_storeu_si512(best_class + a + 16, class1);
+        }
+        return a;
+    }
+
+    VISION_CORE_AVX512_WARNINGS_POP
+
+    VISION_CORE_TARGET("avx2") inline size_t classMaxAvx2(const float *rows, size_t stride, int first_class, int num_classes,
+                                                           size_t count, float *best, int *best_class)
+    {
+        size_t a = 0;
+        for (; a + 16 <= count; a += 16)
+        {
+            __m256 best0 = _mm256_loadu_ps(best + a), best1 = _mm256_loadu_ps(best + a + 8);
+            __m256 class0 = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(best_class + a)));
+            __m256 class1 = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(best_class + a + 8)));
+            const float *row = rows + a;
+            for (int c = first_class; c < first_class + num_classes; ++c, row += stride)
+            {
+                const __m256 id = _mm256_castsi256_ps(_mm256_set1_epi32(c));
+                __m256 v0 = _mm256_loadu_ps(row), v1 = _mm256_loadu_ps(row + 8);
+                __m256 m0 = _mm256_cmp_ps(v0, best0, _CMP_GT_OQ), m1 = _mm256_cmp_ps(v1, best1, _CMP_GT_OQ);
+                best0 = _mm256_blendv_ps(best0, v0, m0);
+                best1 = _mm256_blendv_ps(best1, v1, m1);
+                class0 = _mm256_blendv_ps(class0, id, m0);
+                class1 = _mm256_blendv_ps(class1, id, m1);
+            }
+            _mm256_storeu_ps(best + a, best0);
+            _mm256_storeu_ps(best + a + 8, best1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(best_class + a), _mm256_castps_si256(class0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(best_class + a + 8), _mm256_castps_si256(class1));
+        }
+        return a;
+    }
+
+    VISION_CORE_TARGET("sse4.1") inline size_t classMaxSse4(const float *rows, size_t stride, int first_class, int num_classes,
+                                                             size_t count, float *best, int *best_class)
+    {
+        size_t a = 0;
+        for (; a + 8 <= count; a += 8)
+        {
+            __m128 best0 = _mm_loadu_ps(best + a), best1 = _mm_loadu_ps(best + a + 4);
+            __m128 class0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(best_class + a)));
+            __m128 class1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(best_class + a + 4)));
+            const float *row = rows + a;
+            for (int c = first_class; c < first_class + num_classes; ++c, row += stride)
+            {
+                const __m128 id = _mm_castsi128_ps(_mm_set1_epi32(c));
+                __m128 v0 = _mm_loadu_ps(row), v1 = _mm_loadu_ps(row + 4);
+                __m128 m0 = _mm_cmpgt_ps(v0, best0), m1 = _mm_cmpgt_ps(v1, best1);
+                best0 = _mm_blendv_ps(best0, v0, m0);
+                best1 = _mm_blendv_ps(best1, v1, m1);
+                class0 = _mm_blendv_ps(class0, id, m0);
+                class1 = _mm_blendv_ps(class1, id, m1);
+            }
+            _mm_storeu_ps(best + a, best0);
+            _mm_storeu_ps(best + a + 4, best1);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(best_class + a), _mm_castps_si128(class0));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(best_class + a + 4), _mm_castps_si128(class1));
+        }
+        return a;
+    }
+
+#endif
+
+    // Class rows [first_class, first_class + num_classes) start at rows, one row of stride floats per class
+    inline void classMax(const float *rows, size_t stride, int first_class, int num_classes,
+                         size_t count, float *best, int *best_class)
+    {
+        size_t a = 0;
+#ifdef VISION_CORE_X86_SIMD
+        simd::Level level = simd::level();
+        if (level == simd::Level::AVX512)
+            a = classMaxAvx512(rows, stride, first_class, num_classes, count, best, best_class);
+        else if (level == simd::Level::AVX2)
+            a = classMaxAvx2(rows, stride, first_class, num_classes, count, best, best_class);
+        else if (level == simd::Level::SSE4)
+            a = classMaxSse4(rows, stride, first_class, num_classes, count, best, best_class);
+#endif
+        for (; a < count; ++a)
+        {
+            const float *value = rows + a;
+            for (int c = first_class; c < first_class + num_classes; ++c, value += stride)
+            {
+                if (*value > best[a])
+                {
+                    best[a] = *value;
+                    best_class[a] = c;
+                }
+            }
+        }
+    }
+
+    inline float decodeSigmoid(float x)
+    {
+        return 1.f / (1.f + std::exp(-x));
+    }
+
+    // Raw box values of one anchor to a box in source image pixels
+    inline cv::Rect2f decodeBox(float b0, float b1, float b2, float b3, const DecodeParams &params, const LetterboxInfo &info)
+    {
+        if (params.normalized_boxes)
+        {
+            const float width = static_cast<float>(info.shape.width), height = static_cast<float>(info.shape.height);
+            b0 *= width;
+            b1 *= height;
+            b2 *= width;
+            b3 *= height;
+        }
+
+        cv::Rect2f box = params.box_encoding == BoxEncoding::CxCyWh
+                             ? cv::Rect2f(b0 - 0.5f * b2, b1 - 0.5f * b3, b2, b3)
+                             : cv::Rect2f(b0, b1, b2 - b0, b3 - b1);
+        box = info.toSource(box);
+
+        if (params.clip_boxes && !info.source.empty())
+        {
+            const float x0 = std::clamp(box.x, 0.f, static_cast<float>(info.source.width));
+            const float y0 = std::clamp(box.y, 0.f, static_cast<float>(info.source.height));
+            const float x1 = std::clamp(box.x + box.width, 0.f, static_cast<float>(info.source.width));
+            const float y1 = std::clamp(box.y + box.height, 0.f, static_cast<float>(info.source.height));
+            box = cv::Rect2f(x0, y0, x1 - x0, y1 - y0);
+        }
+        return box;
+    }
+
+} // namespace detail
+
+// Append every anchor scoring at least score_threshold in one image's raw output to batch, with
+// absolute boxes in source image pixels (sizes set to info.source) and the best class. The class
+// maximum is found with SIMD for many anchors at once (attributes-first) or per contiguous row
+// (anchors-first), and boxes are only decoded for anchors passing that prefilter.
+// Pass a default LetterboxInfo for outputs already in image coordinates. Returns the number of rows added.
+inline size_t decodeDetections(const float *output, size_t num_anchors, int num_classes, const DecodeParams &params,
+                               const LetterboxInfo &info, DecodeWorkspace &ws, DetectionBatch &batch, int64_t frame_id = -1)
+{
+    if (num_classes <= 0)
+        throw std::invalid_argument("Decoding needs at least one class");
+    if (params.background_class < -1 || params.background_class >= num_classes)
+        throw std::invalid_argument("background_class must be -1 or a class id");
+    if (params.background_class >= 0 && num_classes == 1)
+        throw std::invalid_argument("Decoding needs at least one class besides the background");
+    if (params.normalized_boxes && info.shape.empty())
+        throw std::invalid_argument("Normalized boxes need the model input size in LetterboxInfo::shape");
+
+    const size_t first_score = params.has_objectness ? 5 : 4;
+    const size_t num_attributes = first_score + static_cast<size_t>(num_classes);
+    const int background = params.background_class;
+    const size_t start = batch.size();
+
+    // Sigmoid is monotonic, so logits are compared against the logit of the threshold. With objectness
+    // both factors are at most one, so each must pass the threshold on its own.
+    const float threshold = params.score_threshold;
+    float prefilter = threshold;
+    if (params.apply_sigmoid)
+    {
+        prefilter = threshold <= 0.f   ? -std::numeric_limits<float>::infinity()
+                    : threshold >= 1.f ? std::numeric_limits<float>::infinity()
+                                       : std::log(threshold / (1.f - threshold));
+    }
+    auto score = [&params](float value)
+    {
+        return params.apply_sigmoid ? detail::decodeSigmoid(value) : value;
+    };
+
+    auto emit = [&](int class_id, float confidence, float b0, float b1, float b2, float b3)
+    {
+        batch.emplace_back(detail::decodeBox(b0, b1, b2, b3, params, info), confidence, class_id, frame_id, info.source);
+    };
+
+    if (params.layout == DecodeLayout::AttributesFirst)
+    {
+        ws.best.assign(num_anchors, -std::numeric_limits<float>::infinity());
+        ws.best_class.assign(num_anchors, -1);
+
+        const float *classes = output + first_score * num_anchors;
+        const int before = background >= 0 ? background : num_classes;
+        detail::classMax(classes, num_anchors, 0, before, num_anchors, ws.best.data(), ws.best_class.data());
+        if (before + 1 < num_classes)
+        {
+            detail::classMax(classes + (before + 1) * num_anchors, num_anchors, before + 1, num_classes - before - 1,
+                             num_anchors, ws.best.data(), ws.best_class.data());
+        }
+
+        const float *objectness = output + 4 * num_anchors;
+        for (size_t a = 0; a < num_anchors; ++a)
+        {
+            if (!(ws.best[a] >= prefilter))
+                continue;
+
+            float confidence = score(ws.best[a]);
+            if (params.has_objectness)
+            {
+                if (!(objectness[a] >= prefilter))
+                    continue;
+                confidence *= score(objectness[a]);
+            }
+            if (confidence < threshold)
+                continue;
+
+            emit(ws.best_class[a], confidence, output[a], output[num_anchors + a], output[2 * num_anchors + a], output[3 * num_anchors + a]);
+        }
+        return batch.size() - start;
+    }
+
+    for (size_t a = 0; a < num_anchors; ++a)
+    {
+        const float *row = output + a * num_attributes;
+        float objectness = 1.f;
+        if (params.has_objectness)
+        {
+            if (!(row[4] >= prefilter))
+                continue;
+            objectness = score(row[4]);
+        }
+
+        // SIMD maximum over the class scores first, argmax only for anchors that pass
+        const float *classes = row + first_score;
+        float best = -std::numeric_limits<float>::infinity();
+        if (background != 0)
+            best = vector_ops::max(classes, static_cast<size_t>(background > 0 ? background : num_classes));
+        if (background >= 0 && background + 1 < num_classes)
+            best = std::max(best, vector_ops::max(classes + background + 1, static_cast<size_t>(num_classes - background - 1)));
+        if (!(best >= prefilter))
+            continue;
+
+        const float confidence = score(best) * objectness;
+        if (confidence < threshold)
+            continue;
+
+        // No match only for NaN scores, reported as class -1 like the attributes-first path
+        int class_id = 0;
+        while (class_id < num_classes && (classes[class_id] != best || class_id == background))
+            ++class_id;
+        if (class_id == num_classes)
+            class_id = -1;
+
+        emit(class_id, confidence, row[0], row[1], row[2], row[3]);
+    }
+    return batch.size() - start;
+}
+
+// Decode each image of a batched output ([batch][...] with the same per-image layout) into its own batch
+inline void decodeDetections(const float *output, size_t batch_size, size_t num_anchors, int num_classes,
+                             const DecodeParams &params, const std::vector<LetterboxInfo> &infos,
+                             DecodeWorkspace &ws, std::vector<DetectionBatch> &batches)
+{
+    if (infos.size() != batch_size)
+        throw std::invalid_argument("One LetterboxInfo is needed per image");
+
+    const size_t image_size = num_anchors * ((params.has_objectness ? 5 : 4) + static_cast<size_t>(std::max(num_classes, 0)));
+    batches.resize(batch_size);
+    for (size_t i = 0; i < batch_size; ++i)
+    {
+        batches[i].clear();
+        decodeDetections(output + i * image_size, num_anchors, num_classes, params, infos[i], ws, batches[i]);
+    }
+}
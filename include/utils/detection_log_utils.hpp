@@ -0,0 +1,504 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection_batch.hpp>
+#include <utils/file_utils.hpp>
+#include <utils/mot_utils.hpp>
+
+// Binary columnar detection log, one chunk per run of rows sharing a frame_id.
+// Values are stored in native byte order, readers reject files written with another one.
+//
+//   FileHeader
+//   chunk*:  ChunkHeader, then 16-byte aligned columns
+//            bboxes, confidences, class_ids, track_ids, positions, sizes,
+//            [features: rows x feature_dim], [MaskHeader per row, mask bytes]
+//   index:   IndexEntry per chunk, sorted by frame_id
+//   Footer
+namespace detail
+{
+    constexpr char DETECTION_LOG_MAGIC[8] = {'V', 'C', 'D', 'L', 'O', 'G', '0', '1'};
+    constexpr uint32_t DETECTION_LOG_BYTE_ORDER = 0x01020304;
+    constexpr uint32_t DETECTION_LOG_HAS_MASKS = 1;
+
+    struct DetectionLogHeader
+    {
+        char magic[8];
+        uint32_t byte_order;
+        uint32_t version;
+        uint64_t reserved[2];
+    };
+
+    struct DetectionLogChunkHeader
+    {
+        int64_t frame_id;
+        uint64_t rows;
+        uint32_t feature_dim;
+        uint32_t flags;
+        uint64_t mask_bytes;
+        uint64_t chunk_bytes;
+        uint64_t reserved;
+    };
+
+    struct DetectionLogMaskHeader
+    {
+        int32_t rows; // 0 when the row has no mask
+        int32_t cols;
+        int32_t type;
+        int32_t reserved;
+        uint64_t offset; // into the chunk mask bytes
+    };
+
+    struct DetectionLogIndexEntry
+    {
+        int64_t frame_id;
+        uint64_t offset;
+    };
+
+    struct DetectionLogFooter
+    {
+        uint64_t index_offset;
+        uint64_t chunk_count;
+        uint64_t row_count;
+        char magic[8];
+    };
+
+    constexpr size_t alignLog(size_t offset)
+    {
+        return (offset + 15) & ~size_t{15};
+    }
+
+    // Column offsets relative to the start of a chunk
+    struct DetectionLogLayout
+    {
+        size_t bboxes, confidences, class_ids, track_ids, positions, sizes;
+        size_t features, mask_headers, mask_data, end;
+
+        DetectionLogLayout(size_t rows, size_t feature_dim, bool has_masks, size_t mask_bytes)
+        {
+            bboxes = alignLog(sizeof(DetectionLogChunkHeader));
+            confidences = alignLog(bboxes + rows * sizeof(cv::Rect2f));
+            class_ids = alignLog(confidences + rows * sizeof(float));
+            track_ids = alignLog(class_ids + rows * sizeof(int));
+            positions = alignLog(track_ids + rows * sizeof(int64_t));
+            sizes = alignLog(positions + rows * sizeof(cv::Point3f));
+            features = alignLog(sizes + rows * sizeof(cv::Size));
+            mask_headers = alignLog(features + rows * feature_dim * sizeof(float));
+            mask_data = alignLog(mask_headers + (has_masks ? rows * sizeof(DetectionLogMaskHeader) : 0));
+            end = alignLog(mask_data + mask_bytes);
+        }
+    };
+
+    inline size_t maskBytes(const cv::Mat &mask)
+    {
+        return mask.empty() ? 0 : mask.total() * mask.elemSize();
+    }
+} // namespace detail
+
+// Zero-copy view of one chunk of a memory-mapped detection log.
+// Pointers stay valid while the DetectionLogReader is alive and must not be written through.
+struct DetectionLogFrame
+{
+    int64_t frame_id{-1};
+    size_t size{0};
+    size_t feature_dim{0};
+
+    const cv::Rect2f *bboxes{nullptr};
+    const float *confidences{nullptr};
+    const int *class_ids{nullptr};
+    const int64_t *track_ids{nullptr};
+    const cv::Point3f *positions{nullptr};
+    const cv::Size *sizes{nullptr};
+    const float *features{nullptr}; // nullptr when feature_dim is 0
+
+    const detail::DetectionLogMaskHeader *mask_headers{nullptr}; // nullptr when no row has a mask
+    const char *mask_data{nullptr};
+
+    const float *feature(size_t i) const { return features + i * feature_dim; }
+
+    // Read-only header over the mapped mask bytes, empty when row i has no mask
+    cv::Mat mask(size_t i) const
+    {
+        if (mask_headers == nullptr || mask_headers[i].rows == 0)
+            return cv::Mat();
+
+        const auto &header = mask_headers[i];
+        return cv::Mat(header.rows, header.cols, header.type, const_cast<char *>(mask_data + header.offset));
+    }
+
+    // Copy the rows into batch, masks are deep copies so batch outlives the reader
+    void appendTo(DetectionBatch &batch) const
+    {
+        if (size == 0)
+            return;
+
+        if (batch.feature_dim == 0 && feature_dim != 0)
+        {
+            batch.feature_dim = feature_dim;
+            batch.features.assign(batch.size() * feature_dim, 0.f);
+        }
+        else if (feature_dim != 0 && feature_dim != batch.feature_dim)
+        {
+            throw std::invalid_argument("Feature size does not match batch feature dimension");
+        }
+
+        batch.bboxes.insert(batch.bboxes.end(), bboxes, bboxes + size);
+        batch.confidences.insert(batch.confidences.end(), confidences, confidences + size);
+        batch.class_ids.insert(batch.class_ids.end(), class_ids, class_ids + size);
+        batch.frame_ids.insert(batch.frame_ids.end(), size, frame_id);
+        batch.track_ids.insert(batch.track_ids.end(), track_ids, track_ids + size);
+        batch.positions.insert(batch.positions.end(), positions, positions + size);
+        batch.sizes.insert(batch.sizes.end(), sizes, sizes + size);
+
+        if (feature_dim != 0)
+            batch.features.insert(batch.features.end(), features, features + size * feature_dim);
+        else
+            batch.features.resize(batch.features.size() + size * batch.feature_dim, 0.f);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            cv::Mat m = mask(i);
+            if (m.empty())
+            {
+                batch.mask_ids.push_back(-1);
+            }
+            else
+            {
+                batch.mask_ids.push_back(static_cast<int>(batch.masks.size()));
+                batch.masks.push_back(m.clone());
+            }
+        }
+    }
+};
+
+// Contiguous run of frames returned by DetectionLogReader::range
+struct DetectionLogRange
+{
+    const DetectionLogFrame *first{nullptr};
+    const DetectionLogFrame *last{nullptr};
+
+    const DetectionLogFrame *begin() const { return first; }
+    const DetectionLogFrame *end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// Streams batches into a detection log, the index is written by close()
+class DetectionLogWriter
+{
+public:
+    explicit DetectionLogWriter(const std::string &path)
+        : file_(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!file_)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        detail::DetectionLogHeader header{};
+        std::memcpy(header.magic, detail::DETECTION_LOG_MAGIC, sizeof(header.magic));
+        header.byte_order = detail::DETECTION_LOG_BYTE_ORDER;
+        header.version = 1;
+        writeRaw(&header, sizeof(header));
+    }
+
+    DetectionLogWriter(const DetectionLogWriter &) = delete;
+    DetectionLogWriter &operator=(const DetectionLogWriter &) = delete;
+
+    ~DetectionLogWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    // Consecutive rows with the same frame_id become one chunk
+    void write(const DetectionBatch &batch)
+    {
+        if (closed_)
+            throw std::runtime_error("DetectionLogWriter is closed");
+
+        size_t begin = 0;
+        while (begin < batch.size())
+        {
+            size_t end = begin + 1;
+            while (end < batch.size() && batch.frame_ids[end] == batch.frame_ids[begin])
+                ++end;
+            writeChunk(batch, begin, end);
+            begin = end;
+        }
+    }
+
+    void close()
+    {
+        if (closed_)
+            return;
+        closed_ = true;
+
+        std::stable_sort(index_.begin(), index_.end(), [](const auto &a, const auto &b)
+                         { return a.frame_id < b.frame_id; });
+
+        detail::DetectionLogFooter footer{};
+        footer.index_offset = offset_;
+        footer.chunk_count = index_.size();
+        footer.row_count = rows_;
+        std::memcpy(footer.magic, detail::DETECTION_LOG_MAGIC, sizeof(footer.magic));
+
+        writeRaw(index_.data(), index_.size() * sizeof(detail::DetectionLogIndexEntry));
+        writeRaw(&footer, sizeof(footer));
+        file_.close();
+        if (!file_)
+            throw std::runtime_error("Failed to write detection log");
+    }
+
+private:
+    void writeChunk(const DetectionBatch &batch, size_t begin, size_t end)
+    {
+        const size_t rows = end - begin;
+
+        bool has_masks = false;
+        size_t mask_bytes = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const cv::Mat &m = batch.mask(i);
+            has_masks |= !m.empty();
+            mask_bytes += detail::maskBytes(m);
+        }
+
+        const detail::DetectionLogLayout layout(rows, batch.feature_dim, has_masks, mask_bytes);
+        const size_t chunk_offset = offset_;
+
+        detail::DetectionLogChunkHeader header{};
+        header.frame_id = batch.frame_ids[begin];
+        header.rows = rows;
+        header.feature_dim = static_cast<uint32_t>(batch.feature_dim);
+        header.flags = has_masks ? detail::DETECTION_LOG_HAS_MASKS : 0;
+        header.mask_bytes = mask_bytes;
+        header.chunk_bytes = layout.end;
+        writeRaw(&header, sizeof(header));
+
+        writeColumn(chunk_offset + layout.bboxes, batch.bboxes.data() + begin, rows * sizeof(cv::Rect2f));
+        writeColumn(chunk_offset + layout.confidences, batch.confidences.data() + begin, rows * sizeof(float));
+        writeColumn(chunk_offset + layout.class_ids, batch.class_ids.data() + begin, rows * sizeof(int));
+        writeColumn(chunk_offset + layout.track_ids, batch.track_ids.data() + begin, rows * sizeof(int64_t));
+        writeColumn(chunk_offset + layout.positions, batch.positions.data() + begin, rows * sizeof(cv::Point3f));
+        writeColumn(chunk_offset + layout.sizes, batch.sizes.data() + begin, rows * sizeof(cv::Size));
+        writeColumn(chunk_offset + layout.features, batch.feature(begin), rows * batch.feature_dim * sizeof(float));
+
+        if (has_masks)
+        {
+            pad(chunk_offset + layout.mask_headers);
+            uint64_t mask_offset = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const cv::Mat &m = batch.mask(i);
+                detail::DetectionLogMaskHeader mask_header{};
+                if (!m.empty())
+                {
+                    mask_header.rows = m.rows;
+                    mask_header.cols = m.cols;
+                    mask_header.type = m.type();
+                    mask_header.offset = mask_offset;
+                    mask_offset += detail::maskBytes(m);
+                }
+                writeRaw(&mask_header, sizeof(mask_header));
+            }
+
+            pad(chunk_offset + layout.mask_data);
+            for (size_t i = begin; i < end; ++i)
+            {
+                const cv::Mat &m = batch.mask(i);
+                for (int r = 0; r < m.rows && !m.empty(); ++r)
+                    writeRaw(m.ptr(r), static_cast<size_t>(m.cols) * m.elemSize());
+            }
+        }
+        pad(chunk_offset + layout.end);
+
+        index_.push_back({header.frame_id, chunk_offset});
+        rows_ += rows;
+    }
+
+    void writeColumn(size_t offset, const void *data, size_t bytes)
+    {
+        pad(offset);
+        writeRaw(data, bytes);
+    }
+
+    void pad(size_t offset)
+    {
+        static const char zeros[16] = {};
+        writeRaw(zeros, offset - offset_);
+    }
+
+    void writeRaw(const void *data, size_t bytes)
+    {
+        if (bytes == 0)
+            return;
+        file_.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        if (!file_)
+            throw std::runtime_error("Failed to write detection log");
+        offset_ += bytes;
+    }
+
+    std::ofstream file_;
+    std::vector<detail::DetectionLogIndexEntry> index_{};
+    size_t offset_{0};
+    size_t rows_{0};
+    bool closed_{false};
+};
+
+// Memory-maps a detection log and serves zero-copy views of its frames, sorted by frame_id
+class DetectionLogReader
+{
+public:
+    explicit DetectionLogReader(const std::string &path)
+        : file_(path)
+    {
+        const char *data = file_.data();
+        const size_t size = file_.size();
+
+        detail::DetectionLogHeader header;
+        detail::DetectionLogFooter footer;
+        if (size < sizeof(header) + sizeof(footer))
+            throw std::runtime_error("Invalid detection log: " + path);
+
+        std::memcpy(&header, data, sizeof(header));
+        std::memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+        if (std::memcmp(header.magic, detail::DETECTION_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+            std::memcmp(footer.magic, detail::DETECTION_LOG_MAGIC, sizeof(footer.magic)) != 0)
+            throw std::runtime_error("Invalid detection log: " + path);
+        if (header.byte_order != detail::DETECTION_LOG_BYTE_ORDER || header.version != 1)
+            throw std::runtime_error("Unsupported detection log: " + path);
+        if (footer.index_offset > size - sizeof(footer) ||
+            footer.chunk_count > (size - sizeof(footer) - footer.index_offset) / sizeof(detail::DetectionLogIndexEntry))
+            throw std::runtime_error("Corrupted detection log index: " + path);
+
+        const auto *index = reinterpret_cast<const detail::DetectionLogIndexEntry *>(data + footer.index_offset);
+        frames_.reserve(footer.chunk_count);
+        for (size_t c = 0; c < footer.chunk_count; ++c)
+        {
+            const size_t offset = index[c].offset;
+            if (offset < sizeof(header) || offset + sizeof(detail::DetectionLogChunkHeader) > footer.index_offset)
+                throw std::runtime_error("Corrupted detection log chunk: " + path);
+
+            const auto *chunk_header = reinterpret_cast<const detail::DetectionLogChunkHeader *>(data + offset);
+            const bool has_masks = chunk_header->flags & detail::DETECTION_LOG_HAS_MASKS;
+            const size_t row_bytes = sizeof(cv::Rect2f) + chunk_header->feature_dim * sizeof(float);
+            if (chunk_header->rows > size / row_bytes || chunk_header->mask_bytes > size)
+                throw std::runtime_error("Corrupted detection log chunk: " + path);
+            const detail::DetectionLogLayout layout(chunk_header->rows, chunk_header->feature_dim, has_masks,
+                                                    chunk_header->mask_bytes);
+            if (layout.end != chunk_header->chunk_bytes || offset + layout.end > footer.index_offset)
+                throw std::runtime_error("Corrupted detection log chunk: " + path);
+
+            const char *chunk = data + offset;
+            DetectionLogFrame frame;
+            frame.frame_id = chunk_header->frame_id;
+            frame.size = chunk_header->rows;
+            frame.feature_dim = chunk_header->feature_dim;
+            frame.bboxes = reinterpret_cast<const cv::Rect2f *>(chunk + layout.bboxes);
+            frame.confidences = reinterpret_cast<const float *>(chunk + layout.confidences);
+            frame.class_ids = reinterpret_cast<const int *>(chunk + layout.class_ids);
+            frame.track_ids = reinterpret_cast<const int64_t *>(chunk + layout.track_ids);
+            frame.positions = reinterpret_cast<const cv::Point3f *>(chunk + layout.positions);
+            frame.sizes = reinterpret_cast<const cv::Size *>(chunk + layout.sizes);
+            frame.features = frame.feature_dim ? reinterpret_cast<const float *>(chunk + layout.features) : nullptr;
+            if (has_masks)
+            {
+                frame.mask_headers = reinterpret_cast<const detail::DetectionLogMaskHeader *>(chunk + layout.mask_headers);
+                frame.mask_data = chunk + layout.mask_data;
+                for (size_t i = 0; i < frame.size; ++i)
+                {
+                    const auto &mask = frame.mask_headers[i];
+                    const size_t bytes = CV_ELEM_SIZE(mask.type) * static_cast<size_t>(mask.rows) * mask.cols;
+                    if (mask.rows < 0 || mask.cols < 0 || mask.offset + bytes > chunk_header->mask_bytes)
+                        throw std::runtime_error("Corrupted detection log mask: " + path);
+                }
+            }
+            frames_.push_back(frame);
+            rows_ += frame.size;
+        }
+    }
+
+    // Number of chunks (frames) and detections in the log
+    size_t size() const { return frames_.size(); }
+    bool empty() const { return frames_.empty(); }
+    size_t rows() const { return rows_; }
+
+    const DetectionLogFrame &operator[](size_t i) const { return frames_[i]; }
+    const DetectionLogFrame *begin() const { return frames_.data(); }
+    const DetectionLogFrame *end() const { return frames_.data() + frames_.size(); }
+
+    // Frames with first_frame_id <= frame_id <= last_frame_id, found by binary search
+    DetectionLogRange range(int64_t first_frame_id, int64_t last_frame_id) const
+    {
+        auto first = std::lower_bound(frames_.begin(), frames_.end(), first_frame_id, [](const DetectionLogFrame &frame, int64_t id)
+                                      { return frame.frame_id < id; });
+        auto last = std::upper_bound(first, frames_.end(), last_frame_id, [](int64_t id, const DetectionLogFrame &frame)
+                                     { return id < frame.frame_id; });
+        return {frames_.data() + (first - frames_.begin()), frames_.data() + (last - frames_.begin())};
+    }
+
+    DetectionBatch read(int64_t first_frame_id, int64_t last_frame_id) const
+    {
+        DetectionBatch batch;
+        for (const auto &frame : range(first_frame_id, last_frame_id))
+            frame.appendTo(batch);
+        return batch;
+    }
+
+private:
+    MappedFile file_;
+    std::vector<DetectionLogFrame> frames_{};
+    size_t rows_{0};
+};
+
+// Convert a MOTChallenge text file, malformed lines are reported in errors and skipped
+inline size_t convertMotToDetectionLog(const std::string &mot_path, const std::string &log_path,
+                                       std::vector<MotParseError> &errors)
+{
+    DetectionBatch batch;
+    loadMot(mot_path, batch, errors);
+
+    DetectionLogWriter writer(log_path);
+    writer.write(batch);
+    writer.close();
+    return batch.size();
+}
+
+// Convert a detection log back to MOTChallenge text, in frame_id order
+inline size_t convertDetectionLogToMot(const std::string &log_path, const std::string &mot_path,
+                                       const MotWriterParams &params = {})
+{
+    DetectionLogReader reader(log_path);
+    MotWriter writer(mot_path, params);
+
+    MotRecord record;
+    for (const auto &frame : reader)
+    {
+        record.frame_id = frame.frame_id;
+        for (size_t i = 0; i < frame.size; ++i)
+        {
+            record.track_id = frame.track_ids[i];
+            record.x = frame.bboxes[i].x;
+            record.y = frame.bboxes[i].y;
+            record.width = frame.bboxes[i].width;
+            record.height = frame.bboxes[i].height;
+            record.confidence = frame.confidences[i];
+            record.pos_x = frame.positions[i].x;
+            record.pos_y = frame.positions[i].y;
+            record.pos_z = frame.positions[i].z;
+            writer.write(record);
+        }
+    }
+    writer.close();
+    return reader.rows();
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include <opencv2/opencv.hpp>
 
 inline cv::Rect getAbsoluteBbox(const cv::Rect2f &rel_bbox, cv::Size size)
@@ -13,64 +17,210 @@ inline cv::Rect getAbsoluteBbox(const cv::Rect2f &rel_bbox, cv::Size size)
     return abs_bbox & cv::Rect(0, 0, size.width, size.height);
 }
 
+namespace detail
+{
+    // Half-pixel (cv::INTER_LINEAR) column mapping: output column x samples source position
+    // (x + 0.5) * scale + offset - 0.5. Fills, for count output columns from first, the source columns
+    // left and right of that position (clamped to source_width) and the weight of the right one.
+    inline void bilinearColumns(int first, int count, float scale, float offset, int source_width, int *left, int *right, float *weight)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const float source_x = std::max((first + i + 0.5f) * scale + offset - 0.5f, 0.f);
+            const int x0 = std::min(static_cast<int>(source_x), source_width - 1);
+            left[i] = x0;
+            right[i] = std::min(x0 + 1, source_width - 1);
+            weight[i] = source_x - static_cast<float>(x0);
+        }
+    }
+
+    // Scratch reused across calls on the same thread
+    struct MaskResizeScratch
+    {
+        std::vector<int> x0{}, x1{};  // source columns left and right of each output column
+        std::vector<float> x_weight{}; // weight of the right column
+        std::vector<float> row{};      // one resized output row
+    };
+
+    inline MaskResizeScratch &maskResizeScratch()
+    {
+        thread_local MaskResizeScratch scratch;
+        return scratch;
+    }
+
+    template <typename T, typename Fn>
+    inline void resizeMaskRows(const cv::Mat &mask, cv::Size size, const cv::Rect &region, MaskResizeScratch &scratch, Fn &fn)
+    {
+        scratch.x0.resize(region.width);
+        scratch.x1.resize(region.width);
+        scratch.x_weight.resize(region.width);
+        scratch.row.resize(region.width);
+        bilinearColumns(region.x, region.width, static_cast<float>(mask.cols) / size.width, 0.f, mask.cols,
+                        scratch.x0.data(), scratch.x1.data(), scratch.x_weight.data());
+
+        const float inv_y = static_cast<float>(mask.rows) / size.height;
+        for (int y = region.y; y < region.y + region.height; ++y)
+        {
+            const float source_y = std::max((y + 0.5f) * inv_y - 0.5f, 0.f);
+            const int y0 = std::min(static_cast<int>(source_y), mask.rows - 1);
+            const float y_weight = source_y - static_cast<float>(y0);
+            const T *top = mask.ptr<T>(y0);
+            const T *bottom = mask.ptr<T>(std::min(y0 + 1, mask.rows - 1));
+            for (int i = 0; i < region.width; ++i)
+            {
+                const float t0 = static_cast<float>(top[scratch.x0[i]]), t1 = static_cast<float>(top[scratch.x1[i]]);
+                const float b0 = static_cast<float>(bottom[scratch.x0[i]]), b1 = static_cast<float>(bottom[scratch.x1[i]]);
+                const float t = t0 + (t1 - t0) * scratch.x_weight[i];
+                const float b = b0 + (b1 - b0) * scratch.x_weight[i];
+                scratch.row[i] = t + (b - t) * y_weight;
+            }
+            fn(y, scratch.row.data());
+        }
+    }
+
+    // Bilinear resize of a single-channel mask to size with half-pixel centers (as cv::INTER_LINEAR),
+    // calling fn(y, values) for the rows of region (in resized coordinates) with its region.width
+    // resized values, without materializing the resized mask. Depths other than 8U and 32F are converted first.
+    template <typename Fn>
+    inline void resizeMaskRows(const cv::Mat &mask, cv::Size size, const cv::Rect &region, Fn &&fn)
+    {
+        if (mask.empty() || region.empty())
+            return;
+        if (mask.channels() != 1)
+            throw std::invalid_argument("Masks must have a single channel");
+
+        MaskResizeScratch &scratch = maskResizeScratch();
+        if (mask.depth() == CV_8U)
+        {
+            resizeMaskRows<uchar>(mask, size, region, scratch, fn);
+        }
+        else if (mask.depth() == CV_32F)
+        {
+            resizeMaskRows<float>(mask, size, region, scratch, fn);
+        }
+        else
+        {
+            cv::Mat converted;
+            mask.convertTo(converted, CV_32F);
+            resizeMaskRows<float>(converted, size, region, scratch, fn);
+        }
+    }
+} // namespace detail
+
+// Mask resized to size and thresholded to 0 / 1 (values above threshold) in a single CV_8U allocation
 inline cv::Mat getAbsoluteMask(const cv::Mat &rel_mask, cv::Size size, float threshold = 0.5)
 {
     if (rel_mask.empty())
         return cv::Mat();
 
-    cv::Mat resized_mask, binary_mask;
-    cv::resize(rel_mask, resized_mask, size, cv::INTER_LINEAR);
-    cv::threshold(resized_mask, binary_mask, threshold, 1.0, cv::THRESH_BINARY);
-    binary_mask.convertTo(binary_mask, CV_8U); // Convert to 8-bit unsigned
+    cv::Mat binary_mask(size, CV_8U);
+    detail::resizeMaskRows(rel_mask, size, cv::Rect(cv::Point(), size), [&](int y, const float *values)
+                           {
+                               uchar *out = binary_mask.ptr<uchar>(y);
+                               for (int x = 0; x < size.width; ++x)
+                                   out[x] = values[x] > threshold ? 1 : 0;
+                           });
     return binary_mask;
 }
 
-inline cv::Mat letterbox(const cv::Mat &input, cv::Size new_shape, cv::Scalar color, bool auto_size, bool scale_fill, bool scaleup, int stride)
+struct LetterboxParams
 {
-    // Resize and pad image while meeting stride-multiple constraints
-    cv::Mat out(new_shape, CV_8UC3, color);
-    cv::Size shape = input.size(); // current shape [height, width]
+    cv::Size new_shape{640, 640};
+    cv::Scalar color{114, 114, 114}; // padding color, in the input channel order
+    bool auto_size{false};           // pad only up to the next multiple of stride
+    bool scale_fill{false};          // stretch to new_shape without padding
+    bool scaleup{true};              // allow enlarging small inputs
+    int stride{32};
+};
+
+// Where the input lands inside the letterboxed image, and how to map coordinates back
+struct LetterboxInfo
+{
+    cv::Size source{};   // input size
+    cv::Size resized{};  // size of the resized input inside the output
+    cv::Size shape{};    // output size, resized plus padding
+    float scale_x{1.f};  // output pixels per input pixel
+    float scale_y{1.f};
+    int top{0}, bottom{0}, left{0}, right{0}; // padding
+
+    cv::Point2f toSource(const cv::Point2f &point) const
+    {
+        return cv::Point2f((point.x - left) / scale_x, (point.y - top) / scale_y);
+    }
+
+    // Map a box in absolute output coordinates back to the input image
+    cv::Rect2f toSource(const cv::Rect2f &box) const
+    {
+        return cv::Rect2f((box.x - left) / scale_x, (box.y - top) / scale_y, box.width / scale_x, box.height / scale_y);
+    }
+};
+
+inline LetterboxInfo getLetterboxInfo(cv::Size shape, const LetterboxParams &params)
+{
+    if (shape.empty() || params.new_shape.empty())
+        throw std::invalid_argument("Letterbox input and output sizes must be positive");
+
+    const cv::Size new_shape = params.new_shape;
 
     // Scale ratio (new / old)
     float r = std::min(static_cast<float>(new_shape.height) / shape.height, static_cast<float>(new_shape.width) / shape.width);
-    if (!scaleup)
+    if (!params.scaleup)
     {
         r = std::min(r, 1.0f);
     }
 
     // Compute padding
-    std::pair<float, float> ratio(r, r); // width, height ratios
-    cv::Size new_unpad(static_cast<int>(std::round(shape.width * r)), static_cast<int>(std::round(shape.height * r)));
-    float dw = static_cast<float>(new_shape.width - new_unpad.width);
-    float dh = static_cast<float>(new_shape.height - new_unpad.height); // wh padding
+    LetterboxInfo info;
+    info.source = shape;
+    info.scale_x = info.scale_y = r;
+    info.resized = cv::Size(static_cast<int>(std::round(shape.width * r)), static_cast<int>(std::round(shape.height * r)));
+    float dw = static_cast<float>(new_shape.width - info.resized.width);
+    float dh = static_cast<float>(new_shape.height - info.resized.height); // wh padding
 
-    if (auto_size)
+    if (params.auto_size)
     {
-        dw = std::fmod(dw, static_cast<float>(stride));
-        dh = std::fmod(dh, static_cast<float>(stride)); // wh padding
+        dw = std::fmod(dw, static_cast<float>(params.stride));
+        dh = std::fmod(dh, static_cast<float>(params.stride)); // wh padding
     }
-    else if (scale_fill)
+    else if (params.scale_fill)
     {
         dw = 0.0;
         dh = 0.0;
-        new_unpad = new_shape;
-        ratio = std::make_pair(static_cast<float>(new_shape.width) / shape.width, static_cast<float>(new_shape.height) / shape.height); // width, height ratios
+        info.resized = new_shape;
+        info.scale_x = static_cast<float>(new_shape.width) / shape.width;
+        info.scale_y = static_cast<float>(new_shape.height) / shape.height;
     }
 
     dw /= 2; // divide padding into 2 sides
     dh /= 2;
 
-    if (shape != new_unpad)
-    {
-        cv::resize(input, out, new_unpad, 0, 0, cv::INTER_LINEAR);
-    }
+    info.top = static_cast<int>(std::round(dh - 0.1f));
+    info.bottom = static_cast<int>(std::round(dh + 0.1f));
+    info.left = static_cast<int>(std::round(dw - 0.1f));
+    info.right = static_cast<int>(std::round(dw + 0.1f));
+    info.shape = cv::Size(info.resized.width + info.left + info.right, info.resized.height + info.top + info.bottom);
+    return info;
+}
 
-    int top = static_cast<int>(std::round(dh - 0.1f));
-    int bottom = static_cast<int>(std::round(dh + 0.1f));
-    int left = static_cast<int>(std::round(dw - 0.1f));
-    int right = static_cast<int>(std::round(dw + 0.1f));
+inline cv::Mat letterbox(const cv::Mat &input, const LetterboxParams &params, LetterboxInfo *info = nullptr)
+{
+    // Resize and pad image while meeting stride-multiple constraints
+    const LetterboxInfo layout = getLetterboxInfo(input.size(), params);
+    if (info)
+        *info = layout;
 
-    cv::copyMakeBorder(out, out, top, bottom, left, right, cv::BORDER_CONSTANT, color); // add border
+    cv::Mat resized = input;
+    if (input.size() != layout.resized)
+    {
+        cv::resize(input, resized, layout.resized, 0, 0, cv::INTER_LINEAR);
+    }
 
+    cv::Mat out;
+    cv::copyMakeBorder(resized, out, layout.top, layout.bottom, layout.left, layout.right, cv::BORDER_CONSTANT, params.color); // add border
     return out;
-}
\ No newline at end of file
+}
+
+inline cv::Mat letterbox(const cv::Mat &input, cv::Size new_shape, cv::Scalar color, bool auto_size, bool scale_fill, bool scaleup, int stride)
+{
+    return letterbox(input, LetterboxParams{new_shape, color, auto_size, scale_fill, scaleup, stride});
+}
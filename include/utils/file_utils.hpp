@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define VISION_CORE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Read-only view of a whole file, memory-mapped where the platform supports it
+// and read into an owned buffer otherwise
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string &path)
+    {
+        open(path);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+    {
+        swap(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    void open(const std::string &path)
+    {
+        close();
+#ifdef VISION_CORE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: " + path);
+        }
+
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0)
+        {
+            void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED)
+            {
+                ::close(fd);
+                size_ = 0;
+                throw std::runtime_error("Failed to map file: " + path);
+            }
+            ::madvise(mapping, size_, MADV_WILLNEED);
+            data_ = static_cast<const char *>(mapping);
+            mapped_ = true;
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        buffer_.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size())))
+            throw std::runtime_error("Failed to read file: " + path);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    void close()
+    {
+#ifdef VISION_CORE_MMAP
+        if (mapped_)
+            ::munmap(const_cast<char *>(data_), size_);
+#endif
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = false;
+    }
+
+    const char *data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    void swap(MappedFile &other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(mapped_, other.mapped_);
+        buffer_.swap(other.buffer_);
+    }
+
+    const char *data_{nullptr};
+    size_t size_{0};
+    bool mapped_{false};
+    std::vector<char> buffer_{};
+};
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
 #include <opencv2/opencv.hpp>
+#include <utils/simd_utils.hpp>
+#include <utils/thread_utils.hpp>
 #include <utils/vector_utils.hpp>
 
 constexpr float EPSILON = 1e-6;
@@ -16,12 +19,322 @@ inline float getIoU(const cv::Rect2f &rect1, const cv::Rect2f &rect2)
     return in / un;
 }
 
-inline float cosineSimilarity(const std::vector<float> &vec1, const std::vector<float> &vec2)
+enum class IoUType
+{
+    IoU,
+    GIoU,
+    DIoU,
+    CIoU
+};
+
+// Boxes in structure-of-arrays corner form, as consumed by the batched IoU kernels
+struct BoxArray
+{
+    std::vector<float> x1{}, y1{}, x2{}, y2{}, area{};
+    std::vector<float> aspect{}; // atan2(width, height), only filled for CIoU
+
+    size_t size() const { return x1.size(); }
+
+    void assign(const cv::Rect2f *boxes, size_t size, bool with_aspect = false)
+    {
+        x1.resize(size);
+        y1.resize(size);
+        x2.resize(size);
+        y2.resize(size);
+        area.resize(size);
+        aspect.resize(with_aspect ? size : 0);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const cv::Rect2f &box = boxes[i];
+            x1[i] = box.x;
+            y1[i] = box.y;
+            x2[i] = box.x + box.width;
+            y2[i] = box.y + box.height;
+            area[i] = box.area();
+            if (with_aspect)
+                aspect[i] = std::atan2(box.width, box.height);
+        }
+    }
+
+    void assign(const std::vector<cv::Rect2f> &boxes, bool with_aspect = false)
+    {
+        assign(boxes.data(), boxes.size(), with_aspect);
+    }
+};
+
+namespace detail
+{
+
+    constexpr float CIOU_V_SCALE = 4.f / static_cast<float>(CV_PI * CV_PI);
+
+    struct BoxCorners
+    {
+        float x1, y1, x2, y2, area, aspect;
+    };
+
+    inline BoxCorners toCorners(const cv::Rect2f &box, bool with_aspect)
+    {
+        return {box.x, box.y, box.x + box.width, box.y + box.height, box.area(),
+                with_aspect ? std::atan2(box.width, box.height) : 0.f};
+    }
+
+    inline BoxCorners toCorners(const BoxArray &boxes, size_t i)
+    {
+        return {boxes.x1[i], boxes.y1[i], boxes.x2[i], boxes.y2[i], boxes.area[i],
+                boxes.aspect.empty() ? 0.f : boxes.aspect[i]};
+    }
+
+    // Scalar reference, the SIMD kernels below perform the same operations in the same order
+    template <IoUType type>
+    inline float iouFromCorners(const BoxCorners &a, const BoxCorners &b)
+    {
+        float iw = std::max(std::min(a.x2, b.x2) - std::max(a.x1, b.x1), 0.f);
+        float ih = std::max(std::min(a.y2, b.y2) - std::max(a.y1, b.y1), 0.f);
+        float in = iw * ih;
+        float un = a.area + b.area - in;
+        float iou = un < EPSILON ? 0.f : in / un;
+
+        if constexpr (type == IoUType::GIoU)
+        {
+            float cw = std::max(a.x2, b.x2) - std::min(a.x1, b.x1);
+            float ch = std::max(a.y2, b.y2) - std::min(a.y1, b.y1);
+            float c_area = cw * ch;
+            return c_area < EPSILON ? iou : iou - (c_area - un) / c_area;
+        }
+        else if constexpr (type == IoUType::DIoU || type == IoUType::CIoU)
+        {
+            float cw = std::max(a.x2, b.x2) - std::min(a.x1, b.x1);
+            float ch = std::max(a.y2, b.y2) - std::min(a.y1, b.y1);
+            float c2 = cw * cw + ch * ch;
+            float dx = (b.x1 + b.x2) - (a.x1 + a.x2);
+            float dy = (b.y1 + b.y2) - (a.y1 + a.y2);
+            float rho2 = 0.25f * (dx * dx + dy * dy);
+            float diou = c2 < EPSILON ? iou : iou - rho2 / c2;
+
+            if constexpr (type == IoUType::CIoU)
+            {
+                float da = b.aspect - a.aspect;
+                float v = CIOU_V_SCALE * (da * da);
+                float alpha = v / ((1.f - iou) + v + EPSILON);
+                return diou - alpha * v;
+            }
+            return diou;
+        }
+        return iou;
+    }
+
+#ifdef VISION_CORE_X86_SIMD
+
+    // Each kernel processes full vectors in [begin, end) and returns the first index left for the scalar tail
+    template <IoUType type>
+    VISION_CORE_TARGET("avx2") inline size_t iouRowAvx2(const BoxCorners &a, const BoxArray &b, size_t begin, size_t end, float *out)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 eps = _mm256_set1_ps(EPSILON);
+        const __m256 ax1 = _mm256_set1_ps(a.x1), ay1 = _mm256_set1_ps(a.y1);
+        const __m256 ax2 = _mm256_set1_ps(a.x2), ay2 = _mm256_set1_ps(a.y2);
+        const __m256 aarea = _mm256_set1_ps(a.area);
+
+        size_t j = begin;
+        for (; j + 8 <= end; j += 8)
+        {
+            __m256 bx1 = _mm256_loadu_ps(&b.x1[j]), by1 = _mm256_loadu_ps(&b.y1[j]);
+            __m256 bx2 = _mm256_loadu_ps(&b.x2[j]), by2 = _mm256_loadu_ps(&b.y2[j]);
+
+            __m256 iw = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(ax2, bx2), _mm256_max_ps(ax1, bx1)), zero);
+            __m256 ih = _mm256_max_ps(_mm256_sub_ps(_mm256_min_ps(ay2, by2), _mm256_max_ps(ay1, by1)), zero);
+            __m256 in = _mm256_mul_ps(iw, ih);
+            __m256 un = _mm256_sub_ps(_mm256_add_ps(aarea, _mm256_loadu_ps(&b.area[j])), in);
+            __m256 iou = _mm256_and_ps(_mm256_cmp_ps(un, eps, _CMP_GE_OQ), _mm256_div_ps(in, _mm256_max_ps(un, eps)));
+
+            if constexpr (type != IoUType::IoU)
+            {
+                __m256 cw = _mm256_sub_ps(_mm256_max_ps(ax2, bx2), _mm256_min_ps(ax1, bx1));
+                __m256 ch = _mm256_sub_ps(_mm256_max_ps(ay2, by2), _mm256_min_ps(ay1, by1));
+
+                if constexpr (type == IoUType::GIoU)
+                {
+                    __m256 c_area = _mm256_mul_ps(cw, ch);
+                    __m256 penalty = _mm256_div_ps(_mm256_sub_ps(c_area, un), _mm256_max_ps(c_area, eps));
+                    iou = _mm256_sub_ps(iou, _mm256_and_ps(_mm256_cmp_ps(c_area, eps, _CMP_GE_OQ), penalty));
+                }
+                else
+                {
+                    __m256 c2 = _mm256_add_ps(_mm256_mul_ps(cw, cw), _mm256_mul_ps(ch, ch));
+                    __m256 dx = _mm256_sub_ps(_mm256_add_ps(bx1, bx2), _mm256_add_ps(ax1, ax2));
+                    __m256 dy = _mm256_sub_ps(_mm256_add_ps(by1, by2), _mm256_add_ps(ay1, ay2));
+                    __m256 rho2 = _mm256_mul_ps(_mm256_set1_ps(0.25f), _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+                    __m256 penalty = _mm256_div_ps(rho2, _mm256_max_ps(c2, eps));
+                    __m256 diou = _mm256_sub_ps(iou, _mm256_and_ps(_mm256_cmp_ps(c2, eps, _CMP_GE_OQ), penalty));
+
+                    if constexpr (type == IoUType::CIoU)
+                    {
+                        __m256 da = _mm256_sub_ps(_mm256_loadu_ps(&b.aspect[j]), _mm256_set1_ps(a.aspect));
+                        __m256 v = _mm256_mul_ps(_mm256_set1_ps(CIOU_V_SCALE), _mm256_mul_ps(da, da));
+                        __m256 denom = _mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.f), iou), v), eps);
+                        __m256 alpha = _mm256_div_ps(v, denom);
+                        diou = _mm256_sub_ps(diou, _mm256_mul_ps(alpha, v));
+                    }
+                    iou = diou;
+                }
+            }
+
+            _mm256_storeu_ps(out + (j - begin), iou);
+        }
+        return j;
+    }
+
+    template <IoUType type>
+    VISION_CORE_TARGET("sse4.1") inline size_t iouRowSse4(const BoxCorners &a, const BoxArray &b, size_t begin, size_t end, float *out)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 eps = _mm_set1_ps(EPSILON);
+        const __m128 ax1 = _mm_set1_ps(a.x1), ay1 = _mm_set1_ps(a.y1);
+        const __m128 ax2 = _mm_set1_ps(a.x2), ay2 = _mm_set1_ps(a.y2);
+        const __m128 aarea = _mm_set1_ps(a.area);
+
+        size_t j = begin;
+        for (; j + 4 <= end; j += 4)
+        {
+            __m128 bx1 = _mm_loadu_ps(&b.x1[j]), by1 = _mm_loadu_ps(&b.y1[j]);
+            __m128 bx2 = _mm_loadu_ps(&b.x2[j]), by2 = _mm_loadu_ps(&b.y2[j]);
+
+            __m128 iw = _mm_max_ps(_mm_sub_ps(_mm_min_ps(ax2, bx2), _mm_max_ps(ax1, bx1)), zero);
+            __m128 ih = _mm_max_ps(_mm_sub_ps(_mm_min_ps(ay2, by2), _mm_max_ps(ay1, by1)), zero);
+            __m128 in = _mm_mul_ps(iw, ih);
+            __m128 un = _mm_sub_ps(_mm_add_ps(aarea, _mm_loadu_ps(&b.area[j])), in);
+            __m128 iou = _mm_and_ps(_mm_cmpge_ps(un, eps), _mm_div_ps(in, _mm_max_ps(un, eps)));
+
+            if constexpr (type != IoUType::IoU)
+            {
+                __m128 cw = _mm_sub_ps(_mm_max_ps(ax2, bx2), _mm_min_ps(ax1, bx1));
+                __m128 ch = _mm_sub_ps(_mm_max_ps(ay2, by2), _mm_min_ps(ay1, by1));
+
+                if constexpr (type == IoUType::GIoU)
+                {
+                    __m128 c_area = _mm_mul_ps(cw, ch);
+                    __m128 penalty = _mm_div_ps(_mm_sub_ps(c_area, un), _mm_max_ps(c_area, eps));
+                    iou = _mm_sub_ps(iou, _mm_and_ps(_mm_cmpge_ps(c_area, eps), penalty));
+                }
+                else
+                {
+                    __m128 c2 = _mm_add_ps(_mm_mul_ps(cw, cw), _mm_mul_ps(ch, ch));
+                    __m128 dx = _mm_sub_ps(_mm_add_ps(bx1, bx2), _mm_add_ps(ax1, ax2));
+                    __m128 dy = _mm_sub_ps(_mm_add_ps(by1, by2), _mm_add_ps(ay1, ay2));
+                    __m128 rho2 = _mm_mul_ps(_mm_set1_ps(0.25f), _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                    __m128 penalty = _mm_div_ps(rho2, _mm_max_ps(c2, eps));
+                    __m128 diou = _mm_sub_ps(iou, _mm_and_ps(_mm_cmpge_ps(c2, eps), penalty));
+
+                    if constexpr (type == IoUType::CIoU)
+                    {
+                        __m128 da = _mm_sub_ps(_mm_loadu_ps(&b.aspect[j]), _mm_set1_ps(a.aspect));
+                        __m128 v = _mm_mul_ps(_mm_set1_ps(CIOU_V_SCALE), _mm_mul_ps(da, da));
+                        __m128 denom = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.f), iou), v), eps);
+                        __m128 alpha = _mm_div_ps(v, denom);
+                        diou = _mm_sub_ps(diou, _mm_mul_ps(alpha, v));
+                    }
+                    iou = diou;
+                }
+            }
+
+            _mm_storeu_ps(out + (j - begin), iou);
+        }
+        return j;
+    }
+
+#endif
+
+    template <IoUType type>
+    inline void iouRow(const BoxCorners &a, const BoxArray &b, size_t begin, size_t end, float *out)
+    {
+        size_t j = begin;
+#ifdef VISION_CORE_X86_SIMD
+        simd::Level level = simd::level();
+        if (level >= simd::Level::AVX2)
+            j = iouRowAvx2<type>(a, b, begin, end, out);
+        else if (level == simd::Level::SSE4)
+            j = iouRowSse4<type>(a, b, begin, end, out);
+#endif
+        for (; j < end; ++j)
+        {
+            out[j - begin] = iouFromCorners<type>(a, toCorners(b, j));
+        }
+    }
+
+} // namespace detail
+
+inline float getIoU(const cv::Rect2f &rect1, const cv::Rect2f &rect2, IoUType type)
+{
+    if (type == IoUType::IoU)
+        return getIoU(rect1, rect2);
+
+    detail::BoxCorners a = detail::toCorners(rect1, type == IoUType::CIoU);
+    detail::BoxCorners b = detail::toCorners(rect2, type == IoUType::CIoU);
+
+    switch (type)
+    {
+    case IoUType::GIoU:
+        return detail::iouFromCorners<IoUType::GIoU>(a, b);
+    case IoUType::CIoU:
+        return detail::iouFromCorners<IoUType::CIoU>(a, b);
+    default:
+        return detail::iouFromCorners<IoUType::DIoU>(a, b);
+    }
+}
+
+// IoU of one box against boxes[begin, end), written to out[0, end - begin).
+// CIoU needs boxes assigned with_aspect.
+inline void getIoURow(const cv::Rect2f &box, const BoxArray &boxes, size_t begin, size_t end, float *out, IoUType type = IoUType::IoU)
+{
+    if (type == IoUType::CIoU && boxes.aspect.size() != boxes.size())
+    {
+        throw std::invalid_argument("CIoU requires a BoxArray assigned with_aspect");
+    }
+
+    detail::BoxCorners corners = detail::toCorners(box, type == IoUType::CIoU);
+
+    switch (type)
+    {
+    case IoUType::GIoU:
+        detail::iouRow<IoUType::GIoU>(corners, boxes, begin, end, out);
+        break;
+    case IoUType::DIoU:
+        detail::iouRow<IoUType::DIoU>(corners, boxes, begin, end, out);
+        break;
+    case IoUType::CIoU:
+        detail::iouRow<IoUType::CIoU>(corners, boxes, begin, end, out);
+        break;
+    default:
+        detail::iouRow<IoUType::IoU>(corners, boxes, begin, end, out);
+        break;
+    }
+}
+
+// Pairwise IoU written row-major into out[size1 x size2]
+inline void getIoUMatrix(const cv::Rect2f *boxes1, size_t size1, const cv::Rect2f *boxes2, size_t size2, float *out, IoUType type = IoUType::IoU)
+{
+    thread_local BoxArray columns;
+    columns.assign(boxes2, size2, type == IoUType::CIoU);
+
+    for (size_t i = 0; i < size1; ++i)
+    {
+        getIoURow(boxes1[i], columns, 0, size2, out + i * size2, type);
+    }
+}
+
+template <typename AllocA = std::allocator<cv::Rect2f>, typename AllocB = std::allocator<cv::Rect2f>>
+inline void getIoUMatrix(const std::vector<cv::Rect2f, AllocA> &boxes1, const std::vector<cv::Rect2f, AllocB> &boxes2, float *out, IoUType type = IoUType::IoU)
+{
+    getIoUMatrix(boxes1.data(), boxes1.size(), boxes2.data(), boxes2.size(), out, type);
+}
+
+inline float cosineSimilarity(const float *vec1, const float *vec2, size_t size)
 {
     float similarity;
-    float dotProduct = vector_ops::dot(vec1, vec2);
-    float normVec1 = std::sqrt(vector_ops::dot(vec1, vec1));
-    float normVec2 = std::sqrt(vector_ops::dot(vec2, vec2));
+    float dotProduct = vector_ops::dot(vec1, vec2, size);
+    float normVec1 = std::sqrt(vector_ops::dot(vec1, vec1, size));
+    float normVec2 = std::sqrt(vector_ops::dot(vec2, vec2, size));
 
     if (normVec1 * normVec2 < EPSILON * EPSILON)
     {
@@ -30,4 +343,173 @@ inline float cosineSimilarity(const std::vector<float> &vec1, const std::vector<
 
     similarity = (1.f + dotProduct / (normVec1 * normVec2)) / 2.f;
     return similarity;
-}
\ No newline at end of file
+}
+
+template <typename AllocA, typename AllocB>
+inline float cosineSimilarity(const std::vector<float, AllocA> &vec1, const std::vector<float, AllocB> &vec2)
+{
+    if (vec1.size() != vec2.size())
+    {
+        throw std::invalid_argument("Vectors must be the same size");
+    }
+
+    return cosineSimilarity(vec1.data(), vec2.data(), vec1.size());
+}
+
+// L2-normalize contiguous rows in place, rows with zero norm are left untouched
+inline void normalizeRows(float *rows, size_t count, size_t dim)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        float *row = rows + i * dim;
+        float norm = std::sqrt(vector_ops::dot(row, row, dim));
+        if (norm < EPSILON)
+            continue;
+
+        const float inv_norm = 1.f / norm;
+        for (size_t k = 0; k < dim; ++k)
+        {
+            row[k] *= inv_norm;
+        }
+    }
+}
+
+namespace detail
+{
+
+    // Query rows are tiled so that one tile stays in L2 while every gallery row streams over it
+    constexpr size_t SIMILARITY_TILE_BYTES = 128 * 1024;
+
+    // out[r * ldo + c] = dot(a row r, b row c) for an RA x RB register tile
+    template <int RA, int RB>
+    inline void dotTileScalar(const float *a, const float *b, size_t dim, float *out, size_t ldo)
+    {
+        for (int r = 0; r < RA; ++r)
+        {
+            for (int c = 0; c < RB; ++c)
+            {
+                out[r * ldo + c] = vector_ops::dot(a + r * dim, b + c * dim, dim);
+            }
+        }
+    }
+
+#ifdef VISION_CORE_X86_SIMD
+
+    template <int RA, int RB>
+    VISION_CORE_TARGET("avx2,fma") inline void dotTileAvx2(const float *a, const float *b, size_t dim, float *out, size_t ldo)
+    {
+        __m256 acc[RA][RB];
+        VISION_CORE_UNROLL
+        for (int r = 0; r < RA; ++r)
+            VISION_CORE_UNROLL
+            for (int c = 0; c < RB; ++c)
+                acc[r][c] = _mm256_setzero_ps();
+
+        size_t k = 0;
+        for (; k + 8 <= dim; k += 8)
+        {
+            __m256 vb[RB];
+            VISION_CORE_UNROLL
+            for (int c = 0; c < RB; ++c)
+                vb[c] = _mm256_loadu_ps(b + c * dim + k);
+
+            VISION_CORE_UNROLL
+            for (int r = 0; r < RA; ++r)
+            {
+                __m256 va = _mm256_loadu_ps(a + r * dim + k);
+                VISION_CORE_UNROLL
+                for (int c = 0; c < RB; ++c)
+                    acc[r][c] = _mm256_fmadd_ps(va, vb[c], acc[r][c]);
+            }
+        }
+
+        for (int r = 0; r < RA; ++r)
+        {
+            for (int c = 0; c < RB; ++c)
+            {
+                float sum = simd::hsum(acc[r][c]);
+                for (size_t t = k; t < dim; ++t)
+                    sum += a[r * dim + t] * b[c * dim + t];
+                out[r * ldo + c] = sum;
+            }
+        }
+    }
+
+#endif
+
+    template <int RA, int RB>
+    inline void dotTile(const float *a, const float *b, size_t dim, float *out, size_t ldo)
+    {
+#ifdef VISION_CORE_X86_SIMD
+        if (simd::level() >= simd::Level::AVX2)
+        {
+            dotTileAvx2<RA, RB>(a, b, dim, out, ldo);
+            return;
+        }
+#endif
+        dotTileScalar<RA, RB>(a, b, dim, out, ldo);
+    }
+
+    // Raw dot products of a[rows_a x dim] against b[rows_b x dim], written with row stride ldo
+    inline void dotMatrix(const float *a, size_t rows_a, const float *b, size_t rows_b, size_t dim, float *out, size_t ldo)
+    {
+        const size_t tile = std::max<size_t>(4, SIMILARITY_TILE_BYTES / (sizeof(float) * std::max<size_t>(dim, 1)) / 4 * 4);
+
+        for (size_t jb = 0; jb < rows_b; jb += tile)
+        {
+            const size_t je = std::min(rows_b, jb + tile);
+            size_t i = 0;
+            for (; i + 2 <= rows_a; i += 2)
+            {
+                size_t j = jb;
+                for (; j + 4 <= je; j += 4)
+                    dotTile<2, 4>(a + i * dim, b + j * dim, dim, out + i * ldo + j, ldo);
+                for (; j < je; ++j)
+                    dotTile<2, 1>(a + i * dim, b + j * dim, dim, out + i * ldo + j, ldo);
+            }
+            for (; i < rows_a; ++i)
+            {
+                size_t j = jb;
+                for (; j + 4 <= je; j += 4)
+                    dotTile<1, 4>(a + i * dim, b + j * dim, dim, out + i * ldo + j, ldo);
+                for (; j < je; ++j)
+                    dotTile<1, 1>(a + i * dim, b + j * dim, dim, out + i * ldo + j, ldo);
+            }
+        }
+    }
+
+} // namespace detail
+
+// Similarity of every gallery row against every query row, written row-major into out[num_gallery x num_query].
+// Rows must be L2-normalized (see normalizeRows). Follows the cosineSimilarity convention:
+// (1 + cos) / 2, and 0 when either row is a zero vector.
+inline void cosineSimilarityMatrix(const float *gallery, size_t num_gallery, const float *query, size_t num_query,
+                                   size_t dim, float *out, size_t num_threads = 1)
+{
+    thread_local std::vector<uint8_t> query_valid;
+    query_valid.resize(num_query);
+    for (size_t j = 0; j < num_query; ++j)
+    {
+        query_valid[j] = vector_ops::dot(query + j * dim, query + j * dim, dim) >= EPSILON * EPSILON;
+    }
+    const uint8_t *valid = query_valid.data();
+
+    parallelFor(0, num_gallery, num_threads, [=](size_t begin, size_t end)
+                {
+                    detail::dotMatrix(gallery + begin * dim, end - begin, query, num_query, dim, out + begin * num_query, num_query);
+
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        float *row = out + i * num_query;
+                        if (vector_ops::dot(gallery + i * dim, gallery + i * dim, dim) < EPSILON * EPSILON)
+                        {
+                            std::fill(row, row + num_query, 0.f);
+                            continue;
+                        }
+                        for (size_t j = 0; j < num_query; ++j)
+                        {
+                            row[j] = valid[j] ? (1.f + row[j]) / 2.f : 0.f;
+                        }
+                    }
+                });
+}
@@ -1,8 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 
+#include <types/detection.hpp>
+#include <types/class_registry.hpp>
+
 struct JsonConfig
 {
 public:
@@ -13,3 +20,70 @@ protected:
     JsonConfig() = default;
     virtual void loadFromJson(const nlohmann::json &data) = 0;
 };
+
+// Label file as a list of names (["person", "bicycle", ...]), an id to name object
+// ({"0": "person", "1": "bicycle"}) or either of them under a "names" key
+inline ClassRegistry classRegistryFromJson(const nlohmann::json &data)
+{
+    const nlohmann::json &names = data.is_object() && data.contains("names") ? data.at("names") : data;
+
+    ClassRegistry registry;
+    if (names.is_array())
+    {
+        for (size_t id = 0; id < names.size(); ++id)
+            registry.set(static_cast<int>(id), names[id].get<std::string>());
+    }
+    else if (names.is_object())
+    {
+        for (const auto &[key, name] : names.items())
+        {
+            size_t end = 0;
+            const int id = std::stoi(key, &end);
+            if (end != key.size())
+                throw std::invalid_argument("Invalid class id in label file: " + key);
+            registry.set(id, name.get<std::string>());
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("Label file must be an array or an object of class names");
+    }
+    return registry;
+}
+
+inline ClassRegistry loadClassRegistry(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Failed to open file: " + path);
+    return classRegistryFromJson(nlohmann::json::parse(file));
+}
+
+// Names are resolved through the registry when a detection only carries its class id
+inline nlohmann::json toJson(const Detection &det, const ClassRegistry &registry = ClassRegistry::global())
+{
+    nlohmann::json data = {
+        {"class_id", det.class_id},
+        {"class_name", std::string(det.getClassName(registry))},
+        {"confidence", det.confidence},
+        {"bbox", {det.bbox.x, det.bbox.y, det.bbox.width, det.bbox.height}},
+        {"frame_id", det.frame_id},
+        {"track_id", det.track_id},
+    };
+    if (!det.labels.empty())
+    {
+        nlohmann::json labels = nlohmann::json::object();
+        for (const auto &[id, name] : det.labels)
+            labels[std::to_string(id)] = std::string(name.empty() ? registry.name(id) : name);
+        data["labels"] = std::move(labels);
+    }
+    return data;
+}
+
+inline nlohmann::json toJson(const std::vector<Detection> &detections, const ClassRegistry &registry = ClassRegistry::global())
+{
+    nlohmann::json data = nlohmann::json::array();
+    for (const auto &det : detections)
+        data.push_back(toJson(det, registry));
+    return data;
+}
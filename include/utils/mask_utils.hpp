@@ -0,0 +1,469 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <bitset>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include <utils/simd_utils.hpp>
+#include <utils/vector_utils.hpp>
+#include <utils/detection_utils.hpp>
+
+// Binary instance mask, one bit per pixel over the rows and 64-pixel words its region touches.
+// Words are aligned to image columns (word w covers x in [64 * w, 64 * w + 64)), so masks of
+// different boxes are combined word by word without shifting.
+struct BitMask
+{
+    cv::Size image_size{};
+    cv::Rect roi{};               // region that may hold set bits, inside the image
+    int first_word{0};            // word of the first roi column
+    int words_per_row{0};
+    std::vector<uint64_t> bits{}; // roi.height rows of words_per_row words
+
+    BitMask() = default;
+
+    // All-zero mask able to hold bits inside roi (clipped to the image)
+    BitMask(cv::Size size, const cv::Rect &region) : image_size(size), roi(region & cv::Rect(cv::Point(), size))
+    {
+        if (roi.empty())
+        {
+            roi = cv::Rect();
+            return;
+        }
+        first_word = roi.x >> 6;
+        words_per_row = ((roi.x + roi.width - 1) >> 6) - first_word + 1;
+        bits.assign(static_cast<size_t>(roi.height) * words_per_row, 0);
+    }
+
+    bool empty() const { return bits.empty(); }
+
+    // Words of image row y, which must be inside roi
+    const uint64_t *row(int y) const { return bits.data() + static_cast<size_t>(y - roi.y) * words_per_row; }
+    uint64_t *row(int y) { return bits.data() + static_cast<size_t>(y - roi.y) * words_per_row; }
+
+    bool at(int x, int y) const
+    {
+        if (!roi.contains(cv::Point(x, y)))
+            return false;
+        return (row(y)[(x >> 6) - first_word] >> (x & 63)) & 1u;
+    }
+
+    void set(int x, int y)
+    {
+        row(y)[(x >> 6) - first_word] |= uint64_t(1) << (x & 63);
+    }
+
+    // Number of set pixels
+    size_t area() const;
+
+    size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+
+    // Dense CV_8U image_size mask with 0 and 1, as getAbsoluteMask returns
+    cv::Mat toMat() const
+    {
+        cv::Mat mask = cv::Mat::zeros(image_size, CV_8U);
+        for (int y = roi.y; y < roi.y + roi.height; ++y)
+        {
+            uchar *out = mask.ptr<uchar>(y);
+            for (int x = roi.x; x < roi.x + roi.width; ++x)
+                out[x] = at(x, y) ? 1 : 0;
+        }
+        return mask;
+    }
+};
+
+// COCO run-length encoding: column-major runs over the whole image alternating between
+// zeros and ones, starting with zeros (the first count may be 0)
+struct RleMask
+{
+    cv::Size size{};
+    std::vector<uint32_t> counts{};
+
+    bool empty() const { return counts.empty(); }
+
+    size_t area() const
+    {
+        size_t result = 0;
+        for (size_t i = 1; i < counts.size(); i += 2)
+            result += counts[i];
+        return result;
+    }
+};
+
+// Prototype patch and resampling tables of decodeMasks for one box at a time, one per inference thread
+struct MaskWorkspace
+{
+    std::vector<float> patch{};   // mask probabilities on the prototype cells under one box
+    std::vector<float> column{};  // patch interpolated to one output row, per patch column
+    std::vector<float> row{};     // one output row
+    std::vector<int> x0{}, x1{};  // prototype columns left and right of each output column
+    std::vector<float> x_weight{};
+};
+
+namespace detail
+{
+    inline size_t popcount(uint64_t word)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_popcountll(word));
+#else
+        return std::bitset<64>(word).count();
+#endif
+    }
+
+#ifdef VISION_CORE_X86_SIMD
+
+    // Hardware POPCNT. It is not implied by SSE4.1, but every AVX2 CPU has it.
+    VISION_CORE_TARGET("popcnt") inline size_t popcountPopcnt(const uint64_t *a, size_t size)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+            result += static_cast<size_t>(__builtin_popcountll(a[i]));
+        return result;
+    }
+
+    VISION_CORE_TARGET("popcnt") inline size_t popcountAndPopcnt(const uint64_t *a, const uint64_t *b, size_t size)
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+            result += static_cast<size_t>(__builtin_popcountll(a[i] & b[i]));
+        return result;
+    }
+
+#endif
+
+    inline size_t popcount(const uint64_t *a, size_t size)
+    {
+#ifdef VISION_CORE_X86_SIMD
+        if (simd::level() >= simd::Level::AVX2)
+            return popcountPopcnt(a, size);
+#endif
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+            result += popcount(a[i]);
+        return result;
+    }
+
+    inline size_t popcountAnd(const uint64_t *a, const uint64_t *b, size_t size)
+    {
+#ifdef VISION_CORE_X86_SIMD
+        if (simd::level() >= simd::Level::AVX2)
+            return popcountAndPopcnt(a, b, size);
+#endif
+        size_t result = 0;
+        for (size_t i = 0; i < size; ++i)
+            result += popcount(a[i] & b[i]);
+        return result;
+    }
+
+    // Set the bits of image row y where values[x - x_begin] > threshold, for x in [x_begin, x_end)
+    inline void packRow(const float *values, int x_begin, int x_end, float threshold, uint64_t *row, int first_word)
+    {
+        int x = x_begin;
+        while (x < x_end)
+        {
+            const int word_end = std::min(x_end, ((x >> 6) + 1) << 6);
+            uint64_t word = 0;
+            for (; x < word_end; ++x)
+                word |= static_cast<uint64_t>(values[x - x_begin] > threshold) << (x & 63);
+            row[((x - 1) >> 6) - first_word] |= word;
+        }
+    }
+
+    // Run-length writer that merges consecutive runs of the same value
+    struct RleWriter
+    {
+        std::vector<uint32_t> &counts;
+        bool value{false};
+        uint32_t run{0};
+
+        void add(bool bit, uint32_t length)
+        {
+            if (length == 0)
+                return;
+            if (bit != value)
+            {
+                counts.push_back(run);
+                value = bit;
+                run = 0;
+            }
+            run += length;
+        }
+
+        void finish() { counts.push_back(run); }
+    };
+
+} // namespace detail
+
+inline size_t BitMask::area() const
+{
+    return detail::popcount(bits.data(), bits.size());
+}
+
+// Resize a box-local mask (CV_8U or CV_32F, any resolution, stretched over box as the renderer
+// does) and threshold it straight into bits, touching only the part of the box inside the image
+inline BitMask packMask(const cv::Mat &box_mask, const cv::Rect &box, cv::Size image_size, float threshold = 0.5f)
+{
+    BitMask mask(image_size, box);
+    if (mask.roi.empty() || box_mask.empty())
+        return mask;
+
+    const cv::Rect region(mask.roi.tl() - box.tl(), mask.roi.size());
+    detail::resizeMaskRows(box_mask, box.size(), region, [&](int y, const float *values)
+                           { detail::packRow(values, mask.roi.x, mask.roi.x + mask.roi.width, threshold,
+                                             mask.row(box.y + y), mask.first_word); });
+    return mask;
+}
+
+// Instance masks from prototype masks and per-detection coefficients (YOLOv8-seg / YOLACT):
+// mask = sigmoid(coefficients . protos), bilinearly upsampled and thresholded. protos is
+// [num_protos][proto_size.height][proto_size.width] over the letterboxed model input, boxes are in
+// source image pixels (as from decodeDetections). Only the prototype cells under each box are
+// evaluated and only box pixels are resampled, written straight into bits.
+inline void decodeMasks(const float *protos, int num_protos, cv::Size proto_size, const float *coefficients,
+                        const cv::Rect2f *boxes, size_t count, const LetterboxInfo &info, MaskWorkspace &ws,
+                        std::vector<BitMask> &masks, float threshold = 0.5f)
+{
+    if (num_protos <= 0 || proto_size.empty() || info.shape.empty() || info.source.empty())
+        throw std::invalid_argument("Mask decoding needs prototypes and a LetterboxInfo with source and model sizes");
+
+    const size_t plane = static_cast<size_t>(proto_size.area());
+    // Source pixel coordinate to prototype cell coordinate (half-pixel centers on both sides)
+    const float ax = info.scale_x * proto_size.width / info.shape.width;
+    const float ay = info.scale_y * proto_size.height / info.shape.height;
+    const float bx = static_cast<float>(info.left) * proto_size.width / info.shape.width;
+    const float by = static_cast<float>(info.top) * proto_size.height / info.shape.height;
+
+    masks.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const cv::Rect2f &box = boxes[i];
+        const cv::Rect pixels(cv::Point(static_cast<int>(std::floor(box.x)), static_cast<int>(std::floor(box.y))),
+                              cv::Point(static_cast<int>(std::ceil(box.x + box.width)), static_cast<int>(std::ceil(box.y + box.height))));
+        BitMask &mask = masks[i] = BitMask(info.source, pixels);
+        if (mask.empty())
+            continue;
+
+        const cv::Rect &roi = mask.roi;
+        auto cellX = [&](float x)
+        { return std::max((x + 0.5f) * ax + bx - 0.5f, 0.f); };
+        auto cellY = [&](float y)
+        { return std::max((y + 0.5f) * ay + by - 0.5f, 0.f); };
+
+        // Prototype cells the box samples from
+        const int cx0 = std::min(static_cast<int>(cellX(static_cast<float>(roi.x))), proto_size.width - 1);
+        const int cx1 = std::min(static_cast<int>(cellX(static_cast<float>(roi.x + roi.width - 1))) + 1, proto_size.width - 1);
+        const int cy0 = std::min(static_cast<int>(cellY(static_cast<float>(roi.y))), proto_size.height - 1);
+        const int cy1 = std::min(static_cast<int>(cellY(static_cast<float>(roi.y + roi.height - 1))) + 1, proto_size.height - 1);
+        const int patch_width = cx1 - cx0 + 1, patch_height = cy1 - cy0 + 1;
+
+        // Linear combination of the prototypes on the patch, then sigmoid
+        const float *coefs = coefficients + i * static_cast<size_t>(num_protos);
+        ws.patch.assign(static_cast<size_t>(patch_width) * patch_height, 0.f);
+        for (int k = 0; k < num_protos; ++k)
+        {
+            const float c = coefs[k];
+            const float *proto = protos + k * plane;
+            for (int py = 0; py < patch_height; ++py)
+            {
+                const float *in = proto + static_cast<size_t>(cy0 + py) * proto_size.width + cx0;
+                float *out = ws.patch.data() + static_cast<size_t>(py) * patch_width;
+                for (int px = 0; px < patch_width; ++px)
+                    out[px] += c * in[px];
+            }
+        }
+        vector_ops::sigmoid(ws.patch.data(), ws.patch.size(), ws.patch.data());
+
+        ws.x0.resize(roi.width);
+        ws.x1.resize(roi.width);
+        ws.x_weight.resize(roi.width);
+        ws.row.resize(roi.width);
+        ws.column.resize(patch_width);
+        detail::bilinearColumns(roi.x, roi.width, ax, bx, proto_size.width, ws.x0.data(), ws.x1.data(), ws.x_weight.data());
+
+        for (int y = roi.y; y < roi.y + roi.height; ++y)
+        {
+            const float cell = cellY(static_cast<float>(y));
+            const int r0 = std::min(static_cast<int>(cell), proto_size.height - 1);
+            const int r1 = std::min(r0 + 1, proto_size.height - 1);
+            const float weight = cell - static_cast<float>(r0);
+            const float *top = ws.patch.data() + static_cast<size_t>(r0 - cy0) * patch_width;
+            const float *bottom = ws.patch.data() + static_cast<size_t>(r1 - cy0) * patch_width;
+            for (int px = 0; px < patch_width; ++px)
+                ws.column[px] = top[px] + (bottom[px] - top[px]) * weight;
+
+            for (int x = 0; x < roi.width; ++x)
+            {
+                const float left = ws.column[ws.x0[x] - cx0], right = ws.column[ws.x1[x] - cx0];
+                ws.row[x] = left + (right - left) * ws.x_weight[x];
+            }
+            detail::packRow(ws.row.data(), roi.x, roi.x + roi.width, threshold, mask.row(y), mask.first_word);
+        }
+    }
+}
+
+// Pixel IoU of two masks of the same image, counted with popcount over the overlapping words
+inline float maskIoU(const BitMask &a, const BitMask &b)
+{
+    if (a.image_size != b.image_size)
+        throw std::invalid_argument("Masks must belong to images of the same size");
+
+    const size_t area_a = a.area(), area_b = b.area();
+    if (area_a + area_b == 0)
+        return 0.f;
+
+    size_t intersection = 0;
+    const int y_begin = std::max(a.roi.y, b.roi.y);
+    const int y_end = std::min(a.roi.y + a.roi.height, b.roi.y + b.roi.height);
+    const int w_begin = std::max(a.first_word, b.first_word);
+    const int w_end = std::min(a.first_word + a.words_per_row, b.first_word + b.words_per_row);
+    if (w_begin < w_end)
+    {
+        for (int y = y_begin; y < y_end; ++y)
+            intersection += detail::popcountAnd(a.row(y) + (w_begin - a.first_word), b.row(y) + (w_begin - b.first_word),
+                                                static_cast<size_t>(w_end - w_begin));
+    }
+    return static_cast<float>(intersection) / static_cast<float>(area_a + area_b - intersection);
+}
+
+// Pairwise mask IoU written row-major into out[masks1.size() x masks2.size()]
+inline void maskIoUMatrix(const std::vector<BitMask> &masks1, const std::vector<BitMask> &masks2, float *out)
+{
+    for (size_t i = 0; i < masks1.size(); ++i)
+    {
+        for (size_t j = 0; j < masks2.size(); ++j)
+        {
+            const bool overlap = (masks1[i].roi & masks2[j].roi).area() > 0;
+            out[i * masks2.size() + j] = overlap ? maskIoU(masks1[i], masks2[j]) : 0.f;
+        }
+    }
+}
+
+inline RleMask encodeRle(const BitMask &mask)
+{
+    RleMask rle;
+    rle.size = mask.image_size;
+    detail::RleWriter writer{rle.counts};
+
+    const uint32_t height = static_cast<uint32_t>(mask.image_size.height);
+    const cv::Rect &roi = mask.roi;
+    writer.add(false, static_cast<uint32_t>(roi.x) * height);
+    for (int x = roi.x; x < roi.x + roi.width; ++x)
+    {
+        writer.add(false, static_cast<uint32_t>(roi.y));
+        const size_t word = static_cast<size_t>((x >> 6) - mask.first_word);
+        const int bit = x & 63;
+        for (int y = roi.y; y < roi.y + roi.height; ++y)
+            writer.add((mask.row(y)[word] >> bit) & 1u, 1);
+        writer.add(false, height - static_cast<uint32_t>(roi.y + roi.height));
+    }
+    writer.add(false, static_cast<uint32_t>(mask.image_size.width - roi.x - roi.width) * height);
+    writer.finish();
+    return rle;
+}
+
+inline BitMask decodeRle(const RleMask &rle)
+{
+    const int height = rle.size.height;
+    size_t total = 0;
+    for (uint32_t count : rle.counts)
+        total += count;
+    if (total != static_cast<size_t>(rle.size.area()))
+        throw std::invalid_argument("RLE counts do not cover the mask size");
+
+    // Bounding region of the runs of ones first, so only that region is stored
+    int x_min = rle.size.width, x_max = -1, y_min = height, y_max = -1;
+    size_t position = 0;
+    for (size_t i = 0; i < rle.counts.size(); ++i)
+    {
+        const size_t count = rle.counts[i];
+        if (i % 2 == 1 && count > 0)
+        {
+            const size_t last = position + count - 1;
+            const int first_x = static_cast<int>(position / height), last_x = static_cast<int>(last / height);
+            x_min = std::min(x_min, first_x);
+            x_max = std::max(x_max, last_x);
+            y_min = std::min(y_min, first_x == last_x ? static_cast<int>(position % height) : 0);
+            y_max = std::max(y_max, first_x == last_x ? static_cast<int>(last % height) : height - 1);
+        }
+        position += count;
+    }
+
+    if (x_max < 0)
+        return BitMask(rle.size, cv::Rect());
+
+    BitMask mask(rle.size, cv::Rect(cv::Point(x_min, y_min), cv::Point(x_max + 1, y_max + 1)));
+    position = 0;
+    for (size_t i = 0; i < rle.counts.size(); ++i)
+    {
+        if (i % 2 == 1)
+        {
+            for (size_t p = position; p < position + rle.counts[i]; ++p)
+                mask.set(static_cast<int>(p / height), static_cast<int>(p % height));
+        }
+        position += rle.counts[i];
+    }
+    return mask;
+}
+
+// COCO compressed counts string (pycocotools rleToString): differences to the count two back,
+// 5 bits per character with a continuation flag
+inline std::string rleToString(const RleMask &rle)
+{
+    std::string result;
+    for (size_t i = 0; i < rle.counts.size(); ++i)
+    {
+        int64_t x = rle.counts[i];
+        if (i > 2)
+            x -= static_cast<int64_t>(rle.counts[i - 2]);
+        bool more = true;
+        while (more)
+        {
+            char c = static_cast<char>(x & 0x1f);
+            x >>= 5;
+            more = (c & 0x10) ? x != -1 : x != 0;
+            if (more)
+                c |= 0x20;
+            result.push_back(static_cast<char>(c + 48));
+        }
+    }
+    return result;
+}
+
+inline RleMask rleFromString(const std::string &counts, cv::Size size)
+{
+    RleMask rle;
+    rle.size = size;
+    size_t p = 0;
+    while (p < counts.size())
+    {
+        int64_t x = 0;
+        int k = 0;
+        bool more = true;
+        while (more)
+        {
+            // 7 characters carry 35 bits, enough for any difference of two uint32 counts
+            if (p >= counts.size() || k >= 7)
+                throw std::invalid_argument("Malformed RLE counts string");
+            const int c = counts[p] - 48;
+            if (c < 0 || c > 63)
+                throw std::invalid_argument("Malformed RLE counts string");
+            x |= static_cast<int64_t>(c & 0x1f) << (5 * k);
+            more = (c & 0x20) != 0;
+            ++p;
+            ++k;
+            if (!more && (c & 0x10))
+                x |= -(int64_t(1) << (5 * k));
+        }
+        if (rle.counts.size() > 2)
+            x += static_cast<int64_t>(rle.counts[rle.counts.size() - 2]);
+        if (x < 0 || x > static_cast<int64_t>(UINT32_MAX))
+            throw std::invalid_argument("Malformed RLE counts string");
+        rle.counts.push_back(static_cast<uint32_t>(x));
+    }
+    return rle;
+}
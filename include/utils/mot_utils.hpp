@@ -0,0 +1,610 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <climits>
+#include <exception>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection_batch.hpp>
+#include <utils/file_utils.hpp>
+#include <utils/parse_utils.hpp>
+#include <utils/thread_utils.hpp>
+
+// Malformed input line, line numbers start at 1
+struct MotParseError
+{
+    size_t line;
+    std::string message;
+};
+
+namespace detail
+{
+    // Below this many bytes per chunk the threads cost more than they save
+    constexpr size_t MOT_MIN_CHUNK_BYTES = 1 << 20;
+
+    inline size_t countLines(const char *first, const char *last)
+    {
+        size_t lines = 0;
+        while (first < last)
+        {
+            const void *newline = std::memchr(first, '\n', static_cast<size_t>(last - first));
+            ++lines;
+            if (newline == nullptr)
+                break;
+            first = static_cast<const char *>(newline) + 1;
+        }
+        return lines;
+    }
+
+    inline void writeMotRow(DetectionBatch &batch, size_t row, const MotRecord &record)
+    {
+        batch.bboxes[row] = cv::Rect2f(record.x, record.y, record.width, record.height);
+        batch.confidences[row] = record.confidence;
+        batch.frame_ids[row] = record.frame_id;
+        batch.track_ids[row] = record.track_id;
+        batch.positions[row] = cv::Point3f(record.pos_x, record.pos_y, record.pos_z);
+        batch.sizes[row] = cv::Size(record.width, record.height);
+    }
+
+    // Move rows [begin, end) with keep[row - begin] set down to begin, return the new end
+    inline size_t compactRows(DetectionBatch &batch, size_t begin, size_t end, const std::vector<uint8_t> &keep)
+    {
+        size_t out = begin;
+        for (size_t row = begin; row < end; ++row)
+        {
+            if (!keep[row - begin])
+                continue;
+            if (out != row)
+            {
+                batch.bboxes[out] = batch.bboxes[row];
+                batch.confidences[out] = batch.confidences[row];
+                batch.frame_ids[out] = batch.frame_ids[row];
+                batch.track_ids[out] = batch.track_ids[row];
+                batch.positions[out] = batch.positions[row];
+                batch.sizes[out] = batch.sizes[row];
+            }
+            ++out;
+        }
+        return out;
+    }
+
+    inline void resizeRows(DetectionBatch &batch, size_t size)
+    {
+        batch.bboxes.resize(size);
+        batch.confidences.resize(size, 0.f);
+        batch.class_ids.resize(size, -1);
+        batch.frame_ids.resize(size, -1);
+        batch.track_ids.resize(size, -1);
+        batch.positions.resize(size);
+        batch.sizes.resize(size);
+        batch.mask_ids.resize(size, -1);
+        batch.features.resize(size * batch.feature_dim, 0.f);
+    }
+} // namespace detail
+
+// Parse MOTChallenge text held in memory and append its rows to batch.
+// The buffer is split into newline-aligned chunks parsed by up to num_threads threads
+// (0 uses all hardware threads); rows are written in place, so the result keeps the input order.
+// Blank lines are skipped, malformed lines are reported in errors and skipped.
+// Returns the number of rows appended.
+inline size_t parseMot(const char *data, size_t size, DetectionBatch &batch, std::vector<MotParseError> &errors,
+                       size_t num_threads = 0)
+{
+    errors.clear();
+    if (size == 0)
+        return 0;
+
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    const size_t num_chunks = std::clamp<size_t>(size / detail::MOT_MIN_CHUNK_BYTES, 1, num_threads);
+
+    // Chunk c covers [bounds[c], bounds[c + 1]), every boundary but the last follows a newline
+    const char *end = data + size;
+    std::vector<const char *> bounds(num_chunks + 1, end);
+    bounds[0] = data;
+    for (size_t c = 1; c < num_chunks; ++c)
+    {
+        const char *split = std::max(data + c * (size / num_chunks), bounds[c - 1]);
+        const void *newline = std::memchr(split, '\n', static_cast<size_t>(end - split));
+        bounds[c] = newline ? static_cast<const char *>(newline) + 1 : end;
+    }
+
+    // First pass counts lines so that every chunk knows its first row and line number
+    std::vector<size_t> first_line(num_chunks + 1, 0);
+    parallelFor(0, num_chunks, num_threads, [&](size_t begin, size_t stop)
+                {
+                    for (size_t c = begin; c < stop; ++c)
+                        first_line[c + 1] = detail::countLines(bounds[c], bounds[c + 1]);
+                });
+    for (size_t c = 0; c < num_chunks; ++c)
+        first_line[c + 1] += first_line[c];
+
+    const size_t offset = batch.size();
+    const size_t num_lines = first_line[num_chunks];
+    detail::resizeRows(batch, offset + num_lines);
+
+    std::vector<uint8_t> keep(num_lines, 1);
+    std::vector<std::vector<MotParseError>> chunk_errors(num_chunks);
+
+    parallelFor(0, num_chunks, num_threads, [&](size_t begin, size_t stop)
+                {
+                    MotRecord record;
+                    for (size_t c = begin; c < stop; ++c)
+                    {
+                        size_t line = first_line[c];
+                        const char *first = bounds[c];
+                        const char *chunk_end = bounds[c + 1];
+                        while (first < chunk_end)
+                        {
+                            const void *newline = std::memchr(first, '\n', static_cast<size_t>(chunk_end - first));
+                            const char *last = newline ? static_cast<const char *>(newline) : chunk_end;
+
+                            if (skipBlanks(first, last) == last)
+                            {
+                                keep[line] = 0;
+                            }
+                            else if (parseMotRecord(first, last, record))
+                            {
+                                detail::writeMotRow(batch, offset + line, record);
+                            }
+                            else
+                            {
+                                keep[line] = 0;
+                                const char *text_end = first + std::min<ptrdiff_t>(last - first, 80);
+                                while (text_end > first && (text_end[-1] == '\r' || text_end[-1] == ' '))
+                                    --text_end;
+                                chunk_errors[c].push_back({line + 1, "Malformed MOT line: \"" + std::string(first, text_end) + "\""});
+                            }
+
+                            ++line;
+                            first = last < chunk_end ? last + 1 : last;
+                        }
+                    }
+                });
+
+    for (auto &chunk : chunk_errors)
+        errors.insert(errors.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+
+    size_t new_size = offset + num_lines;
+    if (std::find(keep.begin(), keep.end(), 0) != keep.end())
+    {
+        new_size = detail::compactRows(batch, offset, offset + num_lines, keep);
+        detail::resizeRows(batch, new_size);
+    }
+
+    return new_size - offset;
+}
+
+// Memory-map a MOTChallenge text file and append its rows to batch, see parseMot
+inline size_t loadMot(const std::string &path, DetectionBatch &batch, std::vector<MotParseError> &errors,
+                      size_t num_threads = 0)
+{
+    MappedFile file(path);
+    return parseMot(file.data(), file.size(), batch, errors, num_threads);
+}
+
+struct MotWriterParams
+{
+    size_t buffer_size{1 << 20}; // bytes formatted before a buffer is handed to the writer thread
+    size_t queue_capacity{8};    // buffers waiting to be written
+    QueuePolicy policy{QueuePolicy::Block};
+    int precision{6}; // significant digits of float fields, negative for shortest round-trip
+};
+
+// MOT text writer that formats with std::to_chars into reusable buffers
+// and writes them to disk from a background thread. Write calls must come from a single thread.
+class MotWriter
+{
+public:
+    struct Stats
+    {
+        size_t rows_written{0};
+        size_t rows_dropped{0};
+        size_t bytes_written{0};
+    };
+
+    explicit MotWriter(const std::string &path, const MotWriterParams &params = {})
+        : params_(params), file_(path, std::ios::binary | std::ios::trunc), queue_(params.queue_capacity, params.policy)
+    {
+        if (!file_)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        current_.data.resize(params_.buffer_size + MOT_MAX_LINE_SIZE);
+        worker_ = std::thread([this]()
+                              { run(); });
+    }
+
+    MotWriter(const MotWriter &) = delete;
+    MotWriter &operator=(const MotWriter &) = delete;
+
+    ~MotWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void write(const Detection &det)
+    {
+        MotRecord record;
+        record.frame_id = det.frame_id;
+        record.track_id = det.track_id;
+        record.x = det.bbox.x;
+        record.y = det.bbox.y;
+        record.width = det.bbox.width;
+        record.height = det.bbox.height;
+        record.confidence = det.confidence;
+        record.pos_x = det.position.x;
+        record.pos_y = det.position.y;
+        record.pos_z = det.position.z;
+        write(record);
+    }
+
+    void write(const std::vector<Detection> &detections)
+    {
+        for (const auto &det : detections)
+            write(det);
+    }
+
+    void write(const DetectionBatch &batch)
+    {
+        MotRecord record;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            record.frame_id = batch.frame_ids[i];
+            record.track_id = batch.track_ids[i];
+            record.x = batch.bboxes[i].x;
+            record.y = batch.bboxes[i].y;
+            record.width = batch.bboxes[i].width;
+            record.height = batch.bboxes[i].height;
+            record.confidence = batch.confidences[i];
+            record.pos_x = batch.positions[i].x;
+            record.pos_y = batch.positions[i].y;
+            record.pos_z = batch.positions[i].z;
+            write(record);
+        }
+    }
+
+    void write(const MotRecord &record)
+    {
+        checkError();
+        if (closed_)
+            throw std::runtime_error("MotWriter is closed");
+
+        char *first = current_.data.data() + current_.size;
+        char *last = formatMotRecord(first, first + MOT_MAX_LINE_SIZE, record, params_.precision);
+        current_.size += static_cast<size_t>(last - first);
+        ++current_.rows;
+
+        if (current_.size >= params_.buffer_size)
+            submit();
+    }
+
+    // Hand the pending buffer over and wait until everything queued so far is on disk
+    void flush()
+    {
+        drain();
+        checkError();
+    }
+
+    void close()
+    {
+        if (closed_)
+            return;
+
+        drain();
+        closed_ = true;
+        queue_.close();
+        worker_.join();
+        file_.close();
+        checkError();
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Buffer
+    {
+        std::vector<char> data{};
+        size_t size{0};
+        size_t rows{0};
+    };
+
+    void drain()
+    {
+        submit();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]()
+                   { return completed_ == submitted_; });
+    }
+
+    void submit()
+    {
+        if (current_.rows == 0)
+            return;
+
+        Buffer next = takeFreeBuffer();
+        std::swap(next, current_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++submitted_;
+        }
+
+        // Rejected or evicted buffers are counted as dropped rows and recycled
+        if (auto dropped = queue_.push(std::move(next)))
+            recycle(std::move(*dropped), false);
+    }
+
+    Buffer takeFreeBuffer()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Buffer buffer;
+        if (!free_.empty())
+        {
+            buffer = std::move(free_.back());
+            free_.pop_back();
+        }
+        else
+        {
+            buffer.data.resize(params_.buffer_size + MOT_MAX_LINE_SIZE);
+        }
+        return buffer;
+    }
+
+    void recycle(Buffer buffer, bool written)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (written)
+            {
+                stats_.rows_written += buffer.rows;
+                stats_.bytes_written += buffer.size;
+            }
+            else
+            {
+                stats_.rows_dropped += buffer.rows;
+            }
+            ++completed_;
+            buffer.size = 0;
+            buffer.rows = 0;
+            free_.push_back(std::move(buffer));
+        }
+        done_.notify_all();
+    }
+
+    void run()
+    {
+        Buffer buffer;
+        while (queue_.pop(buffer))
+        {
+            bool written = false;
+            if (!error_)
+            {
+                file_.write(buffer.data.data(), static_cast<std::streamsize>(buffer.size));
+                file_.flush();
+                written = static_cast<bool>(file_);
+                if (!written)
+                    error_ = true;
+            }
+            recycle(std::move(buffer), written);
+        }
+    }
+
+    void checkError()
+    {
+        if (error_)
+            throw std::runtime_error("Failed to write MOT file");
+    }
+
+    MotWriterParams params_;
+    std::ofstream file_;
+    BoundedQueue<Buffer> queue_;
+    Buffer current_{};
+    std::vector<Buffer> free_{};
+    Stats stats_{};
+    size_t submitted_{0};
+    size_t completed_{0};
+    std::atomic<bool> error_{false};
+    bool closed_{false};
+    mutable std::mutex mutex_;
+    std::condition_variable done_;
+    std::thread worker_;
+};
+
+struct MotReaderParams
+{
+    size_t buffer_size{1 << 16}; // bytes read from disk at a time, grown only for longer lines
+    bool verify_sorted{false};   // throw if frame_id decreases
+    size_t read_ahead{0};        // frames parsed ahead on a background thread, 0 parses on demand
+};
+
+// Streams a MOT file sorted by frame_id one frame at a time with constant memory.
+// Malformed lines are skipped and reported by errors().
+class MotFrameReader
+{
+public:
+    explicit MotFrameReader(const std::string &path, const MotReaderParams &params = {})
+        : params_(params), file_(path, std::ios::binary), buffer_(std::max<size_t>(params.buffer_size, 64))
+    {
+        if (!file_)
+            throw std::runtime_error("Failed to open file: " + path);
+
+        if (params_.read_ahead > 0)
+        {
+            ready_ = std::make_unique<BoundedQueue<DetectionBatch>>(params_.read_ahead);
+            spare_ = std::make_unique<BoundedQueue<DetectionBatch>>(params_.read_ahead + 1, QueuePolicy::DropNewest);
+            worker_ = std::thread([this]()
+                                  { readAhead(); });
+        }
+    }
+
+    MotFrameReader(const MotFrameReader &) = delete;
+    MotFrameReader &operator=(const MotFrameReader &) = delete;
+
+    ~MotFrameReader()
+    {
+        if (worker_.joinable())
+        {
+            ready_->close();
+            worker_.join();
+        }
+    }
+
+    // Replace the contents of frame with the rows of the next frame, false at the end of the file.
+    // Passing the same batch every time reuses its capacity.
+    bool next(DetectionBatch &frame)
+    {
+        if (!ready_)
+            return readFrame(frame);
+
+        DetectionBatch next_frame;
+        if (!ready_->pop(next_frame))
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (failure_)
+                std::rethrow_exception(failure_);
+            return false;
+        }
+
+        std::swap(frame, next_frame);
+        spare_->push(std::move(next_frame));
+        return true;
+    }
+
+    std::vector<MotParseError> errors() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return errors_;
+    }
+
+private:
+    void readAhead()
+    {
+        try
+        {
+            DetectionBatch frame;
+            while (true)
+            {
+                spare_->tryPop(frame);
+                if (!readFrame(frame) || ready_->push(std::move(frame)))
+                    break;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            failure_ = std::current_exception();
+        }
+        ready_->close();
+    }
+
+    bool readFrame(DetectionBatch &frame)
+    {
+        frame.clear();
+        if (!has_pending_ && !readRecord(pending_))
+            return false;
+
+        const int64_t frame_id = pending_.frame_id;
+        if (params_.verify_sorted && frame_id < last_frame_id_)
+            throw std::runtime_error("MOT file is not sorted by frame_id at line " + std::to_string(line_));
+        last_frame_id_ = frame_id;
+
+        do
+        {
+            const size_t row = frame.size();
+            detail::resizeRows(frame, row + 1);
+            detail::writeMotRow(frame, row, pending_);
+            has_pending_ = readRecord(pending_);
+        } while (has_pending_ && pending_.frame_id == frame_id);
+
+        return true;
+    }
+
+    bool readRecord(MotRecord &record)
+    {
+        const char *first, *last;
+        while (readLine(first, last))
+        {
+            ++line_;
+            if (skipBlanks(first, last) == last)
+                continue;
+            if (parseMotRecord(first, last, record))
+                return true;
+
+            const char *text_end = first + std::min<ptrdiff_t>(last - first, 80);
+            std::lock_guard<std::mutex> lock(mutex_);
+            errors_.push_back({line_, "Malformed MOT line: \"" + std::string(first, text_end) + "\""});
+        }
+        return false;
+    }
+
+    // The returned line stays valid until the next call
+    bool readLine(const char *&first, const char *&last)
+    {
+        while (true)
+        {
+            const void *newline = std::memchr(buffer_.data() + begin_, '\n', end_ - begin_);
+            if (newline != nullptr)
+            {
+                first = buffer_.data() + begin_;
+                last = static_cast<const char *>(newline);
+                begin_ = static_cast<size_t>(last - buffer_.data()) + 1;
+                return true;
+            }
+
+            if (eof_)
+            {
+                if (begin_ == end_)
+                    return false;
+                first = buffer_.data() + begin_;
+                last = buffer_.data() + end_;
+                begin_ = end_;
+                return true;
+            }
+
+            // Keep the partial line, grow only when a single line fills the whole buffer
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+            if (end_ == buffer_.size())
+                buffer_.resize(buffer_.size() * 2);
+
+            file_.read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+            end_ += static_cast<size_t>(file_.gcount());
+            eof_ = !file_;
+        }
+    }
+
+    MotReaderParams params_;
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    size_t begin_{0}, end_{0};
+    bool eof_{false};
+
+    size_t line_{0};
+    MotRecord pending_{};
+    bool has_pending_{false};
+    int64_t last_frame_id_{INT64_MIN};
+
+    std::vector<MotParseError> errors_{};
+    std::exception_ptr failure_{};
+    mutable std::mutex mutex_;
+    std::unique_ptr<BoundedQueue<DetectionBatch>> ready_{};
+    std::unique_ptr<BoundedQueue<DetectionBatch>> spare_{};
+    std::thread worker_{};
+};
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection.hpp>
+#include <types/detection_batch.hpp>
+#include <utils/geometry_utils.hpp>
+
+enum class NmsMode
+{
+    Greedy,  // hard suppression of overlapping lower-scored boxes
+    Batched, // greedy, classes separated by offsetting boxes per class_id
+    Soft,    // Soft-NMS, overlapping scores decay instead of being removed
+    Matrix   // Matrix NMS, all decays computed in parallel from the sorted IoU rows
+};
+
+enum class NmsDecay
+{
+    Linear,  // score * (1 - iou)
+    Gaussian // score * exp(-iou^2 / sigma)
+};
+
+struct NmsParams
+{
+    NmsMode mode{NmsMode::Greedy};
+    NmsDecay decay{NmsDecay::Linear}; // Soft and Matrix modes
+    bool class_agnostic{false};       // ignored by Batched, which is always class-aware
+    float iou_threshold{0.45f};
+    float score_threshold{0.25f};
+    float sigma{0.5f};
+    size_t max_det{300};
+    size_t max_candidates{0}; // keep only the top scored candidates before suppression, 0 keeps all
+};
+
+// Candidates of nms() in score order with their IoU, decay and suppression state, one per inference thread
+struct NmsWorkspace
+{
+    std::vector<int> order{};
+    std::vector<cv::Rect2f> boxes{};
+    std::vector<float> scores{};
+    std::vector<int> classes{};
+    std::vector<float> iou{};
+    std::vector<float> decay{};
+    std::vector<float> compensate{};
+    std::vector<uint8_t> suppressed{};
+    std::vector<int> ranks{};
+    std::vector<float> top_scores{};
+    BoxArray columns{};
+};
+
+namespace detail
+{
+
+    inline float nmsDecay(float iou, const NmsParams &params)
+    {
+        if (params.decay == NmsDecay::Gaussian)
+            return std::exp(-(iou * iou) / params.sigma);
+        return 1.f - iou;
+    }
+
+    // Select candidates above the score threshold, sorted by decreasing score (within each class when grouped)
+    inline size_t nmsPrepare(const cv::Rect2f *boxes, const float *scores, const int *class_ids, size_t size,
+                             const NmsParams &params, bool group_by_class, NmsWorkspace &ws)
+    {
+        ws.order.clear();
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (scores[i] >= params.score_threshold)
+                ws.order.push_back(static_cast<int>(i));
+        }
+
+        auto by_score = [scores](int a, int b)
+        { return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); };
+
+        if (params.max_candidates > 0 && ws.order.size() > params.max_candidates)
+        {
+            std::nth_element(ws.order.begin(), ws.order.begin() + params.max_candidates, ws.order.end(), by_score);
+            ws.order.resize(params.max_candidates);
+        }
+
+        if (group_by_class && class_ids)
+        {
+            std::sort(ws.order.begin(), ws.order.end(), [class_ids, &by_score](int a, int b)
+                      { return class_ids[a] < class_ids[b] || (class_ids[a] == class_ids[b] && by_score(a, b)); });
+        }
+        else
+        {
+            std::sort(ws.order.begin(), ws.order.end(), by_score);
+        }
+
+        const size_t n = ws.order.size();
+        ws.boxes.resize(n);
+        ws.scores.resize(n);
+        ws.classes.resize(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            int i = ws.order[k];
+            ws.boxes[k] = boxes[i];
+            ws.scores[k] = scores[i];
+            ws.classes[k] = class_ids ? class_ids[i] : 0;
+        }
+        ws.iou.resize(n);
+        return n;
+    }
+
+    // Greedy suppression, candidates of each class are contiguous unless class agnostic,
+    // so rows only span the boxes they can suppress
+    inline void nmsGreedy(size_t n, bool class_agnostic, const NmsParams &params, NmsWorkspace &ws,
+                          std::vector<int> &keep, std::vector<float> &keep_scores)
+    {
+        ws.columns.assign(ws.boxes.data(), n);
+        ws.suppressed.assign(n, 0);
+        ws.ranks.clear();
+        // Min-heap of the best max_det scores kept so far over all classes: a class stops as soon as
+        // its next candidate scores below all of them, as no lower candidate of it can be output
+        ws.top_scores.clear();
+
+        for (size_t begin = 0, end = 0; begin < n; begin = end)
+        {
+            end = class_agnostic ? n : begin + 1;
+            while (end < n && ws.classes[end] == ws.classes[begin])
+                ++end;
+
+            size_t kept = 0;
+            for (size_t i = begin; i < end && kept < params.max_det; ++i)
+            {
+                if (ws.suppressed[i])
+                    continue;
+                if (!class_agnostic && ws.top_scores.size() == params.max_det && ws.scores[i] < ws.top_scores.front())
+                    break;
+
+                ws.ranks.push_back(static_cast<int>(i));
+                ++kept;
+                if (!class_agnostic)
+                {
+                    if (ws.top_scores.size() == params.max_det)
+                    {
+                        std::pop_heap(ws.top_scores.begin(), ws.top_scores.end(), std::greater<float>());
+                        ws.top_scores.pop_back();
+                    }
+                    ws.top_scores.push_back(ws.scores[i]);
+                    std::push_heap(ws.top_scores.begin(), ws.top_scores.end(), std::greater<float>());
+                }
+
+                getIoURow(ws.boxes[i], ws.columns, i + 1, end, ws.iou.data());
+                const float *iou = ws.iou.data();
+                for (size_t j = i + 1; j < end; ++j)
+                {
+                    if (iou[j - i - 1] > params.iou_threshold)
+                        ws.suppressed[j] = 1;
+                }
+            }
+        }
+
+        // Merge the per-class survivors back into global score order
+        if (!class_agnostic)
+        {
+            std::sort(ws.ranks.begin(), ws.ranks.end(), [&ws](int a, int b)
+                      { return ws.scores[a] > ws.scores[b] || (ws.scores[a] == ws.scores[b] && ws.order[a] < ws.order[b]); });
+        }
+
+        for (size_t k = 0; k < ws.ranks.size() && keep.size() < params.max_det; ++k)
+        {
+            keep.push_back(ws.order[ws.ranks[k]]);
+            keep_scores.push_back(ws.scores[ws.ranks[k]]);
+        }
+    }
+
+    inline void nmsSoft(size_t n, const NmsParams &params, NmsWorkspace &ws,
+                        std::vector<int> &keep, std::vector<float> &keep_scores)
+    {
+        ws.columns.assign(ws.boxes.data(), n);
+
+        auto swap_candidates = [&ws](size_t a, size_t b)
+        {
+            std::swap(ws.order[a], ws.order[b]);
+            std::swap(ws.boxes[a], ws.boxes[b]);
+            std::swap(ws.scores[a], ws.scores[b]);
+            std::swap(ws.classes[a], ws.classes[b]);
+            std::swap(ws.columns.x1[a], ws.columns.x1[b]);
+            std::swap(ws.columns.y1[a], ws.columns.y1[b]);
+            std::swap(ws.columns.x2[a], ws.columns.x2[b]);
+            std::swap(ws.columns.y2[a], ws.columns.y2[b]);
+            std::swap(ws.columns.area[a], ws.columns.area[b]);
+        };
+
+        // Candidates [i, n) are still alive, the best of them is moved to i at each step
+        for (size_t i = 0; i < n && keep.size() < params.max_det; ++i)
+        {
+            size_t best = i;
+            for (size_t j = i + 1; j < n; ++j)
+            {
+                if (ws.scores[j] > ws.scores[best])
+                    best = j;
+            }
+            swap_candidates(i, best);
+
+            keep.push_back(ws.order[i]);
+            keep_scores.push_back(ws.scores[i]);
+
+            getIoURow(ws.boxes[i], ws.columns, i + 1, n, ws.iou.data());
+            const float *iou = ws.iou.data();
+            for (size_t j = i + 1; j < n; ++j)
+            {
+                if (!params.class_agnostic && ws.classes[j] != ws.classes[i])
+                    continue;
+                float overlap = iou[j - i - 1];
+                if (params.decay == NmsDecay::Linear && overlap <= params.iou_threshold)
+                    continue;
+                ws.scores[j] *= nmsDecay(overlap, params);
+            }
+
+            // Drop candidates that decayed below the score threshold
+            for (size_t j = i + 1; j < n;)
+            {
+                if (ws.scores[j] < params.score_threshold)
+                    swap_candidates(j, --n);
+                else
+                    ++j;
+            }
+        }
+    }
+
+    inline void nmsMatrix(size_t n, const NmsParams &params, NmsWorkspace &ws,
+                          std::vector<int> &keep, std::vector<float> &keep_scores)
+    {
+        ws.columns.assign(ws.boxes.data(), n);
+        ws.decay.assign(n, 1.f);
+        ws.compensate.assign(n, 0.f);
+
+        // Row i only needs the IoU of i with higher-scored boxes (its compensation), which is final once rows [0, i) are done
+        for (size_t i = 0; i < n; ++i)
+        {
+            getIoURow(ws.boxes[i], ws.columns, i + 1, n, ws.iou.data());
+            const float *iou = ws.iou.data();
+            const float compensation = nmsDecay(ws.compensate[i], params);
+
+            for (size_t j = i + 1; j < n; ++j)
+            {
+                if (!params.class_agnostic && ws.classes[j] != ws.classes[i])
+                    continue;
+                float overlap = iou[j - i - 1];
+                ws.decay[j] = std::min(ws.decay[j], nmsDecay(overlap, params) / std::max(compensation, EPSILON));
+                ws.compensate[j] = std::max(ws.compensate[j], overlap);
+            }
+        }
+
+        size_t alive = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            float score = ws.scores[i] * ws.decay[i];
+            if (score >= params.score_threshold)
+            {
+                ws.order[alive] = ws.order[i];
+                ws.scores[alive] = score;
+                ++alive;
+            }
+        }
+
+        ws.ranks.resize(alive);
+        std::iota(ws.ranks.begin(), ws.ranks.end(), 0);
+        std::stable_sort(ws.ranks.begin(), ws.ranks.end(), [&ws](int a, int b)
+                         { return ws.scores[a] > ws.scores[b]; });
+
+        for (size_t k = 0; k < alive && keep.size() < params.max_det; ++k)
+        {
+            keep.push_back(ws.order[ws.ranks[k]]);
+            keep_scores.push_back(ws.scores[ws.ranks[k]]);
+        }
+    }
+
+} // namespace detail
+
+// Non-maximum suppression over parallel box/score/class arrays (class_ids may be null).
+// Fills keep with input indices ordered by decreasing score, and keep_scores with their (decayed) scores.
+inline size_t nms(const cv::Rect2f *boxes, const float *scores, const int *class_ids, size_t size,
+                  const NmsParams &params, NmsWorkspace &ws, std::vector<int> &keep, std::vector<float> &keep_scores)
+{
+    keep.clear();
+    keep_scores.clear();
+
+    const bool group_by_class = params.mode == NmsMode::Greedy && !params.class_agnostic;
+    size_t n = detail::nmsPrepare(boxes, scores, class_ids, size, params, group_by_class, ws);
+    if (n == 0)
+        return 0;
+
+    switch (params.mode)
+    {
+    case NmsMode::Batched:
+    {
+        // Offset every class into its own disjoint region so a single class-agnostic pass is class-aware
+        float max_coord = 0.f;
+        for (const auto &box : ws.boxes)
+        {
+            max_coord = std::max({max_coord, std::abs(box.x), std::abs(box.y), std::abs(box.x + box.width), std::abs(box.y + box.height)});
+        }
+        const float stride = 2.f * max_coord + 1.f;
+        for (size_t k = 0; k < n; ++k)
+        {
+            float offset = static_cast<float>(ws.classes[k]) * stride;
+            ws.boxes[k].x += offset;
+            ws.boxes[k].y += offset;
+        }
+        detail::nmsGreedy(n, true, params, ws, keep, keep_scores);
+        break;
+    }
+    case NmsMode::Soft:
+        detail::nmsSoft(n, params, ws, keep, keep_scores);
+        break;
+    case NmsMode::Matrix:
+        detail::nmsMatrix(n, params, ws, keep, keep_scores);
+        break;
+    default:
+        detail::nmsGreedy(n, !group_by_class, params, ws, keep, keep_scores);
+        break;
+    }
+
+    return keep.size();
+}
+
+template <typename BoxAlloc = std::allocator<cv::Rect2f>, typename ScoreAlloc = std::allocator<float>, typename ClassAlloc = std::allocator<int>>
+inline std::vector<int> nms(const std::vector<cv::Rect2f, BoxAlloc> &boxes, const std::vector<float, ScoreAlloc> &scores,
+                            const std::vector<int, ClassAlloc> &class_ids, const NmsParams &params = NmsParams())
+{
+    if (boxes.size() != scores.size() || (!class_ids.empty() && class_ids.size() != boxes.size()))
+    {
+        throw std::invalid_argument("Boxes, scores and class ids must be the same size");
+    }
+
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+    nms(boxes.data(), scores.data(), class_ids.empty() ? nullptr : class_ids.data(), boxes.size(), params, ws, keep, keep_scores);
+    return keep;
+}
+
+inline size_t nms(const DetectionBatch &batch, const NmsParams &params, NmsWorkspace &ws,
+                  std::vector<int> &keep, std::vector<float> &keep_scores)
+{
+    return nms(batch.bboxes.data(), batch.confidences.data(), batch.class_ids.data(), batch.size(), params, ws, keep, keep_scores);
+}
+
+// Surviving detections ordered by decreasing score, confidences are updated by Soft and Matrix modes
+inline std::vector<Detection> nms(const std::vector<Detection> &detections, const NmsParams &params = NmsParams())
+{
+    std::vector<cv::Rect2f> boxes;
+    std::vector<float> scores;
+    std::vector<int> class_ids;
+    boxes.reserve(detections.size());
+    scores.reserve(detections.size());
+    class_ids.reserve(detections.size());
+    for (const auto &det : detections)
+    {
+        boxes.push_back(det.bbox);
+        scores.push_back(det.confidence);
+        class_ids.push_back(det.class_id);
+    }
+
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+    nms(boxes.data(), scores.data(), class_ids.data(), boxes.size(), params, ws, keep, keep_scores);
+
+    std::vector<Detection> result;
+    result.reserve(keep.size());
+    for (size_t k = 0; k < keep.size(); ++k)
+    {
+        result.push_back(detections[keep[k]]);
+        result.back().confidence = keep_scores[k];
+    }
+    return result;
+}
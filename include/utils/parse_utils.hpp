@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <charconv>
+#include <algorithm>
+#include <initializer_list>
+#include <system_error>
+#include <type_traits>
+
+// One line of a MOTChallenge text file:
+// frame_id,track_id,x,y,width,height,confidence,pos_x,pos_y,pos_z
+struct MotRecord
+{
+    int64_t frame_id{-1};
+    int64_t track_id{-1};
+    float x{0.f}, y{0.f}, width{0.f}, height{0.f};
+    float confidence{0.f};
+    float pos_x{0.f}, pos_y{0.f}, pos_z{0.f};
+};
+
+inline const char *skipBlanks(const char *first, const char *last)
+{
+    while (first < last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        ++first;
+    return first;
+}
+
+// Parse one numeric field with std::from_chars (locale independent, no allocation) and
+// advance first past the following delimiter. Integer fields tolerate a fractional part ("3.0").
+template <typename T>
+inline bool parseField(const char *&first, const char *last, T &value, char delimiter = ',')
+{
+    first = skipBlanks(first, last);
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc())
+        return false;
+
+    if constexpr (std::is_integral_v<T>)
+    {
+        if (ptr < last && *ptr == '.')
+        {
+            do
+                ++ptr;
+            while (ptr < last && *ptr >= '0' && *ptr <= '9');
+        }
+    }
+
+    first = skipBlanks(ptr, last);
+    if (first == last)
+        return true;
+    if (*first != delimiter)
+        return false;
+    ++first;
+    return true;
+}
+
+// Parse a full MOT line (without its newline), all ten fields are required
+inline bool parseMotRecord(const char *first, const char *last, MotRecord &record)
+{
+    return parseField(first, last, record.frame_id) && first < last &&
+           parseField(first, last, record.track_id) && first < last &&
+           parseField(first, last, record.x) && first < last &&
+           parseField(first, last, record.y) && first < last &&
+           parseField(first, last, record.width) && first < last &&
+           parseField(first, last, record.height) && first < last &&
+           parseField(first, last, record.confidence) && first < last &&
+           parseField(first, last, record.pos_x) && first < last &&
+           parseField(first, last, record.pos_y) && first < last &&
+           parseField(first, last, record.pos_z) && skipBlanks(first, last) == last;
+}
+
+// Upper bound on the bytes formatMotRecord writes for one line
+constexpr size_t MOT_MAX_LINE_SIZE = 10 * 32;
+
+// Format one numeric field like printf("%.*g"), a negative precision gives the shortest
+// representation that round-trips. Returns the end of the written characters.
+template <typename T>
+inline char *formatField(char *first, char *last, T value, int precision = 6)
+{
+    if constexpr (std::is_integral_v<T>)
+        return std::to_chars(first, last, value).ptr;
+    else if (precision < 0)
+        return std::to_chars(first, last, value).ptr;
+    else
+        return std::to_chars(first, last, value, std::chars_format::general, std::min(precision, 9)).ptr;
+}
+
+// Format a MOT line followed by a newline into [first, last), which must hold MOT_MAX_LINE_SIZE bytes.
+// With the default precision the output matches operator<<(std::ostream &, const Detection &).
+inline char *formatMotRecord(char *first, char *last, const MotRecord &record, int precision = 6)
+{
+    first = formatField(first, last, record.frame_id);
+    *first++ = ',';
+    first = formatField(first, last, record.track_id);
+    for (float value : {record.x, record.y, record.width, record.height, record.confidence,
+                        record.pos_x, record.pos_y, record.pos_z})
+    {
+        *first++ = ',';
+        first = formatField(first, last, value, precision);
+    }
+    *first++ = '\n';
+    return first;
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <opencv2/opencv.hpp>
+
+#include <types/frame.hpp>
+#include <utils/detection_utils.hpp>
+#include <utils/quantize_utils.hpp>
+#include <utils/thread_utils.hpp>
+
+// Per-channel normalization value = (pixel - mean) * scale / std, applied after the optional
+// BGR to RGB swap, so mean and std are given in the output channel order (as for blobFromImage)
+struct TensorParams
+{
+    bool swap_rb{true};
+    float scale{1.f / 255.f};
+    cv::Scalar mean{0, 0, 0};
+    cv::Scalar std{1, 1, 1};
+};
+
+namespace detail
+{
+    // Scratch reused across calls on the same thread
+    struct LetterboxScratch
+    {
+        std::vector<int> x_offsets[2]; // byte offsets (3 * column) of the two source pixels per output column
+        std::vector<float> x_weights;  // weight of the right source pixel
+        std::vector<float> rows[2];    // horizontally resampled source rows, planar per channel
+        std::vector<float> out_row;    // one output plane row before fp16 conversion
+        int row_index[2]{-1, -1};      // source row held by rows[i]
+    };
+
+    inline LetterboxScratch &letterboxScratch()
+    {
+        thread_local LetterboxScratch scratch;
+        return scratch;
+    }
+
+    template <typename T>
+    inline void storeTensorRow(const float *values, size_t size, T *out)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            std::copy(values, values + size, out);
+        else
+            quantize::toHalf(values, size, out);
+    }
+
+    template <typename T>
+    inline void fillTensor(T *out, size_t size, float value)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            std::fill(out, out + size, value);
+        else
+            std::fill(out, out + size, quantize::floatToHalf(value));
+    }
+
+    // Bilinear resize with half-pixel centers (cv::INTER_LINEAR), channel swap, normalization
+    // and HWC to CHW in one pass over the output, with the padding written directly.
+    // Only output rows [row_begin, row_end) are written, so bands of one image can run on different threads.
+    template <typename T>
+    inline void letterboxToTensor(const cv::Mat &input, const LetterboxInfo &info, const cv::Scalar &color,
+                                  const TensorParams &params, T *tensor, int row_begin = 0, int row_end = INT_MAX)
+    {
+        if (input.empty() || input.type() != CV_8UC3)
+            throw std::invalid_argument("Tensor preprocessing requires a non-empty CV_8UC3 image");
+
+        const int width = info.shape.width, height = info.shape.height;
+        const int resized_width = info.resized.width, resized_height = info.resized.height;
+        const size_t plane = static_cast<size_t>(width) * height;
+
+        float gain[3], bias[3];
+        int source_channel[3];
+        for (int c = 0; c < 3; ++c)
+        {
+            gain[c] = static_cast<float>(params.scale / params.std[c]);
+            bias[c] = static_cast<float>(-params.mean[c] * params.scale / params.std[c]);
+            source_channel[c] = params.swap_rb ? 2 - c : c;
+        }
+
+        LetterboxScratch &scratch = letterboxScratch();
+        scratch.x_offsets[0].resize(resized_width);
+        scratch.x_offsets[1].resize(resized_width);
+        scratch.x_weights.resize(resized_width);
+        scratch.rows[0].resize(3 * static_cast<size_t>(resized_width));
+        scratch.rows[1].resize(3 * static_cast<size_t>(resized_width));
+        scratch.out_row.resize(std::max(width, 1));
+        scratch.row_index[0] = scratch.row_index[1] = -1;
+
+        detail::bilinearColumns(0, resized_width, static_cast<float>(input.cols) / resized_width, 0.f, input.cols,
+                                scratch.x_offsets[0].data(), scratch.x_offsets[1].data(), scratch.x_weights.data());
+        for (int x = 0; x < resized_width; ++x)
+        {
+            scratch.x_offsets[0][x] *= 3;
+            scratch.x_offsets[1][x] *= 3;
+        }
+
+        auto resampleRow = [&](int source_y, int slot)
+        {
+            if (scratch.row_index[slot] == source_y)
+                return;
+            if (scratch.row_index[1 - slot] == source_y)
+            {
+                // Moving down the image the bottom row becomes the next top row,
+                // on the last row both slots hold the same source row
+                if (slot == 0)
+                {
+                    std::swap(scratch.rows[0], scratch.rows[1]);
+                    std::swap(scratch.row_index[0], scratch.row_index[1]);
+                }
+                else
+                {
+                    scratch.rows[1] = scratch.rows[0];
+                    scratch.row_index[1] = source_y;
+                }
+                return;
+            }
+
+            const uchar *row = input.ptr<uchar>(source_y);
+            for (int c = 0; c < 3; ++c)
+            {
+                const uchar *channel = row + source_channel[c];
+                float *out = scratch.rows[slot].data() + static_cast<size_t>(c) * resized_width;
+                for (int x = 0; x < resized_width; ++x)
+                {
+                    const float left = channel[scratch.x_offsets[0][x]];
+                    const float right = channel[scratch.x_offsets[1][x]];
+                    out[x] = left + (right - left) * scratch.x_weights[x];
+                }
+            }
+            scratch.row_index[slot] = source_y;
+        };
+
+        float padding[3];
+        for (int c = 0; c < 3; ++c)
+            padding[c] = static_cast<float>(color[source_channel[c]]) * gain[c] + bias[c];
+
+        row_begin = std::max(row_begin, 0);
+        row_end = std::min(row_end, height);
+        const int top_end = std::min(row_end, info.top);
+        const int bottom_begin = std::max(row_begin, info.top + resized_height);
+        for (int c = 0; c < 3; ++c)
+        {
+            T *channel = tensor + c * plane;
+            if (row_begin < top_end)
+                fillTensor(channel + static_cast<size_t>(row_begin) * width,
+                           static_cast<size_t>(top_end - row_begin) * width, padding[c]);
+            if (bottom_begin < row_end)
+                fillTensor(channel + static_cast<size_t>(bottom_begin) * width,
+                           static_cast<size_t>(row_end - bottom_begin) * width, padding[c]);
+        }
+
+        const float inv_y = static_cast<float>(input.rows) / resized_height;
+        float *out_row = scratch.out_row.data();
+        const int content_end = std::min(row_end - info.top, resized_height);
+        for (int y = std::max(row_begin - info.top, 0); y < content_end; ++y)
+        {
+            const float source_y = std::max((y + 0.5f) * inv_y - 0.5f, 0.f);
+            const int y0 = std::min(static_cast<int>(source_y), input.rows - 1);
+            const int y1 = std::min(y0 + 1, input.rows - 1);
+            const float weight = source_y - static_cast<float>(y0);
+            resampleRow(y0, 0);
+            resampleRow(y1, 1);
+
+            for (int c = 0; c < 3; ++c)
+            {
+                const float *top = scratch.rows[0].data() + static_cast<size_t>(c) * resized_width;
+                const float *bottom = scratch.rows[1].data() + static_cast<size_t>(c) * resized_width;
+                std::fill(out_row, out_row + info.left, padding[c]);
+                float *content = out_row + info.left;
+                for (int x = 0; x < resized_width; ++x)
+                    content[x] = (top[x] + (bottom[x] - top[x]) * weight) * gain[c] + bias[c];
+                std::fill(content + resized_width, out_row + width, padding[c]);
+
+                storeTensorRow(out_row, width, tensor + c * plane + static_cast<size_t>(info.top + y) * width);
+            }
+        }
+    }
+} // namespace detail
+
+// Number of values letterboxToTensor writes for an input of the given size
+inline size_t getTensorSize(cv::Size input_size, const LetterboxParams &params)
+{
+    const LetterboxInfo info = getLetterboxInfo(input_size, params);
+    return 3 * static_cast<size_t>(info.shape.area());
+}
+
+// Letterbox a CV_8UC3 image straight into a caller-owned planar CHW float tensor of
+// getTensorSize() values, equivalent to letterbox() followed by cv::dnn::blobFromImage()
+// up to rounding, without intermediate images. Returns the mapping back to input coordinates.
+inline LetterboxInfo letterboxToTensor(const cv::Mat &input, float *tensor, const LetterboxParams &letterbox_params = {},
+                                       const TensorParams &tensor_params = {})
+{
+    const LetterboxInfo info = getLetterboxInfo(input.size(), letterbox_params);
+    detail::letterboxToTensor(input, info, letterbox_params.color, tensor_params, tensor);
+    return info;
+}
+
+// Same, writing IEEE fp16 values for half-precision models
+inline LetterboxInfo letterboxToTensor(const cv::Mat &input, uint16_t *tensor, const LetterboxParams &letterbox_params = {},
+                                       const TensorParams &tensor_params = {})
+{
+    const LetterboxInfo info = getLetterboxInfo(input.size(), letterbox_params);
+    detail::letterboxToTensor(input, info, letterbox_params.color, tensor_params, tensor);
+    return info;
+}
+
+struct BatchPreprocessParams
+{
+    LetterboxParams letterbox{};  // new_shape is the tensor size, auto_size is not allowed
+    TensorParams tensor{};
+    size_t num_threads{0};        // worker pool size, 0 = hardware threads
+    int min_band_rows{32};        // smallest row band handed to one task when splitting large images
+};
+
+// Letterboxes a batch of images into one NCHW tensor on a fixed worker pool. Small batches
+// are split into row bands as well as images so all threads stay busy. The pool is reused across
+// calls; process() is serialized, use one instance per inference thread.
+class BatchPreprocessor
+{
+public:
+    explicit BatchPreprocessor(const BatchPreprocessParams &params = {})
+        : params_(params), pool_(params.num_threads)
+    {
+        if (params_.letterbox.auto_size)
+            throw std::invalid_argument("Batch preprocessing needs a fixed shape, auto_size is not supported");
+        if (params_.letterbox.new_shape.width <= 0 || params_.letterbox.new_shape.height <= 0)
+            throw std::invalid_argument("Batch preprocessing needs a positive new_shape");
+        params_.min_band_rows = std::max(params_.min_band_rows, 1);
+    }
+
+    // Values per image in the batch tensor, 3 * height * width
+    size_t imageSize() const { return 3 * static_cast<size_t>(params_.letterbox.new_shape.area()); }
+
+    size_t tensorSize(size_t batch_size) const { return batch_size * imageSize(); }
+
+    size_t numThreads() const { return pool_.size(); }
+
+    const BatchPreprocessParams &params() const { return params_; }
+
+    // Fill tensor (tensorSize(images.size()) values) and return where each image landed
+    std::vector<LetterboxInfo> process(const std::vector<cv::Mat> &images, float *tensor)
+    {
+        return run(images.size(), [&images](size_t i) -> const cv::Mat &
+                   { return images[i]; }, tensor);
+    }
+
+    std::vector<LetterboxInfo> process(const std::vector<cv::Mat> &images, uint16_t *tensor)
+    {
+        return run(images.size(), [&images](size_t i) -> const cv::Mat &
+                   { return images[i]; }, tensor);
+    }
+
+    std::vector<LetterboxInfo> process(const std::vector<Frame> &frames, float *tensor)
+    {
+        return run(frames.size(), [&frames](size_t i) -> const cv::Mat &
+                   { return frames[i].image; }, tensor);
+    }
+
+    std::vector<LetterboxInfo> process(const std::vector<Frame> &frames, uint16_t *tensor)
+    {
+        return run(frames.size(), [&frames](size_t i) -> const cv::Mat &
+                   { return frames[i].image; }, tensor);
+    }
+
+private:
+    template <typename ImageAt, typename T>
+    std::vector<LetterboxInfo> run(size_t batch_size, ImageAt image_at, T *tensor)
+    {
+        std::vector<LetterboxInfo> infos(batch_size);
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            const cv::Mat &image = image_at(i);
+            if (image.empty() || image.type() != CV_8UC3)
+                throw std::invalid_argument("Tensor preprocessing requires a non-empty CV_8UC3 image");
+            infos[i] = getLetterboxInfo(image.size(), params_.letterbox);
+        }
+        if (batch_size == 0)
+            return infos;
+
+        // Enough tasks for about four per thread, never bands thinner than min_band_rows
+        const int height = params_.letterbox.new_shape.height;
+        const size_t wanted = (4 * pool_.size() + batch_size - 1) / batch_size;
+        const size_t max_bands = static_cast<size_t>(std::max(height / params_.min_band_rows, 1));
+        const size_t bands = std::min(wanted, max_bands);
+        const int band_rows = static_cast<int>((static_cast<size_t>(height) + bands - 1) / bands);
+
+        const size_t image_size = imageSize();
+        pool_.run(batch_size * bands, [&](size_t task)
+                  {
+                      const size_t i = task / bands;
+                      const int row_begin = static_cast<int>(task % bands) * band_rows;
+                      detail::letterboxToTensor(image_at(i), infos[i], params_.letterbox.color, params_.tensor,
+                                                tensor + i * image_size, row_begin, row_begin + band_rows);
+                  });
+        return infos;
+    }
+
+    BatchPreprocessParams params_;
+    ThreadPool pool_;
+};
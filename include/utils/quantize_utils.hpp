@@ -0,0 +1,372 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include <utils/simd_utils.hpp>
+#include <utils/vector_utils.hpp>
+#include <utils/geometry_utils.hpp>
+
+// Compact storage for ReID features: IEEE fp16 (2 bytes per value) and symmetric
+// per-vector int8 with a float scale (1 byte per value). Dot products run directly on
+// the quantized data, fp16 through F16C and int8 with int32 accumulation, with kernels
+// picked by simd::level() like vector_ops.
+namespace quantize
+{
+
+    // Round to nearest even, overflow saturates to inf, NaN becomes a quiet NaN
+    inline uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t half;
+        if (bits >= 0x47800000u) // >= 65536 rounds to inf, or inf / NaN already
+        {
+            half = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+        }
+        else if (bits < 0x38800000u) // below the smallest normal half, let the FPU round the subnormal
+        {
+            const uint32_t magic_bits = 0x3f000000u; // 0.5f shifts the subnormal mantissa into the low bits
+            float magic, shifted;
+            std::memcpy(&magic, &magic_bits, sizeof(magic));
+            std::memcpy(&shifted, &bits, sizeof(shifted));
+            shifted += magic;
+            std::memcpy(&bits, &shifted, sizeof(bits));
+            half = static_cast<uint16_t>(bits - magic_bits);
+        }
+        else
+        {
+            const uint32_t odd = (bits >> 13) & 1u;
+            bits += 0xc8000fffu + odd; // rebias the exponent from 127 to 15 and round
+            half = static_cast<uint16_t>(bits >> 13);
+        }
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    inline float halfToFloat(uint16_t half)
+    {
+        uint32_t bits = static_cast<uint32_t>(half & 0x7fffu) << 13;
+        const uint32_t exponent = bits & 0x0f800000u;
+        bits += 0x38000000u; // rebias the exponent from 15 to 127
+
+        float value;
+        if (exponent == 0x0f800000u) // inf / NaN
+        {
+            bits += 0x38000000u;
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+        else if (exponent == 0) // zero / subnormal, renormalize through the FPU
+        {
+            bits += 0x00800000u;
+            const uint32_t magic_bits = 0x38800000u;
+            float magic;
+            std::memcpy(&magic, &magic_bits, sizeof(magic));
+            std::memcpy(&value, &bits, sizeof(value));
+            value -= magic;
+        }
+        else
+        {
+            std::memcpy(&value, &bits, sizeof(value));
+        }
+        return (half & 0x8000u) ? -value : value;
+    }
+
+    namespace detail
+    {
+#ifdef VISION_CORE_X86_SIMD
+
+        VISION_CORE_TARGET("avx2,fma,f16c") inline void toHalfF16c(const float *vec, size_t size, uint16_t *out, size_t &i)
+        {
+            for (i = 0; i + 8 <= size; i += 8)
+            {
+                __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(vec + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), half);
+            }
+        }
+
+        VISION_CORE_TARGET("avx2,fma,f16c") inline void fromHalfF16c(const uint16_t *vec, size_t size, float *out, size_t &i)
+        {
+            for (i = 0; i + 8 <= size; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(vec + i))));
+        }
+
+        VISION_CORE_AVX512_WARNINGS_PUSH
+
+        VISION_CORE_TARGET("avx512f") inline float dotHalfAvx512(const uint16_t *a, const uint16_t *b, size_t size, size_t &i)
+        {
+            __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+            for (i = 0; i + 32 <= size; i += 32)
+            {
+                __m512 a0 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)));
+                __m512 b0 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+                __m512 a1 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i + 16)));
+                __m512 b1 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i + 16)));
+                acc0 = _mm512_fmadd_ps(a0, b0, acc0);
+                acc1 = _mm512_fmadd_ps(a1, b1, acc1);
+            }
+            for (; i + 16 <= size; i += 16)
+            {
+                __m512 a0 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)));
+                __m512 b0 = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+                acc0 = _mm512_fmadd_ps(a0, b0, acc0);
+            }
+            return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+        }
+
+        VISION_CORE_AVX512_WARNINGS_POP
+
+        VISION_CORE_TARGET("avx2,fma,f16c") inline float dotHalfAvx2(const uint16_t *a, const uint16_t *b, size_t size, size_t &i)
+        {
+            __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+            for (i = 0; i + 16 <= size; i += 16)
+            {
+                __m256 a0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+                __m256 b0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+                __m256 a1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i + 8)));
+                __m256 b1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i + 8)));
+                acc0 = _mm256_fmadd_ps(a0, b0, acc0);
+                acc1 = _mm256_fmadd_ps(a1, b1, acc1);
+            }
+            for (; i + 8 <= size; i += 8)
+            {
+                __m256 a0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+                __m256 b0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+                acc0 = _mm256_fmadd_ps(a0, b0, acc0);
+            }
+            return simd::hsum(_mm256_add_ps(acc0, acc1));
+        }
+
+        // Sign-extend to 16 bits and multiply-add pairs into int32 lanes. Products of values in
+        // [-127, 127] stay below 2^15, so a lane overflows only past 2^31 / 16129 pairs.
+        VISION_CORE_TARGET("avx2") inline int32_t dotInt8Avx2(const int8_t *a, const int8_t *b, size_t size, size_t &i)
+        {
+            __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+            for (i = 0; i + 32 <= size; i += 32)
+            {
+                __m256i a0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+                __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+                __m256i a1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i + 16)));
+                __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i + 16)));
+                acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(a0, b0));
+                acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(a1, b1));
+            }
+            for (; i + 16 <= size; i += 16)
+            {
+                __m256i a0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+                __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+                acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(a0, b0));
+            }
+            __m256i acc = _mm256_add_epi32(acc0, acc1);
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(sum);
+        }
+
+        VISION_CORE_TARGET("sse4.1") inline int32_t dotInt8Sse4(const int8_t *a, const int8_t *b, size_t size, size_t &i)
+        {
+            __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+            for (i = 0; i + 16 <= size; i += 16)
+            {
+                __m128i a0 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i)));
+                __m128i b0 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i)));
+                __m128i a1 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i + 8)));
+                __m128i b1 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i + 8)));
+                acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(a0, b0));
+                acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(a1, b1));
+            }
+            for (; i + 8 <= size; i += 8)
+            {
+                __m128i a0 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a + i)));
+                __m128i b0 = _mm_cvtepi8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(b + i)));
+                acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(a0, b0));
+            }
+            __m128i sum = _mm_add_epi32(acc0, acc1);
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(sum);
+        }
+
+#endif
+    } // namespace detail
+
+    // F16C needs AVX2 level, the SSE4 and scalar levels convert one value at a time
+    inline void toHalf(const float *vec, size_t size, uint16_t *out)
+    {
+        size_t i = 0;
+#ifdef VISION_CORE_X86_SIMD
+        if (simd::level() >= simd::Level::AVX2)
+            detail::toHalfF16c(vec, size, out, i);
+#endif
+        for (; i < size; ++i)
+            out[i] = floatToHalf(vec[i]);
+    }
+
+    inline void fromHalf(const uint16_t *vec, size_t size, float *out)
+    {
+        size_t i = 0;
+#ifdef VISION_CORE_X86_SIMD
+        if (simd::level() >= simd::Level::AVX2)
+            detail::fromHalfF16c(vec, size, out, i);
+#endif
+        for (; i < size; ++i)
+            out[i] = halfToFloat(vec[i]);
+    }
+
+    // Symmetric quantization q = round(x / scale) with scale = max|x| / 127, returns the scale
+    // (0 for a zero vector, whose codes are all 0)
+    inline float toInt8(const float *vec, size_t size, int8_t *out)
+    {
+        float max_abs = 0.f;
+        for (size_t i = 0; i < size; ++i)
+            max_abs = std::max(max_abs, std::abs(vec[i]));
+
+        if (max_abs == 0.f)
+        {
+            std::fill(out, out + size, int8_t(0));
+            return 0.f;
+        }
+
+        const float scale = max_abs / 127.f;
+        const float inv_scale = 127.f / max_abs;
+        for (size_t i = 0; i < size; ++i)
+            out[i] = static_cast<int8_t>(std::clamp(std::nearbyint(vec[i] * inv_scale), -127.f, 127.f));
+        return scale;
+    }
+
+    inline void fromInt8(const int8_t *vec, size_t size, float scale, float *out)
+    {
+        for (size_t i = 0; i < size; ++i)
+            out[i] = static_cast<float>(vec[i]) * scale;
+    }
+
+    inline float dot(const uint16_t *a, const uint16_t *b, size_t size)
+    {
+        size_t i = 0;
+        float result = 0.f;
+#ifdef VISION_CORE_X86_SIMD
+        simd::Level level = simd::level();
+        if (level == simd::Level::AVX512)
+            result = detail::dotHalfAvx512(a, b, size, i);
+        else if (level == simd::Level::AVX2)
+            result = detail::dotHalfAvx2(a, b, size, i);
+#endif
+        for (; i < size; ++i)
+            result += halfToFloat(a[i]) * halfToFloat(b[i]);
+        return result;
+    }
+
+    // Exact integer dot product of the codes, multiply by both scales for the float value.
+    // AVX-512F has no 16-bit multiply-add, so the AVX512 level reuses the AVX2 kernel.
+    inline int32_t dot(const int8_t *a, const int8_t *b, size_t size)
+    {
+        size_t i = 0;
+        int32_t result = 0;
+#ifdef VISION_CORE_X86_SIMD
+        simd::Level level = simd::level();
+        if (level >= simd::Level::AVX2)
+            result = detail::dotInt8Avx2(a, b, size, i);
+        else if (level == simd::Level::SSE4)
+            result = detail::dotInt8Sse4(a, b, size, i);
+#endif
+        for (; i < size; ++i)
+            result += static_cast<int32_t>(a[i]) * static_cast<int32_t>(b[i]);
+        return result;
+    }
+
+} // namespace quantize
+
+// fp16 copy of a feature vector, e.g. Detection::features, with its norm cached for cosine similarity
+struct HalfFeatures
+{
+    std::vector<uint16_t> values{};
+    float norm{0.f};
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+};
+
+// int8 copy of a feature vector, value i is values[i] * scale
+struct Int8Features
+{
+    std::vector<int8_t> values{};
+    float scale{0.f};
+    float norm{0.f};
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+};
+
+template <typename Alloc = std::allocator<float>>
+inline HalfFeatures quantizeHalf(const std::vector<float, Alloc> &features)
+{
+    HalfFeatures result;
+    result.values.resize(features.size());
+    quantize::toHalf(features.data(), features.size(), result.values.data());
+    result.norm = std::sqrt(quantize::dot(result.values.data(), result.values.data(), result.size()));
+    return result;
+}
+
+template <typename Alloc = std::allocator<float>>
+inline Int8Features quantizeInt8(const std::vector<float, Alloc> &features)
+{
+    Int8Features result;
+    result.values.resize(features.size());
+    result.scale = quantize::toInt8(features.data(), features.size(), result.values.data());
+    const int32_t squared = quantize::dot(result.values.data(), result.values.data(), result.size());
+    result.norm = result.scale * std::sqrt(static_cast<float>(squared));
+    return result;
+}
+
+inline std::vector<float> dequantize(const HalfFeatures &features)
+{
+    std::vector<float> result(features.size());
+    quantize::fromHalf(features.values.data(), features.size(), result.data());
+    return result;
+}
+
+inline std::vector<float> dequantize(const Int8Features &features)
+{
+    std::vector<float> result(features.size());
+    quantize::fromInt8(features.values.data(), features.size(), features.scale, result.data());
+    return result;
+}
+
+// Same (1 + cos) / 2 convention as cosineSimilarity(const float *, const float *, size_t), 0 for zero vectors
+inline float cosineSimilarity(const HalfFeatures &a, const HalfFeatures &b)
+{
+    if (a.size() != b.size())
+    {
+        throw std::invalid_argument("Vectors must be the same size");
+    }
+
+    const float norms = a.norm * b.norm;
+    if (norms < EPSILON * EPSILON)
+    {
+        return 0.f;
+    }
+    return (1.f + quantize::dot(a.values.data(), b.values.data(), a.size()) / norms) / 2.f;
+}
+
+inline float cosineSimilarity(const Int8Features &a, const Int8Features &b)
+{
+    if (a.size() != b.size())
+    {
+        throw std::invalid_argument("Vectors must be the same size");
+    }
+
+    const float norms = a.norm * b.norm;
+    if (norms < EPSILON * EPSILON)
+    {
+        return 0.f;
+    }
+    const float product = static_cast<float>(quantize::dot(a.values.data(), b.values.data(), a.size())) * a.scale * b.scale;
+    return (1.f + product / norms) / 2.f;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include <types/detection.hpp>
+#include <utils/detection_utils.hpp>
+
+struct OverlayParams
+{
+    bool use_track_colors{false}; // color by track_id instead of class_id
+    bool draw_labels{true};       // class name, track id and confidence above each box
+    int thickness{2};             // box and label stroke width
+    double font_scale{0.5};
+    float mask_alpha{0.3f};     // weight of the class or track color where a mask is set
+    float mask_threshold{0.5f}; // mask values above it count as foreground
+    size_t max_cached_labels{4096};
+    const ClassRegistry *class_registry{nullptr}; // names for ids without class_name, nullptr uses the global one
+};
+
+// Draws detections onto an image without full-frame temporaries: masks are blended only inside
+// their boxes, colors come from the Detection palette and label metrics are cached across frames.
+// Keep one renderer per output stream, its scratch buffers are reused from frame to frame.
+class OverlayRenderer
+{
+public:
+    explicit OverlayRenderer(const OverlayParams &params = {}) : params_(params) {}
+
+    const OverlayParams &params() const { return params_; }
+
+    // Draw onto image in place. Boxes are absolute when Detection::size is set, relative otherwise.
+    void render(cv::Mat &image, const std::vector<Detection> &detections)
+    {
+        for (const auto &det : detections)
+        {
+            if (!det.mask.empty())
+                blendMask(image, det, absoluteBox(det, image.size()));
+        }
+
+        for (const auto &det : detections)
+        {
+            const cv::Rect box = absoluteBox(det, image.size());
+            const cv::Scalar &color = this->color(det);
+            cv::rectangle(image, box, color, params_.thickness);
+            if (params_.draw_labels)
+                drawLabel(image, det, box, color);
+        }
+    }
+
+    // Draw onto a copy of image in output, whose buffer is reused when size and type match
+    void render(const cv::Mat &image, const std::vector<Detection> &detections, cv::Mat &output)
+    {
+        image.copyTo(output);
+        render(output, detections);
+    }
+
+    size_t cachedLabels() const { return label_sizes_.size(); }
+
+private:
+    struct TextMetrics
+    {
+        cv::Size size;
+        int baseline;
+    };
+
+    const cv::Scalar &color(const Detection &det) const
+    {
+        return params_.use_track_colors ? det.getTrackColor() : det.getClassColor();
+    }
+
+    static cv::Rect absoluteBox(const Detection &det, cv::Size size)
+    {
+        return det.size.empty() ? getAbsoluteBbox(det.bbox, size) : cv::Rect(det.bbox);
+    }
+
+    // image = (1 - alpha) * image + alpha * color on the mask pixels of the box. The mask spans the
+    // whole box, only the part of the box inside the image is blended.
+    void blendMask(cv::Mat &image, const Detection &det, const cv::Rect &box)
+    {
+        const cv::Rect clip = box & cv::Rect(0, 0, image.cols, image.rows);
+        if (clip.empty())
+            return;
+        if (image.type() != CV_8UC3)
+            throw std::invalid_argument("Mask overlay requires a CV_8UC3 image");
+
+        const cv::Scalar &color = this->color(det);
+        const float alpha = params_.mask_alpha;
+        const float weighted[3] = {alpha * static_cast<float>(color[0]), alpha * static_cast<float>(color[1]),
+                                   alpha * static_cast<float>(color[2])};
+
+        // Only the rows and columns of the resized mask that fall inside the image are computed
+        const cv::Rect region(clip.x - box.x, clip.y - box.y, clip.width, clip.height);
+        detail::resizeMaskRows(det.mask, box.size(), region, [&](int y, const float *values)
+                               {
+                                   uchar *pixel = image.ptr<uchar>(box.y + y) + 3 * clip.x;
+                                   for (int x = 0; x < clip.width; ++x, pixel += 3)
+                                   {
+                                       if (values[x] <= params_.mask_threshold)
+                                           continue;
+                                       for (int c = 0; c < 3; ++c)
+                                           pixel[c] = cv::saturate_cast<uchar>((1.f - alpha) * pixel[c] + weighted[c]);
+                                   }
+                               });
+    }
+
+    void drawLabel(cv::Mat &image, const Detection &det, const cv::Rect &box, const cv::Scalar &color)
+    {
+        label_ = det.getClassName(params_.class_registry ? *params_.class_registry : ClassRegistry::global());
+        if (det.track_id >= 0)
+        {
+            label_ += " [";
+            label_ += std::to_string(det.track_id);
+            label_ += "]";
+        }
+        if (det.confidence > 0)
+        {
+            label_ += " ";
+            label_ += std::to_string(static_cast<int>(det.confidence * 100));
+            label_ += "%";
+        }
+
+        const TextMetrics &metrics = textMetrics(label_);
+        const cv::Point origin(box.x, box.y - 5);
+        cv::rectangle(image,
+                      cv::Point(origin.x, origin.y - metrics.size.height),
+                      cv::Point(origin.x + metrics.size.width, origin.y + metrics.baseline),
+                      color, -1);
+        cv::putText(image, label_, origin, cv::FONT_HERSHEY_SIMPLEX, params_.font_scale, cv::Scalar(0, 0, 0), params_.thickness);
+    }
+
+    const TextMetrics &textMetrics(const std::string &label)
+    {
+        auto it = label_sizes_.find(label);
+        if (it != label_sizes_.end())
+            return it->second;
+
+        // Track ids make the label set unbounded, start over rather than grow forever
+        if (label_sizes_.size() >= params_.max_cached_labels)
+            label_sizes_.clear();
+
+        TextMetrics metrics{};
+        metrics.size = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX, params_.font_scale, params_.thickness, &metrics.baseline);
+        return label_sizes_.emplace(label, metrics).first->second;
+    }
+
+    OverlayParams params_;
+    std::string label_{};
+    std::unordered_map<std::string, TextMetrics> label_sizes_{};
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+
+// x86 kernels are compiled per function with target attributes and selected at runtime,
+// so the library itself can be built for the baseline ISA
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VISION_CORE_X86_SIMD 1
+#include <immintrin.h>
+#define VISION_CORE_TARGET(isa) __attribute__((target(isa)))
+#define VISION_CORE_UNROLL _Pragma("GCC unroll 8")
+#else
+#define VISION_CORE_TARGET(isa)
+#define VISION_CORE_UNROLL
+#endif
+
+// GCC 12 reports the _mm512_undefined_* placeholders used by the AVX-512 intrinsics as uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#define VISION_CORE_AVX512_WARNINGS_PUSH                   \
+    _Pragma("GCC diagnostic push")                         \
+    _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define VISION_CORE_AVX512_WARNINGS_POP _Pragma("GCC diagnostic pop")
+#else
+#define VISION_CORE_AVX512_WARNINGS_PUSH
+#define VISION_CORE_AVX512_WARNINGS_POP
+#endif
+
+namespace simd
+{
+
+    enum class Level
+    {
+        Scalar = 0,
+        SSE4 = 1,
+        AVX2 = 2,
+        AVX512 = 3
+    };
+
+    // Highest instruction set supported by the running CPU.
+    // AVX2 and above also imply FMA and F16C, which every AVX2 CPU provides.
+    inline Level detectLevel()
+    {
+#ifdef VISION_CORE_X86_SIMD
+        __builtin_cpu_init();
+        const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+        if (avx2 && __builtin_cpu_supports("avx512f"))
+            return Level::AVX512;
+        if (avx2)
+            return Level::AVX2;
+        if (__builtin_cpu_supports("sse4.1"))
+            return Level::SSE4;
+#endif
+        return Level::Scalar;
+    }
+
+    inline std::atomic<Level> &activeLevel()
+    {
+        static std::atomic<Level> level{detectLevel()};
+        return level;
+    }
+
+    // Instruction set used by the dispatched kernels
+    inline Level level()
+    {
+        return activeLevel().load(std::memory_order_relaxed);
+    }
+
+    // Restrict dispatch to at most the given level (e.g. to test or benchmark the fallbacks)
+    inline void setLevel(Level requested)
+    {
+        Level supported = detectLevel();
+        activeLevel().store(requested < supported ? requested : supported, std::memory_order_relaxed);
+    }
+
+#ifdef VISION_CORE_X86_SIMD
+
+    VISION_CORE_TARGET("sse4.1") inline float hsum(__m128 v)
+    {
+        __m128 shuf = _mm_movehdup_ps(v);
+        __m128 sums = _mm_add_ps(v, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+
+    VISION_CORE_TARGET("avx2") inline float hsum(__m256 v)
+    {
+        return hsum(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+    }
+
+#endif
+
+} // namespace simd
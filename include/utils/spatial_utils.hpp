@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+
+#include <utils/geometry_utils.hpp>
+
+// Sparse overlap entry: first indexes the query boxes, second the indexed boxes
+struct BoxOverlap
+{
+    int first;
+    int second;
+    float iou;
+};
+
+// Uniform grid over a set of boxes, bulk-loaded once per frame.
+// Boxes spanning several cells are stored in each of them; queries report every box once
+// by only accepting it in the cell holding the top-left corner of the intersection.
+class BoxGrid
+{
+public:
+    BoxGrid() = default;
+
+    template <typename Alloc = std::allocator<cv::Rect2f>>
+    explicit BoxGrid(const std::vector<cv::Rect2f, Alloc> &boxes, float cell_size = 0.f)
+    {
+        build(boxes, cell_size);
+    }
+
+    // A cell_size of 0 picks twice the mean box side, which keeps few boxes per cell
+    void build(const cv::Rect2f *boxes, size_t size, float cell_size = 0.f)
+    {
+        boxes_.assign(boxes, boxes + size);
+        cols_ = rows_ = 0;
+        cell_start_.clear();
+        entries_.clear();
+        if (size == 0)
+            return;
+
+        float min_x = boxes[0].x, min_y = boxes[0].y;
+        float max_x = boxes[0].x + boxes[0].width, max_y = boxes[0].y + boxes[0].height;
+        double mean_side = 0.0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const cv::Rect2f &box = boxes[i];
+            min_x = std::min(min_x, box.x);
+            min_y = std::min(min_y, box.y);
+            max_x = std::max(max_x, box.x + box.width);
+            max_y = std::max(max_y, box.y + box.height);
+            mean_side += 0.5 * (std::abs(box.width) + std::abs(box.height));
+        }
+        mean_side /= static_cast<double>(size);
+
+        if (cell_size <= 0.f)
+            cell_size = static_cast<float>(2.0 * mean_side);
+
+        // Bound the cell count to a small multiple of the box count
+        const float extent_x = std::max(max_x - min_x, EPSILON);
+        const float extent_y = std::max(max_y - min_y, EPSILON);
+        const float max_cells = 4.f * static_cast<float>(size) + 16.f;
+        if (cell_size <= 0.f || (extent_x / cell_size) * (extent_y / cell_size) > max_cells)
+            cell_size = std::sqrt(extent_x * extent_y / max_cells);
+
+        origin_x_ = min_x;
+        origin_y_ = min_y;
+        inv_cell_ = 1.f / cell_size;
+        cols_ = std::max(1, static_cast<int>(std::ceil(extent_x * inv_cell_)));
+        rows_ = std::max(1, static_cast<int>(std::ceil(extent_y * inv_cell_)));
+
+        // Counting pass, prefix sum, then fill pass into a CSR layout
+        cell_start_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+        forEachBox([this](int cell, int)
+                   { ++cell_start_[cell + 1]; });
+        for (size_t c = 1; c < cell_start_.size(); ++c)
+            cell_start_[c] += cell_start_[c - 1];
+
+        entries_.resize(cell_start_.back());
+        cursor_.assign(cell_start_.begin(), cell_start_.end() - 1);
+        forEachBox([this](int cell, int index)
+                   { entries_[cursor_[cell]++] = index; });
+    }
+
+    template <typename Alloc = std::allocator<cv::Rect2f>>
+    void build(const std::vector<cv::Rect2f, Alloc> &boxes, float cell_size = 0.f)
+    {
+        build(boxes.data(), boxes.size(), cell_size);
+    }
+
+    size_t size() const { return boxes_.size(); }
+    bool empty() const { return boxes_.empty(); }
+    const std::vector<cv::Rect2f> &boxes() const { return boxes_; }
+
+    // Indexed boxes whose IoU with box is above iou_threshold, appended to out with first = query_index
+    void query(const cv::Rect2f &box, float iou_threshold, std::vector<BoxOverlap> &out, int query_index = -1) const
+    {
+        if (boxes_.empty() || box.width <= 0.f || box.height <= 0.f)
+            return;
+
+        const int cx0 = cellX(box.x), cx1 = cellX(box.x + box.width);
+        const int cy0 = cellY(box.y), cy1 = cellY(box.y + box.height);
+
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                const int cell = cy * cols_ + cx;
+                for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k)
+                {
+                    const int j = entries_[k];
+                    const cv::Rect2f &other = boxes_[j];
+
+                    // Report the pair only from the cell owning the intersection corner
+                    if (cellX(std::max(box.x, other.x)) != cx || cellY(std::max(box.y, other.y)) != cy)
+                        continue;
+
+                    float iou = getIoU(box, other);
+                    if (iou > iou_threshold)
+                        out.push_back({query_index, j, iou});
+                }
+            }
+        }
+    }
+
+private:
+    int cellX(float x) const
+    {
+        return clampCell((x - origin_x_) * inv_cell_, cols_);
+    }
+
+    int cellY(float y) const
+    {
+        return clampCell((y - origin_y_) * inv_cell_, rows_);
+    }
+
+    // Clamped before the cast, which overflows for coordinates far outside the grid
+    static int clampCell(float cell, int count)
+    {
+        if (!(cell > 0.f))
+            return 0;
+        return cell < static_cast<float>(count - 1) ? static_cast<int>(cell) : count - 1;
+    }
+
+    template <typename Fn>
+    void forEachBox(Fn &&fn) const
+    {
+        for (size_t i = 0; i < boxes_.size(); ++i)
+        {
+            const cv::Rect2f &box = boxes_[i];
+            if (box.width <= 0.f || box.height <= 0.f)
+                continue;
+
+            const int cx0 = cellX(box.x), cx1 = cellX(box.x + box.width);
+            const int cy0 = cellY(box.y), cy1 = cellY(box.y + box.height);
+            for (int cy = cy0; cy <= cy1; ++cy)
+                for (int cx = cx0; cx <= cx1; ++cx)
+                    fn(cy * cols_ + cx, static_cast<int>(i));
+        }
+    }
+
+    std::vector<cv::Rect2f> boxes_{};
+    std::vector<int> cell_start_{};
+    std::vector<int> entries_{};
+    std::vector<int> cursor_{};
+    float origin_x_{0.f}, origin_y_{0.f}, inv_cell_{1.f};
+    int cols_{0}, rows_{0};
+};
+
+// Sparse list of pairs (i, j) with IoU(boxes1[i], boxes2[j]) > iou_threshold
+template <typename AllocA = std::allocator<cv::Rect2f>, typename AllocB = std::allocator<cv::Rect2f>>
+inline void findOverlaps(const std::vector<cv::Rect2f, AllocA> &boxes1, const std::vector<cv::Rect2f, AllocB> &boxes2,
+                         float iou_threshold, std::vector<BoxOverlap> &out)
+{
+    thread_local BoxGrid grid;
+    out.clear();
+    grid.build(boxes2);
+    for (size_t i = 0; i < boxes1.size(); ++i)
+    {
+        grid.query(boxes1[i], iou_threshold, out, static_cast<int>(i));
+    }
+}
+
+// Sparse list of pairs (i, j), i < j, of overlapping boxes within one set
+template <typename Alloc = std::allocator<cv::Rect2f>>
+inline void findOverlaps(const std::vector<cv::Rect2f, Alloc> &boxes, float iou_threshold, std::vector<BoxOverlap> &out)
+{
+    thread_local BoxGrid grid;
+    out.clear();
+    grid.build(boxes);
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        size_t begin = out.size();
+        grid.query(boxes[i], iou_threshold, out, static_cast<int>(i));
+        out.erase(std::remove_if(out.begin() + begin, out.end(), [i](const BoxOverlap &overlap)
+                                 { return overlap.second <= static_cast<int>(i); }),
+                  out.end());
+    }
+}
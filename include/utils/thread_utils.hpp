@@ -0,0 +1,318 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <exception>
+#include <type_traits>
+#include <condition_variable>
+
+// Split [begin, end) into contiguous chunks processed by up to num_threads threads,
+// the calling thread takes the last chunk. num_threads = 0 uses all hardware threads.
+template <typename Fn>
+inline void parallelFor(size_t begin, size_t end, size_t num_threads, Fn &&fn)
+{
+    if (end <= begin)
+        return;
+
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const size_t count = end - begin;
+    num_threads = std::min(num_threads, count);
+    if (num_threads <= 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    const size_t chunk = (count + num_threads - 1) / num_threads;
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (size_t start = begin; start + chunk < end; start += chunk)
+    {
+        workers.emplace_back([&fn, start, chunk]()
+                             { fn(start, start + chunk); });
+    }
+
+    fn(begin + workers.size() * chunk, end);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// Fixed set of worker threads for repeated parallel work, e.g. once per frame, without
+// spawning threads per call. The calling thread works too, so a pool of size() == 1 has no workers.
+class ThreadPool
+{
+public:
+    // num_threads = 0 uses all hardware threads
+    explicit ThreadPool(size_t num_threads = 0)
+    {
+        if (num_threads == 0)
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+        workers_.reserve(num_threads - 1);
+        for (size_t t = 1; t < num_threads; ++t)
+        {
+            workers_.emplace_back([this]()
+                                  { workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    size_t size() const { return workers_.size() + 1; }
+
+    // Call fn(i) for every i in [0, count), tasks are claimed dynamically so uneven tasks balance out.
+    // Blocks until all tasks finished and rethrows the first exception thrown by fn.
+    // Concurrent calls are serialized.
+    template <typename Fn>
+    void run(size_t count, Fn &&fn)
+    {
+        if (count == 0)
+            return;
+
+        using Callable = std::remove_reference_t<Fn>;
+        Job job;
+        job.fn = const_cast<void *>(static_cast<const void *>(&fn));
+        job.call = [](void *callable, size_t i)
+        { (*static_cast<Callable *>(callable))(i); };
+        job.count = count;
+        job.pending = count;
+
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            current_ = &job;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        execute(job);
+
+        {
+            // No worker may still hold the job once it goes out of scope
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this, &job]()
+                       { return job.pending.load() == 0 && active_ == 0; });
+            current_ = nullptr;
+        }
+
+        if (job.failure)
+            std::rethrow_exception(job.failure);
+    }
+
+private:
+    struct Job
+    {
+        void *fn{nullptr};
+        void (*call)(void *, size_t){nullptr};
+        size_t count{0};
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> pending{0};
+        std::exception_ptr failure{};
+    };
+
+    void execute(Job &job)
+    {
+        size_t i;
+        while ((i = job.next.fetch_add(1)) < job.count)
+        {
+            try
+            {
+                job.call(job.fn, i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!job.failure)
+                    job.failure = std::current_exception();
+            }
+
+            if (job.pending.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_.notify_all();
+            }
+        }
+    }
+
+    void workerLoop()
+    {
+        size_t seen = 0;
+        while (true)
+        {
+            Job *job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this, &seen]()
+                           { return stopping_ || (current_ != nullptr && generation_ != seen); });
+                if (stopping_)
+                    return;
+                seen = generation_;
+                job = current_;
+                ++active_;
+            }
+
+            execute(*job);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_;
+            }
+            done_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Job *current_{nullptr};
+    size_t generation_{0};
+    size_t active_{0};
+    bool stopping_{false};
+};
+
+// What a producer does when a bounded queue is full
+enum class QueuePolicy
+{
+    Block,      // wait for the consumer
+    DropNewest, // reject the item being pushed
+    DropOldest  // evict the oldest queued item
+};
+
+// Fixed-capacity multi-producer multi-consumer FIFO over a preallocated ring
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity, QueuePolicy policy = QueuePolicy::Block)
+        : ring_(std::max<size_t>(1, capacity)), policy_(policy)
+    {
+    }
+
+    // Returns the item that did not make it into the queue: the pushed one when it is rejected
+    // or the queue is closed, the evicted one with DropOldest
+    std::optional<T> push(T item)
+    {
+        bool closed;
+        return push(std::move(item), closed);
+    }
+
+    // As push(), closed tells a push refused by close() apart from a drop
+    std::optional<T> push(T item, bool &closed)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (policy_ == QueuePolicy::Block)
+            not_full_.wait(lock, [this]()
+                           { return count_ < ring_.size() || closed_; });
+
+        closed = closed_;
+        if (closed_)
+            return item;
+
+        std::optional<T> rejected;
+        if (count_ == ring_.size())
+        {
+            ++dropped_;
+            if (policy_ == QueuePolicy::DropNewest)
+                return item;
+
+            rejected = std::move(ring_[head_]);
+            head_ = (head_ + 1) % ring_.size();
+            --count_;
+        }
+
+        ring_[(head_ + count_) % ring_.size()] = std::move(item);
+        ++count_;
+        lock.unlock();
+        not_empty_.notify_one();
+        return rejected;
+    }
+
+    // Block until an item is available, false once the queue is closed and drained
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]()
+                        { return count_ > 0 || closed_; });
+        return takeLocked(item, lock);
+    }
+
+    bool tryPop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return takeLocked(item, lock);
+    }
+
+    // Wake every waiter, later pushes are rejected and pops drain what is left
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    }
+
+    size_t capacity() const { return ring_.size(); }
+
+    // Items rejected or evicted because the queue was full
+    size_t dropped() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+private:
+    bool takeLocked(T &item, std::unique_lock<std::mutex> &lock)
+    {
+        if (count_ == 0)
+            return false;
+
+        item = std::move(ring_[head_]);
+        head_ = (head_ + 1) % ring_.size();
+        --count_;
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    }
+
+    std::vector<T> ring_;
+    QueuePolicy policy_;
+    size_t head_{0};
+    size_t count_{0};
+    size_t dropped_{0};
+    bool closed_{false};
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
@@ -6,195 +6,809 @@
 #include <stdexcept>
 #include <algorithm>
 #include <functional>
+#include <type_traits>
 
+#include <utils/simd_utils.hpp>
+
+// Pointer + length kernels write to a caller-provided out buffer and never allocate.
+// Element-wise kernels accept out aliasing an input, which is how the *InPlace helpers work.
+// The std::vector overloads returning by value are thin wrappers over them, results use the
+// allocator of the (first) input, so std::pmr vectors stay in their memory resource.
+// For float, dot, sum, max, exp, sigmoid and softmax use SIMD kernels picked by simd::level().
 namespace vector_ops
 {
 
-    // Element-wise addition of two vectors
-    template <typename T>
-    inline std::vector<T> add(const std::vector<T> &a, const std::vector<T> &b)
+    namespace detail
     {
-        if (a.size() != b.size())
+        template <typename T, typename AllocA, typename AllocB>
+        inline void checkSameSize(const std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
         {
-            throw std::invalid_argument("Vectors must be the same size");
+            if (a.size() != b.size())
+            {
+                throw std::invalid_argument("Vectors must be the same size");
+            }
         }
 
-        std::vector<T> result(a.size());
-        std::transform(a.begin(), a.end(), b.begin(), result.begin(), std::plus<>());
-        return result;
+#ifdef VISION_CORE_X86_SIMD
+
+        VISION_CORE_AVX512_WARNINGS_PUSH
+
+        // exp(x) = 2^n * e^r with n = round(x * log2(e)) and |r| <= ln(2) / 2, e^r from the Cephes
+        // degree 6 polynomial. Max relative error against the exact exp is below 1.2e-7 (about 1 ulp).
+        // Inputs are clamped to [EXP_LO, EXP_HI]: exp saturates at 1.65e38 above 88 and returns
+        // FLT_MIN instead of denormals below -87.3, NaN propagates.
+        constexpr float EXP_HI = 88.0f;
+        constexpr float EXP_LO = -87.33654f;
+        constexpr float EXP_LOG2E = 1.44269504088896341f;
+        constexpr float EXP_LN2_HI = 0.693359375f;
+        constexpr float EXP_LN2_LO = -2.12194440e-4f;
+        constexpr float EXP_P0 = 1.9875691500e-4f;
+        constexpr float EXP_P1 = 1.3981999507e-3f;
+        constexpr float EXP_P2 = 8.3334519073e-3f;
+        constexpr float EXP_P3 = 4.1665795894e-2f;
+        constexpr float EXP_P4 = 1.6666665459e-1f;
+        constexpr float EXP_P5 = 5.0000001201e-1f;
+
+        VISION_CORE_TARGET("sse4.1") inline __m128 expSse4(__m128 x)
+        {
+            x = _mm_max_ps(_mm_set1_ps(EXP_LO), _mm_min_ps(_mm_set1_ps(EXP_HI), x));
+            __m128 n = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(EXP_LN2_HI)));
+            r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(EXP_LN2_LO)));
+
+            __m128 p = _mm_set1_ps(EXP_P0);
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P1));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P2));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P3));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P4));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_P5));
+            p = _mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), _mm_add_ps(r, _mm_set1_ps(1.f)));
+
+            __m128i e = _mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23);
+            return _mm_mul_ps(p, _mm_castsi128_ps(e));
+        }
+
+        VISION_CORE_TARGET("avx2,fma") inline __m256 expAvx2(__m256 x)
+        {
+            x = _mm256_max_ps(_mm256_set1_ps(EXP_LO), _mm256_min_ps(_mm256_set1_ps(EXP_HI), x));
+            __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_HI), x);
+            r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_LO), r);
+
+            __m256 p = _mm256_set1_ps(EXP_P0);
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P1));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P2));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P3));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P4));
+            p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P5));
+            p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.f)));
+
+            __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+            return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+        }
+
+        VISION_CORE_TARGET("avx512f") inline __m512 expAvx512(__m512 x)
+        {
+            x = _mm512_max_ps(_mm512_set1_ps(EXP_LO), _mm512_min_ps(_mm512_set1_ps(EXP_HI), x));
+            __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(EXP_LOG2E)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_HI), x);
+            r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_LO), r);
+
+            __m512 p = _mm512_set1_ps(EXP_P0);
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P1));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P2));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P3));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P4));
+            p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P5));
+            p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.f)));
+
+            return _mm512_scalef_ps(p, n);
+        }
+
+        // Reductions keep four independent accumulators to hide the add latency.
+        // Kernels process a prefix of the input, set i to where they stopped and leave the tail to the caller.
+
+        VISION_CORE_TARGET("sse4.1") inline float dotSse4(const float *a, const float *b, size_t size, size_t &i)
+        {
+            __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+            for (i = 0; i + 16 <= size; i += 16)
+            {
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+            }
+            for (; i + 4 <= size; i += 4)
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            return simd::hsum(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+        }
+
+        VISION_CORE_TARGET("avx2,fma") inline float dotAvx2(const float *a, const float *b, size_t size, size_t &i)
+        {
+            __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+            for (i = 0; i + 32 <= size; i += 32)
+            {
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+                acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+                acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+            }
+            for (; i + 8 <= size; i += 8)
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+            return simd::hsum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+        }
+
+        VISION_CORE_TARGET("avx512f") inline float dotAvx512(const float *a, const float *b, size_t size, size_t &i)
+        {
+            __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+            for (i = 0; i + 64 <= size; i += 64)
+            {
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+                acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+                acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+            }
+            for (; i + 16 <= size; i += 16)
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+            if (i < size)
+            {
+                __mmask16 mask = static_cast<__mmask16>((1u << (size - i)) - 1);
+                acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+                i = size;
+            }
+            return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+        }
+
+        VISION_CORE_TARGET("sse4.1") inline float sumSse4(const float *vec, size_t size, size_t &i)
+        {
+            __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+            for (i = 0; i + 16 <= size; i += 16)
+            {
+                acc0 = _mm_add_ps(acc0, _mm_loadu_ps(vec + i));
+                acc1 = _mm_add_ps(acc1, _mm_loadu_ps(vec + i + 4));
+                acc2 = _mm_add_ps(acc2, _mm_loadu_ps(vec + i + 8));
+                acc3 = _mm_add_ps(acc3, _mm_loadu_ps(vec + i + 12));
+            }
+            for (; i + 4 <= size; i += 4)
+                acc0 = _mm_add_ps(acc0, _mm_loadu_ps(vec + i));
+            return simd::hsum(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+        }
+
+        VISION_CORE_TARGET("avx2") inline float sumAvx2(const float *vec, size_t size, size_t &i)
+        {
+            __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+            for (i = 0; i + 32 <= size; i += 32)
+            {
+                acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(vec + i));
+                acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(vec + i + 8));
+                acc2 = _mm256_add_ps(acc2, _mm256_loadu_ps(vec + i + 16));
+                acc3 = _mm256_add_ps(acc3, _mm256_loadu_ps(vec + i + 24));
+            }
+            for (; i + 8 <= size; i += 8)
+                acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(vec + i));
+            return simd::hsum(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+        }
+
+        VISION_CORE_TARGET("avx512f") inline float sumAvx512(const float *vec, size_t size, size_t &i)
+        {
+            __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps(), acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+            for (i = 0; i + 64 <= size; i += 64)
+            {
+                acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(vec + i));
+                acc1 = _mm512_add_ps(acc1, _mm512_loadu_ps(vec + i + 16));
+                acc2 = _mm512_add_ps(acc2, _mm512_loadu_ps(vec + i + 32));
+                acc3 = _mm512_add_ps(acc3, _mm512_loadu_ps(vec + i + 48));
+            }
+            for (; i + 16 <= size; i += 16)
+                acc0 = _mm512_add_ps(acc0, _mm512_loadu_ps(vec + i));
+            if (i < size)
+            {
+                acc1 = _mm512_add_ps(acc1, _mm512_maskz_loadu_ps(static_cast<__mmask16>((1u << (size - i)) - 1), vec + i));
+                i = size;
+            }
+            return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+        }
+
+        // Maximum of the first i values, size must be at least one vector wide
+        VISION_CORE_TARGET("sse4.1") inline float maxSse4(const float *vec, size_t size, size_t &i)
+        {
+            __m128 acc = _mm_loadu_ps(vec);
+            for (i = 4; i + 4 <= size; i += 4)
+                acc = _mm_max_ps(acc, _mm_loadu_ps(vec + i));
+            acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+            acc = _mm_max_ss(acc, _mm_movehdup_ps(acc));
+            return _mm_cvtss_f32(acc);
+        }
+
+        VISION_CORE_TARGET("avx2") inline float maxAvx2(const float *vec, size_t size, size_t &i)
+        {
+            __m256 acc = _mm256_loadu_ps(vec);
+            for (i = 8; i + 8 <= size; i += 8)
+                acc = _mm256_max_ps(acc, _mm256_loadu_ps(vec + i));
+            __m128 half = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+            half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+            half = _mm_max_ss(half, _mm_movehdup_ps(half));
+            return _mm_cvtss_f32(half);
+        }
+
+        VISION_CORE_TARGET("avx512f") inline float maxAvx512(const float *vec, size_t size, size_t &i)
+        {
+            __m512 acc = _mm512_loadu_ps(vec);
+            for (i = 16; i + 16 <= size; i += 16)
+                acc = _mm512_max_ps(acc, _mm512_loadu_ps(vec + i));
+            return _mm512_reduce_max_ps(acc);
+        }
+
+        // out = exp(vec - shift), returns the sum of the written values
+        VISION_CORE_TARGET("sse4.1") inline float expSumSse4(const float *vec, size_t size, float shift, float *out, size_t &i)
+        {
+            const __m128 s = _mm_set1_ps(shift);
+            __m128 acc = _mm_setzero_ps();
+            for (i = 0; i + 4 <= size; i += 4)
+            {
+                __m128 e = expSse4(_mm_sub_ps(_mm_loadu_ps(vec + i), s));
+                _mm_storeu_ps(out + i, e);
+                acc = _mm_add_ps(acc, e);
+            }
+            return simd::hsum(acc);
+        }
+
+        VISION_CORE_TARGET("avx2,fma") inline float expSumAvx2(const float *vec, size_t size, float shift, float *out, size_t &i)
+        {
+            const __m256 s = _mm256_set1_ps(shift);
+            __m256 acc = _mm256_setzero_ps();
+            for (i = 0; i + 8 <= size; i += 8)
+            {
+                __m256 e = expAvx2(_mm256_sub_ps(_mm256_loadu_ps(vec + i), s));
+                _mm256_storeu_ps(out + i, e);
+                acc = _mm256_add_ps(acc, e);
+            }
+            return simd::hsum(acc);
+        }
+
+        VISION_CORE_TARGET("avx512f") inline float expSumAvx512(const float *vec, size_t size, float shift, float *out, size_t &i)
+        {
+            const __m512 s = _mm512_set1_ps(shift);
+            __m512 acc = _mm512_setzero_ps();
+            for (i = 0; i + 16 <= size; i += 16)
+            {
+                __m512 e = expAvx512(_mm512_sub_ps(_mm512_loadu_ps(vec + i), s));
+                _mm512_storeu_ps(out + i, e);
+                acc = _mm512_add_ps(acc, e);
+            }
+            if (i < size)
+            {
+                __mmask16 mask = static_cast<__mmask16>((1u << (size - i)) - 1);
+                __m512 e = expAvx512(_mm512_sub_ps(_mm512_maskz_loadu_ps(mask, vec + i), s));
+                _mm512_mask_storeu_ps(out + i, mask, e);
+                acc = _mm512_mask_add_ps(acc, mask, acc, e);
+                i = size;
+            }
+            return _mm512_reduce_add_ps(acc);
+        }
+
+        // out = 1 / (1 + exp(-vec))
+        VISION_CORE_TARGET("sse4.1") inline size_t sigmoidSse4(const float *vec, size_t size, float *out)
+        {
+            const __m128 one = _mm_set1_ps(1.f);
+            size_t i = 0;
+            for (; i + 4 <= size; i += 4)
+            {
+                __m128 e = expSse4(_mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(vec + i)));
+                _mm_storeu_ps(out + i, _mm_div_ps(one, _mm_add_ps(one, e)));
+            }
+            return i;
+        }
+
+        VISION_CORE_TARGET("avx2,fma") inline size_t sigmoidAvx2(const float *vec, size_t size, float *out)
+        {
+            const __m256 one = _mm256_set1_ps(1.f);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                __m256 e = expAvx2(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(vec + i)));
+                _mm256_storeu_ps(out + i, _mm256_div_ps(one, _mm256_add_ps(one, e)));
+            }
+            return i;
+        }
+
+        VISION_CORE_TARGET("avx512f") inline size_t sigmoidAvx512(const float *vec, size_t size, float *out)
+        {
+            const __m512 one = _mm512_set1_ps(1.f);
+            size_t i = 0;
+            for (; i < size; i += 16)
+            {
+                __mmask16 mask = size - i >= 16 ? __mmask16(0xFFFF) : static_cast<__mmask16>((1u << (size - i)) - 1);
+                __m512 e = expAvx512(_mm512_sub_ps(_mm512_setzero_ps(), _mm512_maskz_loadu_ps(mask, vec + i)));
+                _mm512_mask_storeu_ps(out + i, mask, _mm512_div_ps(one, _mm512_add_ps(one, e)));
+            }
+            return size;
+        }
+
+        VISION_CORE_AVX512_WARNINGS_POP
+
+#endif
+
+        inline float dotF32(const float *a, const float *b, size_t size)
+        {
+            size_t i = 0;
+            float result = 0.f;
+#ifdef VISION_CORE_X86_SIMD
+            simd::Level level = simd::level();
+            if (level == simd::Level::AVX512)
+                result = dotAvx512(a, b, size, i);
+            else if (level == simd::Level::AVX2)
+                result = dotAvx2(a, b, size, i);
+            else if (level == simd::Level::SSE4)
+                result = dotSse4(a, b, size, i);
+#endif
+            for (; i < size; ++i)
+                result += a[i] * b[i];
+            return result;
+        }
+
+        inline float sumF32(const float *vec, size_t size)
+        {
+            size_t i = 0;
+            float result = 0.f;
+#ifdef VISION_CORE_X86_SIMD
+            simd::Level level = simd::level();
+            if (level == simd::Level::AVX512)
+                result = sumAvx512(vec, size, i);
+            else if (level == simd::Level::AVX2)
+                result = sumAvx2(vec, size, i);
+            else if (level == simd::Level::SSE4)
+                result = sumSse4(vec, size, i);
+#endif
+            for (; i < size; ++i)
+                result += vec[i];
+            return result;
+        }
+
+        inline float maxF32(const float *vec, size_t size)
+        {
+            size_t i = 1;
+            float result = vec[0];
+#ifdef VISION_CORE_X86_SIMD
+            simd::Level level = simd::level();
+            if (level == simd::Level::AVX512 && size >= 16)
+                result = maxAvx512(vec, size, i);
+            else if (level >= simd::Level::AVX2 && size >= 8)
+                result = maxAvx2(vec, size, i);
+            else if (level >= simd::Level::SSE4 && size >= 4)
+                result = maxSse4(vec, size, i);
+#endif
+            for (; i < size; ++i)
+                result = std::max(result, vec[i]);
+            return result;
+        }
+
+#ifdef VISION_CORE_X86_SIMD
+
+        inline float expSumSimd(simd::Level level, const float *vec, size_t size, float shift, float *out, size_t &i)
+        {
+            if (level == simd::Level::AVX512)
+                return expSumAvx512(vec, size, shift, out, i);
+            if (level == simd::Level::AVX2)
+                return expSumAvx2(vec, size, shift, out, i);
+            return expSumSse4(vec, size, shift, out, i);
+        }
+
+        inline size_t sigmoidSimd(simd::Level level, const float *vec, size_t size, float *out)
+        {
+            if (level == simd::Level::AVX512)
+                return sigmoidAvx512(vec, size, out);
+            if (level == simd::Level::AVX2)
+                return sigmoidAvx2(vec, size, out);
+            return sigmoidSse4(vec, size, out);
+        }
+
+#endif
+
+        // Vector tails are padded to a full register so that every element goes through the same approximation
+        constexpr size_t SIMD_TAIL = 16;
+
+        inline float expSumF32(const float *vec, size_t size, float shift, float *out)
+        {
+            float result = 0.f;
+#ifdef VISION_CORE_X86_SIMD
+            simd::Level level = simd::level();
+            if (level != simd::Level::Scalar)
+            {
+                size_t i = 0;
+                result = expSumSimd(level, vec, size, shift, out, i);
+                if (i < size)
+                {
+                    float tail_in[SIMD_TAIL] = {}, tail_out[SIMD_TAIL];
+                    size_t j = 0;
+                    std::copy(vec + i, vec + size, tail_in);
+                    expSumSimd(level, tail_in, SIMD_TAIL, shift, tail_out, j);
+                    for (j = 0; i + j < size; ++j)
+                    {
+                        out[i + j] = tail_out[j];
+                        result += tail_out[j];
+                    }
+                }
+                return result;
+            }
+#endif
+            for (size_t i = 0; i < size; ++i)
+            {
+                out[i] = std::exp(vec[i] - shift);
+                result += out[i];
+            }
+            return result;
+        }
+
+        inline void sigmoidF32(const float *vec, size_t size, float *out)
+        {
+#ifdef VISION_CORE_X86_SIMD
+            simd::Level level = simd::level();
+            if (level != simd::Level::Scalar)
+            {
+                size_t i = sigmoidSimd(level, vec, size, out);
+                if (i < size)
+                {
+                    float tail_in[SIMD_TAIL] = {}, tail_out[SIMD_TAIL];
+                    std::copy(vec + i, vec + size, tail_in);
+                    sigmoidSimd(level, tail_in, SIMD_TAIL, tail_out);
+                    std::copy(tail_out, tail_out + (size - i), out + i);
+                }
+                return;
+            }
+#endif
+            for (size_t i = 0; i < size; ++i)
+                out[i] = 1.f / (1.f + std::exp(-vec[i]));
+        }
+
+    } // namespace detail
+
+    // Element-wise addition of two rows
+    template <typename T>
+    inline void add(const T *a, const T *b, size_t size, T *out)
+    {
+        for (size_t i = 0; i < size; ++i)
+            out[i] = a[i] + b[i];
     }
 
     // Scalar add
     template <typename T>
-    inline std::vector<T> add(const std::vector<T> &vec, T scalar)
+    inline void add(const T *vec, size_t size, T scalar, T *out)
     {
-        std::vector<T> result(vec.size());
-        std::transform(vec.begin(), vec.end(), result.begin(), [scalar](T x)
-                       { return x + scalar; });
-        return result;
+        for (size_t i = 0; i < size; ++i)
+            out[i] = vec[i] + scalar;
+    }
+
+    // Element-wise multiplication of two rows
+    template <typename T>
+    inline void mul(const T *a, const T *b, size_t size, T *out)
+    {
+        for (size_t i = 0; i < size; ++i)
+            out[i] = a[i] * b[i];
+    }
+
+    // Scalar multiplication
+    template <typename T>
+    inline void mul(const T *vec, size_t size, T scalar, T *out)
+    {
+        for (size_t i = 0; i < size; ++i)
+            out[i] = vec[i] * scalar;
+    }
+
+    // Dot product of two contiguous rows
+    template <typename T>
+    inline T dot(const T *a, const T *b, size_t size)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            return detail::dotF32(a, b, size);
+        else
+            return std::inner_product(a, a + size, b, T(0));
+    }
+
+    // Scale a row to unit L2 norm
+    template <typename T>
+    inline void normalize(const T *vec, size_t size, T *out)
+    {
+        T norm = std::sqrt(dot(vec, vec, size));
+        mul(vec, size, T(1) / norm, out);
+    }
+
+    // Weighted average alpha * a + (1 - alpha) * b
+    template <typename T>
+    inline void compose(const T *a, const T *b, size_t size, T alpha, T *out)
+    {
+        const T alpha_complement = T(1) - alpha;
+        for (size_t i = 0; i < size; ++i)
+            out[i] = alpha * a[i] + alpha_complement * b[i];
     }
 
-    // Element-wise multiplication of two vectors
     template <typename T>
-    inline std::vector<T> mul(const std::vector<T> &a, const std::vector<T> &b)
+    inline T sum(const T *vec, size_t size)
     {
-        if (a.size() != b.size())
+        if constexpr (std::is_same_v<T, float>)
+            return detail::sumF32(vec, size);
+        else
+            return std::accumulate(vec, vec + size, T(0));
+    }
+
+    template <typename T>
+    inline T mean(const T *vec, size_t size)
+    {
+        return size == 0 ? T(0) : sum(vec, size) / static_cast<T>(size);
+    }
+
+    // Maximum of a non-empty row
+    template <typename T>
+    inline T max(const T *vec, size_t size)
+    {
+        if constexpr (std::is_same_v<T, float>)
+            return detail::maxF32(vec, size);
+        else
+            return *std::max_element(vec, vec + size);
+    }
+
+    // Index of the maximum of a non-empty row
+    template <typename T>
+    inline size_t argmax(const T *vec, size_t size)
+    {
+        return static_cast<size_t>(std::max_element(vec, vec + size) - vec);
+    }
+
+    template <typename T>
+    inline void exp(const T *vec, size_t size, T *out)
+    {
+        if constexpr (std::is_same_v<T, float>)
         {
-            throw std::invalid_argument("Vectors must be the same size");
+            detail::expSumF32(vec, size, 0.f, out);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                out[i] = std::exp(vec[i]);
         }
-
-        std::vector<T> result(a.size());
-        std::transform(a.begin(), a.end(), b.begin(), result.begin(), std::multiplies<>());
-        return result;
     }
 
-    // Scalar multiplication
     template <typename T>
-    inline std::vector<T> mul(const std::vector<T> &vec, T scalar)
+    inline void sigmoid(const T *logits, size_t size, T *out)
     {
-        std::vector<T> result(vec.size());
-        std::transform(vec.begin(), vec.end(), result.begin(), [scalar](T x)
-                       { return x * scalar; });
-        return result;
+        if constexpr (std::is_same_v<T, float>)
+        {
+            detail::sigmoidF32(logits, size, out);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+                out[i] = T(1) / (T(1) + std::exp(-logits[i]));
+        }
     }
 
-    // Dot product of two vectors
+    // Numerically stable softmax without temporaries: one read-only pass for the max,
+    // one pass writing exp(x - max) while summing, one pass scaling by 1 / sum
     template <typename T>
-    inline T dot(const std::vector<T> &a, const std::vector<T> &b)
+    inline void softmax(const T *logits, size_t size, T *out)
     {
-        if (a.size() != b.size())
+        if (size == 0)
+            return;
+
+        const T max_logit = max(logits, size);
+        T sum_exp = T(0);
+        if constexpr (std::is_same_v<T, float>)
         {
-            throw std::invalid_argument("Vectors must be the same size");
+            sum_exp = detail::expSumF32(logits, size, max_logit, out);
+        }
+        else
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                out[i] = std::exp(logits[i] - max_logit);
+                sum_exp += out[i];
+            }
         }
 
-        return std::inner_product(a.begin(), a.end(), b.begin(), T(0));
+        mul(out, size, T(1) / sum_exp, out);
     }
 
-    // Normalize vector
+    // Softmax of every row of a row-major [rows x cols] matrix
     template <typename T>
-    inline std::vector<T> normalize(const std::vector<T> &vec)
+    inline void softmaxRows(const T *logits, size_t rows, size_t cols, T *out)
+    {
+        for (size_t r = 0; r < rows; ++r)
+            softmax(logits + r * cols, cols, out + r * cols);
+    }
+
+    // Element-wise addition of two vectors
+    template <typename T, typename AllocA, typename AllocB>
+    inline std::vector<T, AllocA> add(const std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
     {
-        std::vector<T> result(vec.size());
-        T norm = std::sqrt(dot(vec, vec));
-        result = mul(vec, T(1) / norm);
+        detail::checkSameSize(a, b);
+        std::vector<T, AllocA> result(a.size(), a.get_allocator());
+        add(a.data(), b.data(), a.size(), result.data());
+        return result;
+    }
+
+    // Scalar add
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> add(const std::vector<T, Alloc> &vec, T scalar)
+    {
+        std::vector<T, Alloc> result(vec.size(), vec.get_allocator());
+        add(vec.data(), vec.size(), scalar, result.data());
+        return result;
+    }
+
+    // Element-wise multiplication of two vectors
+    template <typename T, typename AllocA, typename AllocB>
+    inline std::vector<T, AllocA> mul(const std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
+    {
+        detail::checkSameSize(a, b);
+        std::vector<T, AllocA> result(a.size(), a.get_allocator());
+        mul(a.data(), b.data(), a.size(), result.data());
+        return result;
+    }
+
+    // Scalar multiplication
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> mul(const std::vector<T, Alloc> &vec, T scalar)
+    {
+        std::vector<T, Alloc> result(vec.size(), vec.get_allocator());
+        mul(vec.data(), vec.size(), scalar, result.data());
+        return result;
+    }
+
+    // Dot product of two vectors
+    template <typename T, typename AllocA, typename AllocB>
+    inline T dot(const std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
+    {
+        detail::checkSameSize(a, b);
+        return dot(a.data(), b.data(), a.size());
+    }
+
+    // Normalize vector
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> normalize(const std::vector<T, Alloc> &vec)
+    {
+        std::vector<T, Alloc> result(vec.size(), vec.get_allocator());
+        normalize(vec.data(), vec.size(), result.data());
         return result;
     }
 
     // Compose 2 vectors with a weighted average
-    template <typename T>
-    inline std::vector<T> compose(const std::vector<T> &a, const std::vector<T> &b, T alpha)
+    template <typename T, typename AllocA, typename AllocB>
+    inline std::vector<T, AllocA> compose(const std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b, T alpha)
     {
-        if (a.size() != b.size())
-        {
-            throw std::invalid_argument("Vectors must be the same size");
-        }
-        const T alpha_complement = T(1) - alpha;
-        std::vector<T> result(a.size());
-        std::transform(a.begin(), a.end(), b.begin(), result.begin(), [alpha, alpha_complement](T x, T y)
-                       { return alpha * x + alpha_complement * y; });
+        detail::checkSameSize(a, b);
+        std::vector<T, AllocA> result(a.size(), a.get_allocator());
+        compose(a.data(), b.data(), a.size(), alpha, result.data());
         return result;
     }
 
     // Sum vector
-    template <typename T>
-    inline T sum(const std::vector<T> &vec)
+    template <typename T, typename Alloc>
+    inline T sum(const std::vector<T, Alloc> &vec)
     {
-        return std::accumulate(vec.begin(), vec.end(), T(0));
+        return sum(vec.data(), vec.size());
     }
 
     // Mean vector
-    template <typename T>
-    inline T mean(const std::vector<T> &vec)
+    template <typename T, typename Alloc>
+    inline T mean(const std::vector<T, Alloc> &vec)
     {
-        if (vec.empty())
-        {
-            return T(0);
-        }
-        T size = static_cast<T>(vec.size());
-        return sum(vec) / size;
+        return mean(vec.data(), vec.size());
     }
 
     // Max vector
-    template <typename T>
-    inline T max(const std::vector<T> &vec)
+    template <typename T, typename Alloc>
+    inline T max(const std::vector<T, Alloc> &vec)
     {
         if (vec.empty())
         {
             throw std::invalid_argument("Cannot find maximum of empty vector");
         }
-        return *std::max_element(vec.begin(), vec.end());
+        return max(vec.data(), vec.size());
     }
 
-    template <typename T>
-    inline size_t argmax(const std::vector<T> &vec)
+    template <typename T, typename Alloc>
+    inline size_t argmax(const std::vector<T, Alloc> &vec)
     {
         if (vec.empty())
         {
             throw std::invalid_argument("Cannot find maximum of empty vector");
         }
-        return std::distance(vec.begin(), std::max_element(vec.begin(), vec.end()));
+        return argmax(vec.data(), vec.size());
     }
 
     // Exp vector
-    template <typename T>
-    inline std::vector<T> exp(const std::vector<T> &vec)
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> exp(const std::vector<T, Alloc> &vec)
     {
-        std::vector<T> result(vec.size());
-        std::transform(vec.begin(), vec.end(), result.begin(), [](T x)
-                       { return std::exp(x); });
+        std::vector<T, Alloc> result(vec.size(), vec.get_allocator());
+        exp(vec.data(), vec.size(), result.data());
         return result;
     }
 
     // Slice vector
-    template <typename T>
-    inline std::vector<T> slice(const std::vector<T> &vec, int start, int end)
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> slice(const std::vector<T, Alloc> &vec, int start, int end)
     {
         auto first = vec.begin() + start;
         auto last = vec.begin() + end;
-        std::vector<T> sliced(first, last);
+        std::vector<T, Alloc> sliced(first, last, vec.get_allocator());
         return sliced;
     }
 
     // Sigmoid
-    template <typename T>
-    inline std::vector<T> sigmoid(const std::vector<T> &logits)
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> sigmoid(const std::vector<T, Alloc> &logits)
     {
-        if (logits.empty())
-        {
-            return std::vector<T>();
-        }
-
-        std::vector<T> results(logits.size());
-        std::transform(logits.begin(), logits.end(), results.begin(),
-                       [](T x)
-                       {
-                           return T(1) / (T(1) + std::exp(-x));
-                       });
+        std::vector<T, Alloc> results(logits.size(), logits.get_allocator());
+        sigmoid(logits.data(), logits.size(), results.data());
         return results;
     }
 
     // Softmax
-    template <typename T>
-    inline std::vector<T> softmax(const std::vector<T> &logits)
+    template <typename T, typename Alloc>
+    inline std::vector<T, Alloc> softmax(const std::vector<T, Alloc> &logits)
     {
-        if (logits.empty())
-        {
-            return std::vector<T>();
-        }
+        std::vector<T, Alloc> results(logits.size(), logits.get_allocator());
+        softmax(logits.data(), logits.size(), results.data());
+        return results;
+    }
 
-        if (logits.size() == 1)
-        {
-            return std::vector<T>{T(1)};
-        }
+    // In-place variants, reusing the storage of their first argument
+    template <typename T, typename AllocA, typename AllocB>
+    inline void addInPlace(std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
+    {
+        detail::checkSameSize(a, b);
+        add(a.data(), b.data(), a.size(), a.data());
+    }
+
+    template <typename T, typename Alloc>
+    inline void addInPlace(std::vector<T, Alloc> &vec, T scalar)
+    {
+        add(vec.data(), vec.size(), scalar, vec.data());
+    }
+
+    template <typename T, typename AllocA, typename AllocB>
+    inline void mulInPlace(std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b)
+    {
+        detail::checkSameSize(a, b);
+        mul(a.data(), b.data(), a.size(), a.data());
+    }
 
-        std::vector<T> exp_values(logits.size());
+    template <typename T, typename Alloc>
+    inline void mulInPlace(std::vector<T, Alloc> &vec, T scalar)
+    {
+        mul(vec.data(), vec.size(), scalar, vec.data());
+    }
+
+    template <typename T, typename Alloc>
+    inline void normalizeInPlace(std::vector<T, Alloc> &vec)
+    {
+        normalize(vec.data(), vec.size(), vec.data());
+    }
+
+    template <typename T, typename AllocA, typename AllocB>
+    inline void composeInPlace(std::vector<T, AllocA> &a, const std::vector<T, AllocB> &b, T alpha)
+    {
+        detail::checkSameSize(a, b);
+        compose(a.data(), b.data(), a.size(), alpha, a.data());
+    }
 
-        // Subtract max_logit from all logits to avoid overflow in exponentiation
-        T max_logit = vector_ops::max(logits); // Now safe since we checked empty case
-        exp_values = vector_ops::exp(vector_ops::add(logits, -max_logit));
-        T sum_exp = vector_ops::sum(exp_values);
+    template <typename T, typename Alloc>
+    inline void expInPlace(std::vector<T, Alloc> &vec)
+    {
+        exp(vec.data(), vec.size(), vec.data());
+    }
 
-        return vector_ops::mul(exp_values, T(1) / sum_exp);
+    template <typename T, typename Alloc>
+    inline void sigmoidInPlace(std::vector<T, Alloc> &logits)
+    {
+        sigmoid(logits.data(), logits.size(), logits.data());
+    }
+
+    template <typename T, typename Alloc>
+    inline void softmaxInPlace(std::vector<T, Alloc> &logits)
+    {
+        softmax(logits.data(), logits.size(), logits.data());
     }
 
 } // namespace vector_ops
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <utils/ann_utils.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+class AnnUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Clustered embeddings, as produced by several views of the same identities
+        cv::RNG rng(11);
+        std::vector<std::vector<float>> centers(50, std::vector<float>(dim));
+        for (auto &center : centers)
+            for (auto &v : center)
+                v = rng.uniform(-1.f, 1.f);
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::vector<float> features = centers[i % centers.size()];
+            for (auto &v : features)
+                v += rng.gaussian(0.3f);
+            gallery.push_back(features);
+        }
+    }
+
+    // Exact top-k track ids by brute-force cosineSimilarity
+    std::vector<int64_t> bruteForce(const std::vector<float> &query, size_t k) const
+    {
+        std::vector<std::pair<float, int64_t>> scored;
+        for (size_t i = 0; i < gallery.size(); ++i)
+            scored.emplace_back(cosineSimilarity(query, gallery[i]), static_cast<int64_t>(i));
+        std::partial_sort(scored.begin(), scored.begin() + k, scored.end(), std::greater<>());
+
+        std::vector<int64_t> ids;
+        for (size_t n = 0; n < k; ++n)
+            ids.push_back(scored[n].second);
+        return ids;
+    }
+
+    const size_t dim = 32;
+    std::vector<std::vector<float>> gallery;
+};
+
+TEST_F(AnnUtilsTest, RecallAgainstBruteForce)
+{
+    HnswIndex index(dim);
+    for (size_t i = 0; i < gallery.size(); ++i)
+        index.insert(static_cast<int64_t>(i), gallery[i]);
+    EXPECT_EQ(index.size(), gallery.size());
+
+    const size_t k = 10;
+    size_t hits = 0, total = 0;
+    for (size_t q = 0; q < 100; ++q)
+    {
+        const auto &query = gallery[q * 7];
+        auto expected = bruteForce(query, k);
+        auto results = index.search(query, k);
+        ASSERT_EQ(results.size(), k);
+        EXPECT_TRUE(std::is_sorted(results.begin(), results.end(), [](const AnnResult &a, const AnnResult &b)
+                                   { return a.similarity > b.similarity; }));
+
+        for (const auto &result : results)
+            hits += std::count(expected.begin(), expected.end(), result.track_id);
+        total += k;
+    }
+    EXPECT_GT(static_cast<double>(hits) / total, 0.95);
+}
+
+TEST_F(AnnUtilsTest, SimilarityConventionAndThreshold)
+{
+    HnswIndex index(dim);
+    index.insert(1, gallery[0]);
+    index.insert(2, gallery[1]);
+
+    auto results = index.search(gallery[0], 2);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].track_id, 1);
+    EXPECT_NEAR(results[0].similarity, 1.f, 1e-5f);
+    EXPECT_NEAR(results[1].similarity, cosineSimilarity(gallery[0], gallery[1]), 1e-5f);
+
+    results = index.search(gallery[0], 2, 0.999f);
+    EXPECT_EQ(results.size(), 1u);
+
+    EXPECT_THROW(index.insert(3, std::vector<float>(dim, 0.f)), std::invalid_argument);
+    EXPECT_THROW(index.insert(3, std::vector<float>(dim + 1, 1.f)), std::invalid_argument);
+}
+
+TEST_F(AnnUtilsTest, EraseByTrackId)
+{
+    HnswIndex index(dim);
+    for (size_t i = 0; i < 200; ++i)
+        index.insert(static_cast<int64_t>(i % 20), gallery[i]);
+
+    EXPECT_EQ(index.erase(3), 10u);
+    EXPECT_EQ(index.erase(3), 0u);
+    EXPECT_EQ(index.size(), 190u);
+
+    auto results = index.search(gallery[3], 50);
+    EXPECT_EQ(results.size(), 50u);
+    for (const auto &result : results)
+        EXPECT_NE(result.track_id, 3);
+}
+
+TEST_F(AnnUtilsTest, SaveLoad)
+{
+    HnswIndex index(dim);
+    for (size_t i = 0; i < 300; ++i)
+        index.insert(static_cast<int64_t>(i), gallery[i]);
+    index.erase(5);
+
+    const std::string path = testing::TempDir() + "hnsw_index_test.bin";
+    index.save(path);
+    HnswIndex loaded = HnswIndex::load(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(loaded.size(), index.size());
+    EXPECT_EQ(loaded.dim(), index.dim());
+    for (size_t q = 0; q < 20; ++q)
+    {
+        auto expected = index.search(gallery[q], 5);
+        auto results = loaded.search(gallery[q], 5);
+        ASSERT_EQ(results.size(), expected.size());
+        for (size_t n = 0; n < results.size(); ++n)
+        {
+            EXPECT_EQ(results[n].track_id, expected[n].track_id);
+            EXPECT_FLOAT_EQ(results[n].similarity, expected[n].similarity);
+        }
+    }
+
+    EXPECT_THROW(HnswIndex::load(path), std::runtime_error);
+}
+
+TEST_F(AnnUtilsTest, LoadRejectsCorruptFile)
+{
+    HnswIndex index(dim);
+    for (size_t i = 0; i < 50; ++i)
+        index.insert(static_cast<int64_t>(i), gallery[i]);
+
+    const std::string path = testing::TempDir() + "hnsw_corrupt_test.bin";
+    index.save(path);
+    std::ifstream is(path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    is.close();
+    ASSERT_NO_THROW(HnswIndex::load(path));
+
+    // Header is magic, dim, M, ef_construction, ef_search, seed, count, entry, max_level
+    const size_t count_offset = 8 + 4 * 8 + 4;
+    const size_t levels_offset = 60 + 50 * (dim * sizeof(float) + sizeof(int64_t));
+    const size_t links_offset = levels_offset + 50 * (sizeof(int) + 1);
+
+    auto expectCorrupt = [&](size_t offset, const void *value, size_t size)
+    {
+        std::string corrupt = bytes;
+        corrupt.replace(offset, size, static_cast<const char *>(value), size);
+        std::ofstream(path, std::ios::binary) << corrupt;
+        EXPECT_THROW(HnswIndex::load(path), std::runtime_error) << "offset " << offset;
+    };
+
+    const uint64_t huge_count = uint64_t(1) << 40;
+    expectCorrupt(count_offset, &huge_count, sizeof(huge_count));
+    const uint32_t bad_entry = 50;
+    expectCorrupt(count_offset + 8, &bad_entry, sizeof(bad_entry));
+    const int bad_level = 1000;
+    expectCorrupt(levels_offset, &bad_level, sizeof(bad_level));
+    const int negative_level = -1;
+    expectCorrupt(levels_offset + sizeof(int), &negative_level, sizeof(negative_level));
+    // First link block of node 0: a neighbour count above 2M, then a neighbour id past the end
+    const uint32_t bad_links = 1000;
+    expectCorrupt(links_offset, &bad_links, sizeof(bad_links));
+    const uint32_t bad_neighbour = 12345;
+    expectCorrupt(links_offset + sizeof(uint32_t), &bad_neighbour, sizeof(bad_neighbour));
+
+    std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 3);
+    EXPECT_THROW(HnswIndex::load(path), std::runtime_error);
+    std::remove(path.c_str());
+}
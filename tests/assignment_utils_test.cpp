@@ -0,0 +1,210 @@
+#include <limits>
+#include <functional>
+#include <gtest/gtest.h>
+#include <utils/assignment_utils.hpp>
+
+class AssignmentUtilsTest : public ::testing::Test
+{
+protected:
+    static std::vector<float> randomCosts(size_t rows, size_t cols, cv::RNG &rng)
+    {
+        std::vector<float> cost(rows * cols);
+        for (float &c : cost)
+            c = rng.uniform(0.f, 1.f);
+        return cost;
+    }
+
+    // Objective of a matching: sum of matched costs minus max_cost per match, 0 for unmatched rows
+    static double objective(const std::vector<float> &cost, size_t cols, const std::vector<int> &row_to_col, float max_cost)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < row_to_col.size(); ++i)
+            if (row_to_col[i] >= 0)
+                total += cost[i * cols + row_to_col[i]] - max_cost;
+        return total;
+    }
+
+    // Exhaustive search over matchings; rows may stay unmatched when allowed, otherwise the
+    // matching must have min(rows, cols) pairs
+    static double bruteForce(const std::vector<float> &cost, size_t rows, size_t cols, float max_cost, bool gated)
+    {
+        std::vector<bool> used(cols, false);
+        double best = std::numeric_limits<double>::infinity();
+        std::function<void(size_t, size_t, double)> search = [&](size_t i, size_t matched, double total)
+        {
+            if (i == rows)
+            {
+                if (gated || matched == std::min(rows, cols))
+                    best = std::min(best, total);
+                return;
+            }
+            if (gated || rows - i > cols - matched)
+                search(i + 1, matched, total);
+            for (size_t j = 0; j < cols; ++j)
+            {
+                if (used[j] || (gated && cost[i * cols + j] > max_cost))
+                    continue;
+                used[j] = true;
+                search(i + 1, matched + 1, total + cost[i * cols + j] - (gated ? max_cost : 0.f));
+                used[j] = false;
+            }
+        };
+        search(0, 0, 0.0);
+        return best;
+    }
+
+    static void expectConsistent(const std::vector<int> &row_to_col, const std::vector<int> &col_to_row, size_t matches)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < row_to_col.size(); ++i)
+        {
+            if (row_to_col[i] < 0)
+                continue;
+            ++count;
+            EXPECT_EQ(col_to_row[row_to_col[i]], static_cast<int>(i));
+        }
+        EXPECT_EQ(count, matches);
+    }
+
+    AssignmentWorkspace ws;
+    std::vector<int> row_to_col, col_to_row;
+};
+
+TEST_F(AssignmentUtilsTest, SmallSquare)
+{
+    const std::vector<float> cost = {
+        4.f, 1.f, 3.f,
+        2.f, 0.f, 5.f,
+        3.f, 2.f, 2.f};
+    const float no_gate = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(solveAssignment(cost.data(), 3, 3, no_gate, ws, row_to_col, col_to_row), 3u);
+    EXPECT_EQ(row_to_col, (std::vector<int>{1, 0, 2}));
+    EXPECT_EQ(col_to_row, (std::vector<int>{1, 0, 2}));
+
+    const std::vector<float> single = {3.f};
+    EXPECT_EQ(solveAssignment(single.data(), 1, 1, no_gate, ws, row_to_col, col_to_row), 1u);
+    EXPECT_EQ(solveAssignment(single.data(), 1, 1, 2.f, ws, row_to_col, col_to_row), 0u);
+    EXPECT_EQ(row_to_col[0], -1);
+    EXPECT_EQ(solveAssignment(nullptr, 0, 5, no_gate, ws, row_to_col, col_to_row), 0u);
+    EXPECT_EQ(col_to_row, std::vector<int>(5, -1));
+}
+
+TEST_F(AssignmentUtilsTest, DenseMatchesBruteForce)
+{
+    cv::RNG rng(7);
+    const float no_gate = std::numeric_limits<float>::infinity();
+    // Square, wide and tall, with and without gating
+    for (auto [rows, cols] : {std::pair<size_t, size_t>{6, 6}, {4, 7}, {7, 4}, {2, 2}})
+    {
+        for (int trial = 0; trial < 20; ++trial)
+        {
+            const std::vector<float> cost = randomCosts(rows, cols, rng);
+
+            size_t matches = solveAssignment(cost.data(), rows, cols, no_gate, ws, row_to_col, col_to_row);
+            EXPECT_EQ(matches, std::min(rows, cols));
+            expectConsistent(row_to_col, col_to_row, matches);
+            EXPECT_NEAR(objective(cost, cols, row_to_col, 0.f), bruteForce(cost, rows, cols, 0.f, false), 1e-5);
+
+            const float max_cost = 0.4f;
+            matches = solveAssignment(cost.data(), rows, cols, max_cost, ws, row_to_col, col_to_row);
+            expectConsistent(row_to_col, col_to_row, matches);
+            for (size_t i = 0; i < rows; ++i)
+            {
+                if (row_to_col[i] >= 0)
+                {
+                    EXPECT_LE(cost[i * cols + row_to_col[i]], max_cost);
+                }
+            }
+            EXPECT_NEAR(objective(cost, cols, row_to_col, max_cost), bruteForce(cost, rows, cols, max_cost, true), 1e-5);
+        }
+    }
+}
+
+TEST_F(AssignmentUtilsTest, TiesAndLargeProblems)
+{
+    // Many equal costs stress the augmenting row reduction
+    const size_t n = 60;
+    std::vector<float> ties(n * n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+            ties[i * n + j] = static_cast<float>((i + j) % 3);
+    const float no_gate = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(solveAssignment(ties.data(), n, n, no_gate, ws, row_to_col, col_to_row), n);
+    EXPECT_NEAR(objective(ties, n, row_to_col, 0.f), 0.0, 1e-6);
+
+    // A shuffled identity: the permutation is the only zero-cost matching
+    cv::RNG rng(3);
+    const size_t m = 300;
+    std::vector<int> permutation(m);
+    for (size_t i = 0; i < m; ++i)
+        permutation[i] = static_cast<int>(i);
+    for (size_t i = m - 1; i > 0; --i)
+        std::swap(permutation[i], permutation[rng.uniform(0, static_cast<int>(i) + 1)]);
+    std::vector<float> cost = randomCosts(m, m, rng);
+    for (size_t i = 0; i < m; ++i)
+    {
+        for (size_t j = 0; j < m; ++j)
+            cost[i * m + j] += 0.01f;
+        cost[i * m + permutation[i]] = 0.f;
+    }
+    EXPECT_EQ(solveAssignment(cost.data(), m, m, no_gate, ws, row_to_col, col_to_row), m);
+    EXPECT_EQ(row_to_col, permutation);
+}
+
+TEST_F(AssignmentUtilsTest, SparseMatchesDense)
+{
+    cv::RNG rng(11);
+    const float max_cost = 0.6f;
+    std::vector<int> dense_rows, dense_cols;
+    for (auto [rows, cols] : {std::pair<size_t, size_t>{6, 6}, {5, 8}, {8, 5}, {40, 35}})
+    {
+        for (int trial = 0; trial < 10; ++trial)
+        {
+            // About a third of the pairs are candidates, the rest are priced out of the gate
+            std::vector<float> cost(rows * cols, 10.f);
+            std::vector<AssignmentCandidate> candidates;
+            for (size_t i = 0; i < rows; ++i)
+            {
+                for (size_t j = 0; j < cols; ++j)
+                {
+                    if (rng.uniform(0.f, 1.f) < 0.35f)
+                    {
+                        cost[i * cols + j] = rng.uniform(0.f, 1.f);
+                        candidates.push_back({static_cast<int>(i), static_cast<int>(j), cost[i * cols + j]});
+                    }
+                }
+            }
+
+            const size_t matches = solveAssignment(candidates, rows, cols, max_cost, ws, row_to_col, col_to_row);
+            expectConsistent(row_to_col, col_to_row, matches);
+            solveAssignment(cost.data(), rows, cols, max_cost, ws, dense_rows, dense_cols);
+            EXPECT_NEAR(objective(cost, cols, row_to_col, max_cost), objective(cost, cols, dense_rows, max_cost), 1e-5);
+            if (rows * cols <= 64)
+            {
+                EXPECT_NEAR(objective(cost, cols, row_to_col, max_cost), bruteForce(cost, rows, cols, max_cost, true), 1e-5);
+            }
+        }
+    }
+
+    const std::vector<AssignmentCandidate> out_of_range = {{0, 3, 0.1f}};
+    EXPECT_THROW(solveAssignment(out_of_range, 2, 3, max_cost, ws, row_to_col, col_to_row), std::invalid_argument);
+    EXPECT_THROW(solveAssignment(std::vector<AssignmentCandidate>(), 2, 3, std::numeric_limits<float>::infinity(), ws, row_to_col, col_to_row),
+                 std::invalid_argument);
+}
+
+TEST_F(AssignmentUtilsTest, BoxOverlapMatching)
+{
+    // Detections are the tracks shifted slightly and listed in reverse, plus one new box
+    const std::vector<cv::Rect2f> tracks = {{0.f, 0.f, 10.f, 10.f}, {20.f, 0.f, 10.f, 10.f}, {40.f, 0.f, 10.f, 10.f}};
+    const std::vector<cv::Rect2f> detections = {{100.f, 100.f, 10.f, 10.f}, {41.f, 1.f, 10.f, 10.f}, {22.f, 0.f, 10.f, 10.f}, {1.f, 0.f, 10.f, 10.f}};
+
+    std::vector<BoxOverlap> overlaps;
+    findOverlaps(tracks, detections, 0.f, overlaps);
+    EXPECT_EQ(solveAssignment(overlaps, tracks.size(), detections.size(), 0.7f, ws, row_to_col, col_to_row), 3u);
+    EXPECT_EQ(row_to_col, (std::vector<int>{3, 2, 1}));
+    EXPECT_EQ(col_to_row, (std::vector<int>{-1, 2, 1, 0}));
+
+    // A stricter gate drops the weakest pair
+    EXPECT_EQ(solveAssignment(overlaps, tracks.size(), detections.size(), 0.325f, ws, row_to_col, col_to_row), 2u);
+    EXPECT_EQ(row_to_col, (std::vector<int>{3, -1, 1}));
+}
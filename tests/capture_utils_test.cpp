@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <utils/capture_utils.hpp>
+
+// Synthetic source: frame i is an 8x8 image filled with i
+class FakeCapture : public cv::VideoCapture
+{
+public:
+    explicit FakeCapture(int num_frames, bool opened = true) : num_frames_(num_frames), opened_(opened)
+    {
+        grab_times.reserve(num_frames);
+        decode_times.reserve(num_frames);
+    }
+
+    bool isOpened() const override { return opened_; }
+
+    bool grab() override
+    {
+        if (index_ >= num_frames_)
+            return false;
+        grab_times.push_back(std::chrono::system_clock::now());
+        return true;
+    }
+
+    bool retrieve(cv::OutputArray image, int = 0) override
+    {
+        if (index_ == fail_at)
+            throw std::runtime_error("Decoder failure");
+        std::this_thread::sleep_for(std::chrono::milliseconds(decode_ms));
+        decode_times.push_back(std::chrono::system_clock::now());
+        image.create(8, 8, CV_8UC1);
+        image.setTo(cv::Scalar(index_++));
+        return true;
+    }
+
+    int decode_ms{0};
+    int fail_at{-1};
+    std::vector<TimePoint> grab_times;
+    std::vector<TimePoint> decode_times;
+
+private:
+    int num_frames_;
+    int index_{0};
+    bool opened_;
+};
+
+static void waitForCaptured(const AsyncCapture &capture, size_t count)
+{
+    while (capture.stats().captured < count)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+TEST(AsyncCaptureTest, BlockDeliversEveryFrame)
+{
+    AsyncCapture capture(std::make_unique<FakeCapture>(10), {2, QueuePolicy::Block});
+
+    Frame frame;
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(capture.read(frame));
+        EXPECT_EQ(frame.image.at<uchar>(0, 0), i);
+        EXPECT_EQ(frame.size, cv::Size(8, 8));
+    }
+    EXPECT_FALSE(capture.read(frame));
+    EXPECT_EQ(frame.getId(), 9);
+
+    EXPECT_EQ(capture.stats().captured, 10u);
+    EXPECT_EQ(capture.stats().dropped, 0u);
+    EXPECT_EQ(capture.stats().depth, 0u);
+    EXPECT_GT(capture.poolStats().hits, 0u);
+}
+
+TEST(AsyncCaptureTest, DropPolicies)
+{
+    {
+        AsyncCapture capture(std::make_unique<FakeCapture>(10), {3, QueuePolicy::DropOldest});
+        waitForCaptured(capture, 10);
+        EXPECT_EQ(capture.stats().dropped, 7u);
+        EXPECT_EQ(capture.stats().depth, 3u);
+
+        Frame frame;
+        for (int i = 7; i < 10; ++i)
+        {
+            ASSERT_TRUE(capture.read(frame));
+            EXPECT_EQ(frame.image.at<uchar>(0, 0), i);
+        }
+        EXPECT_FALSE(capture.read(frame));
+    }
+    {
+        AsyncCapture capture(std::make_unique<FakeCapture>(10), {3, QueuePolicy::DropNewest});
+        waitForCaptured(capture, 10);
+        EXPECT_EQ(capture.stats().dropped, 7u);
+
+        Frame frame;
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_TRUE(capture.read(frame));
+            EXPECT_EQ(frame.image.at<uchar>(0, 0), i);
+        }
+        EXPECT_FALSE(capture.read(frame));
+    }
+}
+
+TEST(AsyncCaptureTest, TimestampTakenAtGrab)
+{
+    auto source = std::make_unique<FakeCapture>(3);
+    FakeCapture *fake = source.get();
+    fake->decode_ms = 5;
+    AsyncCapture capture(std::move(source), {4, QueuePolicy::Block});
+
+    Frame frame;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(capture.read(frame));
+        EXPECT_GE(frame.timestamp, fake->grab_times[i]);
+        EXPECT_LT(frame.timestamp, fake->decode_times[i]);
+    }
+}
+
+TEST(AsyncCaptureTest, StreamIds)
+{
+    AsyncCapture camera1(std::make_unique<FakeCapture>(3), {4, QueuePolicy::Block, 11});
+    AsyncCapture camera2(std::make_unique<FakeCapture>(3), {4, QueuePolicy::Block});
+    EXPECT_EQ(camera1.streamId(), 11);
+    EXPECT_GT(camera2.streamId(), 0);
+
+    Frame frame;
+    for (int64_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(camera1.read(frame));
+        EXPECT_EQ(frame.getStreamId(), 11);
+        EXPECT_EQ(frame.getId(), i);
+
+        ASSERT_TRUE(camera2.read(frame));
+        EXPECT_EQ(frame.getStreamId(), camera2.streamId());
+        EXPECT_EQ(frame.getId(), i);
+    }
+}
+
+TEST(AsyncCaptureTest, StopUnblocksProducer)
+{
+    AsyncCapture capture(std::make_unique<FakeCapture>(1000), {1, QueuePolicy::Block});
+
+    Frame frame;
+    ASSERT_TRUE(capture.read(frame));
+    capture.stop();
+    size_t delivered = 1;
+    while (capture.tryRead(frame))
+        ++delivered;
+    EXPECT_FALSE(capture.read(frame));
+    EXPECT_LT(capture.stats().captured, 1000u);
+
+    // The frame blocked in push when the queue closed was never delivered nor counted
+    EXPECT_EQ(capture.stats().captured, delivered);
+}
+
+TEST(AsyncCaptureTest, Errors)
+{
+    EXPECT_THROW(AsyncCapture(std::make_unique<FakeCapture>(10, false)), std::runtime_error);
+
+    auto source = std::make_unique<FakeCapture>(10);
+    source->fail_at = 2;
+    AsyncCapture capture(std::move(source), {4, QueuePolicy::Block});
+
+    Frame frame;
+    EXPECT_TRUE(capture.read(frame));
+    EXPECT_TRUE(capture.read(frame));
+    EXPECT_THROW(capture.read(frame), std::runtime_error);
+}
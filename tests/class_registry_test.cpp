@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <types/detection.hpp>
+
+TEST(ClassNameTest, Interned)
+{
+    std::string temporary = "person";
+    ClassName name = temporary;
+    temporary = "changed";
+
+    EXPECT_EQ(name, "person");
+    EXPECT_EQ(name, std::string("person"));
+    EXPECT_EQ(name.size(), 6u);
+    EXPECT_EQ(name.data(), ClassName("person").data());
+    EXPECT_EQ(name, ClassName(std::string_view("person")));
+    EXPECT_NE(name, ClassName("car"));
+
+    EXPECT_TRUE(ClassName().empty());
+    EXPECT_EQ(ClassName(""), ClassName());
+
+    std::ostringstream stream;
+    stream << name;
+    EXPECT_EQ(stream.str(), "person");
+}
+
+TEST(ClassRegistryTest, Lookup)
+{
+    ClassRegistry registry({"person", "bicycle", "car"});
+    EXPECT_EQ(registry.size(), 3u);
+    EXPECT_EQ(registry.name(1), "bicycle");
+    EXPECT_TRUE(registry.name(3).empty());
+    EXPECT_TRUE(registry.name(-1).empty());
+    EXPECT_EQ(registry.id("car"), 2);
+    EXPECT_EQ(registry.id("truck"), -1);
+
+    // Existing names keep their id, new ones go after the highest id
+    EXPECT_EQ(registry.add("person"), 0);
+    EXPECT_EQ(registry.add("truck"), 3);
+
+    // Renaming drops the old name
+    registry.set(10, "bus");
+    registry.set(10, "coach");
+    EXPECT_EQ(registry.size(), 11u);
+    EXPECT_EQ(registry.id("bus"), -1);
+    EXPECT_EQ(registry.id("coach"), 10);
+    EXPECT_THROW(registry.set(-1, "invalid"), std::invalid_argument);
+
+    EXPECT_THROW(registry.add(""), std::invalid_argument);
+
+    ClassRegistry copy = registry;
+    registry.clear();
+    EXPECT_EQ(registry.size(), 0u);
+    EXPECT_EQ(copy.name(10), "coach");
+}
+
+TEST(ClassRegistryTest, RepeatedNames)
+{
+    // Label files such as torchvision's COCO list repeat placeholder names
+    ClassRegistry registry({"person", "N/A", "car", "N/A"});
+    EXPECT_EQ(registry.name(3), "N/A");
+    EXPECT_EQ(registry.id("N/A"), 1);
+
+    // Renaming a later duplicate keeps the lowest id, renaming the lowest one hands the name on
+    registry.set(3, "truck");
+    EXPECT_EQ(registry.id("N/A"), 1);
+    registry.set(5, "N/A");
+    registry.set(1, "bicycle");
+    EXPECT_EQ(registry.id("N/A"), 5);
+    registry.set(0, "N/A");
+    EXPECT_EQ(registry.id("N/A"), 0);
+    EXPECT_EQ(registry.id("person"), -1);
+    registry.set(4, "");
+    EXPECT_TRUE(registry.name(4).empty());
+}
+
+TEST(ClassRegistryTest, DetectionName)
+{
+    ClassRegistry registry({"person", "car"});
+    Detection det;
+    det.class_id = 1;
+    EXPECT_EQ(det.getClassName(registry), "car");
+
+    // An explicit name wins over the registry
+    det.class_name = "vehicle";
+    EXPECT_EQ(det.getClassName(registry), "vehicle");
+
+    det.class_name = ClassName();
+    det.class_id = 7;
+    EXPECT_TRUE(det.getClassName(registry).empty());
+
+    ClassRegistry::global().set(7, "global_class");
+    EXPECT_EQ(det.getClassName(), "global_class");
+    ClassRegistry::global().clear();
+}
+
+TEST(LabelSetTest, SortedInsertAndErase)
+{
+    LabelSet labels = {{5, "e"}, {1, "a"}, {3, "c"}};
+    ASSERT_EQ(labels.size(), 3u);
+    EXPECT_EQ(labels.begin()->first, 1);
+    EXPECT_EQ(labels[3], "c");
+    EXPECT_EQ(labels.count(2), 0u);
+
+    // Grows past the inline capacity into the heap and keeps ids sorted
+    labels[2] = "b";
+    labels[4] = "d";
+    EXPECT_FALSE(labels.emplace(4, "other"));
+    EXPECT_TRUE(labels.emplace(0, "zero"));
+    ASSERT_EQ(labels.size(), 6u);
+    int expected = 0;
+    for (const auto &[id, name] : labels)
+        EXPECT_EQ(id, expected++) << name;
+    EXPECT_EQ(labels.find(4)->second, "d");
+
+    LabelSet copy = labels;
+    EXPECT_EQ(copy, labels);
+
+    EXPECT_EQ(labels.erase(0), 1u);
+    EXPECT_EQ(labels.erase(0), 0u);
+    EXPECT_EQ(labels.size(), 5u);
+    EXPECT_EQ(labels.begin()->second, "a");
+    EXPECT_NE(copy, labels);
+
+    labels.clear();
+    EXPECT_TRUE(labels.empty());
+    labels[9] = "i";
+    EXPECT_EQ(labels.size(), 1u);
+    EXPECT_EQ(labels.find(9)->second, "i");
+}
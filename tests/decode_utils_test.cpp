@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <utils/decode_utils.hpp>
+
+class DecodeTest : public testing::TestWithParam<simd::Level>
+{
+protected:
+    void SetUp() override
+    {
+        simd::setLevel(GetParam());
+
+        // 200x100 image letterboxed to 320x320: scale 1.6, 80 rows of padding on top
+        LetterboxParams letterbox_params;
+        letterbox_params.new_shape = cv::Size(320, 320);
+        info = getLetterboxInfo(cv::Size(200, 100), letterbox_params);
+    }
+
+    void TearDown() override
+    {
+        simd::setLevel(simd::detectLevel());
+    }
+
+    // Pseudo-random class scores in [0, 0.5) with a few confident anchors, [anchors][attributes]
+    static std::vector<float> makeOutput(size_t num_anchors, int num_classes, size_t first_score)
+    {
+        const size_t num_attributes = first_score + static_cast<size_t>(num_classes);
+        std::vector<float> output(num_anchors * num_attributes);
+        uint32_t state = 12345;
+        for (size_t a = 0; a < num_anchors; ++a)
+        {
+            float *row = output.data() + a * num_attributes;
+            row[0] = 160.f + static_cast<float>(a);
+            row[1] = 160.f;
+            row[2] = 32.f;
+            row[3] = 16.f;
+            for (size_t k = 4; k < num_attributes; ++k)
+            {
+                state = state * 1664525u + 1013904223u;
+                row[k] = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 0.5f;
+            }
+            if (a % 7 == 3)
+                row[first_score + a % num_classes] = 0.6f + 0.01f * static_cast<float>(a % 10);
+        }
+        return output;
+    }
+
+    static std::vector<float> transpose(const std::vector<float> &output, size_t num_anchors)
+    {
+        const size_t num_attributes = output.size() / num_anchors;
+        std::vector<float> result(output.size());
+        for (size_t a = 0; a < num_anchors; ++a)
+            for (size_t k = 0; k < num_attributes; ++k)
+                result[k * num_anchors + a] = output[a * num_attributes + k];
+        return result;
+    }
+
+    LetterboxInfo info;
+};
+
+TEST_P(DecodeTest, LayoutsMatchReference)
+{
+    const size_t num_anchors = 101; // SIMD blocks plus a scalar tail
+    const int num_classes = 7;
+    std::vector<float> anchors_first = makeOutput(num_anchors, num_classes, 4);
+    std::vector<float> attributes_first = transpose(anchors_first, num_anchors);
+
+    DecodeParams params;
+    params.score_threshold = 0.55f;
+
+    // Reference: plain argmax per anchor
+    std::vector<std::pair<int, float>> expected;
+    for (size_t a = 0; a < num_anchors; ++a)
+    {
+        const float *classes = anchors_first.data() + a * (4 + num_classes) + 4;
+        const size_t best = vector_ops::argmax(classes, num_classes);
+        if (classes[best] >= params.score_threshold)
+            expected.emplace_back(static_cast<int>(best), classes[best]);
+    }
+    ASSERT_FALSE(expected.empty());
+
+    DecodeWorkspace ws;
+    for (DecodeLayout layout : {DecodeLayout::AttributesFirst, DecodeLayout::AnchorsFirst})
+    {
+        params.layout = layout;
+        const float *output = layout == DecodeLayout::AttributesFirst ? attributes_first.data() : anchors_first.data();
+        DetectionBatch batch;
+        ASSERT_EQ(decodeDetections(output, num_anchors, num_classes, params, info, ws, batch, 9), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(batch.class_ids[i], expected[i].first);
+            EXPECT_FLOAT_EQ(batch.confidences[i], expected[i].second);
+            EXPECT_EQ(batch.frame_ids[i], 9);
+            EXPECT_EQ(batch.sizes[i], cv::Size(200, 100));
+        }
+
+        // Anchor 3: center (163, 160) size 32x16 in the model input
+        EXPECT_FLOAT_EQ(batch.bboxes[0].x, (163.f - 16.f) / 1.6f);
+        EXPECT_FLOAT_EQ(batch.bboxes[0].y, (160.f - 8.f - 80.f) / 1.6f);
+        EXPECT_FLOAT_EQ(batch.bboxes[0].width, 20.f);
+        EXPECT_FLOAT_EQ(batch.bboxes[0].height, 10.f);
+    }
+}
+
+TEST_P(DecodeTest, ObjectnessAndSigmoid)
+{
+    // YOLOv5 style logits: anchor 0 passes, anchor 1 has low objectness, anchor 2 a low product
+    const int num_classes = 3;
+    std::vector<float> output = {
+        100.f, 100.f, 20.f, 20.f, 3.f, -2.f, 2.f, 0.f,
+        100.f, 100.f, 20.f, 20.f, -3.f, 5.f, 0.f, 0.f,
+        100.f, 100.f, 20.f, 20.f, 0.f, 0.f, 0.5f, 0.f};
+
+    DecodeParams params;
+    params.layout = DecodeLayout::AnchorsFirst;
+    params.has_objectness = true;
+    params.apply_sigmoid = true;
+    params.score_threshold = 0.5f;
+
+    auto sigmoid = [](float x)
+    { return 1.f / (1.f + std::exp(-x)); };
+
+    DecodeWorkspace ws;
+    DetectionBatch batch;
+    ASSERT_EQ(decodeDetections(output.data(), 3, num_classes, params, info, ws, batch), 1u);
+    EXPECT_EQ(batch.class_ids[0], 1);
+    EXPECT_FLOAT_EQ(batch.confidences[0], sigmoid(3.f) * sigmoid(2.f));
+
+    // Same result from the attributes-first layout
+    batch.clear();
+    params.layout = DecodeLayout::AttributesFirst;
+    std::vector<float> transposed = transpose(output, 3);
+    ASSERT_EQ(decodeDetections(transposed.data(), 3, num_classes, params, info, ws, batch), 1u);
+    EXPECT_EQ(batch.class_ids[0], 1);
+}
+
+TEST_P(DecodeTest, NormalizedCornersWithBackground)
+{
+    // SSD style: normalized corners, class 0 is background and never reported
+    const int num_classes = 3;
+    std::vector<float> output = {
+        0.25f, 0.5f, 0.75f, 0.75f, 0.9f, 0.05f, 0.05f,
+        -0.1f, 0.25f, 0.5f, 1.1f, 0.1f, 0.3f, 0.6f};
+
+    DecodeParams params;
+    params.layout = DecodeLayout::AnchorsFirst;
+    params.box_encoding = BoxEncoding::XyXy;
+    params.normalized_boxes = true;
+    params.background_class = 0;
+    params.score_threshold = 0.5f;
+
+    DecodeWorkspace ws;
+    DetectionBatch batch;
+    ASSERT_EQ(decodeDetections(output.data(), 2, num_classes, params, info, ws, batch), 1u);
+    EXPECT_EQ(batch.class_ids[0], 2);
+    EXPECT_FLOAT_EQ(batch.confidences[0], 0.6f);
+
+    // Clipped to the 200x100 source image
+    const cv::Rect2f &box = batch.bboxes[0];
+    EXPECT_FLOAT_EQ(box.x, 0.f);
+    EXPECT_FLOAT_EQ(box.y, (80.f - 80.f) / 1.6f);
+    EXPECT_FLOAT_EQ(box.width, 100.f);
+    EXPECT_FLOAT_EQ(box.height, 100.f);
+
+    batch.clear();
+    params.layout = DecodeLayout::AttributesFirst;
+    std::vector<float> transposed = transpose(output, 2);
+    ASSERT_EQ(decodeDetections(transposed.data(), 2, num_classes, params, info, ws, batch), 1u);
+    EXPECT_EQ(batch.class_ids[0], 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, DecodeTest,
+                         testing::Values(simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512));
+
+TEST(DecodeBatchTest, BatchedOutput)
+{
+    // Two images, one anchor each, identity mapping
+    std::vector<float> output = {
+        10.f, 10.f, 4.f, 4.f, 0.9f, 0.1f,
+        20.f, 20.f, 4.f, 4.f, 0.1f, 0.2f};
+    std::vector<LetterboxInfo> infos(2);
+
+    DecodeParams params;
+    params.layout = DecodeLayout::AnchorsFirst;
+    DecodeWorkspace ws;
+    std::vector<DetectionBatch> batches;
+    decodeDetections(output.data(), 2, 1, 2, params, infos, ws, batches);
+    ASSERT_EQ(batches.size(), 2u);
+    ASSERT_EQ(batches[0].size(), 1u);
+    EXPECT_EQ(batches[0].bboxes[0], cv::Rect2f(8.f, 8.f, 4.f, 4.f));
+    EXPECT_TRUE(batches[1].empty());
+
+    EXPECT_THROW(decodeDetections(output.data(), 2, 1, 2, params, std::vector<LetterboxInfo>(1), ws, batches), std::invalid_argument);
+    EXPECT_THROW(decodeDetections(output.data(), 1, 0, params, infos[0], ws, batches[0]), std::invalid_argument);
+
+    // The background must be a class id and leave at least one class to report
+    params.background_class = 2;
+    EXPECT_THROW(decodeDetections(output.data(), 1, 2, params, infos[0], ws, batches[0]), std::invalid_argument);
+    params.background_class = -2;
+    EXPECT_THROW(decodeDetections(output.data(), 1, 2, params, infos[0], ws, batches[0]), std::invalid_argument);
+    params.background_class = 0;
+    params.apply_sigmoid = true;
+    params.score_threshold = 0.f;
+    EXPECT_THROW(decodeDetections(output.data(), 1, 1, params, infos[0], ws, batches[0]), std::invalid_argument);
+}
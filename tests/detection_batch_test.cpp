@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <types/detection_batch.hpp>
+#include <utils/geometry_utils.hpp>
+
+class DetectionBatchTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Detection det1;
+        det1.bbox = cv::Rect2f(10.f, 20.f, 30.f, 40.f);
+        det1.confidence = 0.9f;
+        det1.class_id = 1;
+        det1.class_name = "person";
+        det1.frame_id = 3;
+        det1.track_id = 7;
+        det1.features = {1.f, 0.f, 0.f};
+        det1.mask = cv::Mat::zeros(4, 4, CV_32F);
+
+        Detection det2;
+        det2.bbox = cv::Rect2f(5.f, 5.f, 10.f, 10.f);
+        det2.confidence = 0.5f;
+        det2.class_id = 2;
+        det2.frame_id = 3;
+        det2.features = {0.f, 1.f, 0.f};
+
+        detections = {det1, det2};
+    }
+
+    std::vector<Detection> detections;
+};
+
+TEST_F(DetectionBatchTest, DefaultConstructor)
+{
+    DetectionBatch batch;
+    EXPECT_TRUE(batch.empty());
+    EXPECT_EQ(batch.size(), 0);
+    EXPECT_EQ(batch.feature_dim, 0);
+}
+
+TEST_F(DetectionBatchTest, RoundTrip)
+{
+    auto batch = DetectionBatch::fromDetections(detections);
+    ASSERT_EQ(batch.size(), 2);
+    EXPECT_EQ(batch.feature_dim, 3);
+    EXPECT_EQ(batch.features.size(), 6);
+    EXPECT_EQ(batch.masks.size(), 1);
+    EXPECT_EQ(batch.mask_ids[1], -1);
+
+    auto restored = batch.toDetections();
+    ASSERT_EQ(restored.size(), 2);
+    for (size_t i = 0; i < restored.size(); ++i)
+    {
+        EXPECT_EQ(restored[i].bbox, detections[i].bbox);
+        EXPECT_FLOAT_EQ(restored[i].confidence, detections[i].confidence);
+        EXPECT_EQ(restored[i].class_id, detections[i].class_id);
+        EXPECT_EQ(restored[i].frame_id, detections[i].frame_id);
+        EXPECT_EQ(restored[i].track_id, detections[i].track_id);
+        EXPECT_EQ(restored[i].features, detections[i].features);
+        EXPECT_EQ(restored[i].mask.empty(), detections[i].mask.empty());
+    }
+    EXPECT_EQ(restored[0].class_name, "person");
+    EXPECT_TRUE(restored[1].class_name.empty());
+}
+
+TEST_F(DetectionBatchTest, MissingFeaturesAreZeroFilled)
+{
+    Detection plain;
+    DetectionBatch batch;
+    batch.push_back(plain);
+    batch.push_back(detections[0]);
+
+    ASSERT_EQ(batch.feature_dim, 3);
+    EXPECT_FLOAT_EQ(batch.feature(0)[0], 0.f);
+    EXPECT_FLOAT_EQ(batch.feature(1)[0], 1.f);
+
+    Detection wrong_dim;
+    wrong_dim.features = {1.f, 2.f};
+    EXPECT_THROW(batch.push_back(wrong_dim), std::invalid_argument);
+}
+
+TEST_F(DetectionBatchTest, Append)
+{
+    auto batch = DetectionBatch::fromDetections(detections);
+    auto other = DetectionBatch::fromDetections(detections);
+    batch.append(other);
+
+    ASSERT_EQ(batch.size(), 4);
+    EXPECT_EQ(batch.features.size(), 12);
+    EXPECT_EQ(batch.mask_ids[2], 1);
+    EXPECT_EQ(batch.mask_ids[3], -1);
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    EXPECT_TRUE(batch.masks.empty());
+}
+
+TEST_F(DetectionBatchTest, EmplacePlainRow)
+{
+    auto batch = DetectionBatch::fromDetections(detections);
+    batch.emplace_back(cv::Rect2f(1.f, 2.f, 3.f, 4.f), 0.7f, 5, 3, cv::Size(640, 480));
+
+    ASSERT_EQ(batch.size(), 3);
+    EXPECT_EQ(batch.features.size(), 9);
+    EXPECT_EQ(batch.mask(2).empty(), true);
+
+    Detection det = batch[2];
+    EXPECT_EQ(det.bbox, cv::Rect2f(1.f, 2.f, 3.f, 4.f));
+    EXPECT_FLOAT_EQ(det.confidence, 0.7f);
+    EXPECT_EQ(det.class_id, 5);
+    EXPECT_EQ(det.frame_id, 3);
+    EXPECT_EQ(det.track_id, -1);
+    EXPECT_EQ(det.size, cv::Size(640, 480));
+    EXPECT_EQ(det.features, std::pmr::vector<float>(3, 0.f));
+}
+
+TEST_F(DetectionBatchTest, FeatureRowsWithGeometryUtils)
+{
+    auto batch = DetectionBatch::fromDetections(detections);
+    float sim = cosineSimilarity(batch.feature(0), batch.feature(1), batch.feature_dim);
+    EXPECT_FLOAT_EQ(sim, cosineSimilarity(detections[0].features, detections[1].features));
+    EXPECT_FLOAT_EQ(getIoU(batch.bboxes[0], batch.bboxes[1]), getIoU(detections[0].bbox, detections[1].bbox));
+}
@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <utils/detection_log_utils.hpp>
+
+class DetectionLogUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Frames 3, 1, 2 written out of order, frame 2 has masks, all rows have features
+        for (int64_t frame_id : {3, 1, 2})
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                Detection det;
+                det.frame_id = frame_id;
+                det.track_id = i;
+                det.class_id = i % 2;
+                det.confidence = 0.1f * static_cast<float>(i + 1);
+                det.bbox = cv::Rect2f(10.f * i, 5.f * frame_id, 20.f, 30.f);
+                det.position = cv::Point3f(1.f, 2.f, static_cast<float>(i));
+                det.size = cv::Size(640, 480);
+                det.features = {static_cast<float>(frame_id), static_cast<float>(i), 0.5f};
+                if (frame_id == 2 && i != 1)
+                    det.mask = cv::Mat(3, 2 + i, CV_8UC1, cv::Scalar(10 + i));
+                batch.push_back(det);
+            }
+        }
+        path = testing::TempDir() + "detection_log_test.bin";
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    DetectionBatch batch;
+    std::string path;
+};
+
+TEST_F(DetectionLogUtilsTest, RoundTrip)
+{
+    {
+        DetectionLogWriter writer(path);
+        writer.write(batch);
+    }
+
+    DetectionLogReader reader(path);
+    ASSERT_EQ(reader.size(), 3u);
+    EXPECT_EQ(reader.rows(), 12u);
+    EXPECT_EQ(reader[0].frame_id, 1);
+    EXPECT_EQ(reader[2].frame_id, 3);
+
+    const DetectionLogFrame &frame = reader[1];
+    ASSERT_EQ(frame.size, 4u);
+    ASSERT_EQ(frame.feature_dim, 3u);
+    EXPECT_EQ(frame.bboxes[2], cv::Rect2f(20.f, 10.f, 20.f, 30.f));
+    EXPECT_FLOAT_EQ(frame.confidences[3], 0.4f);
+    EXPECT_EQ(frame.class_ids[1], 1);
+    EXPECT_EQ(frame.track_ids[3], 3);
+    EXPECT_FLOAT_EQ(frame.positions[3].z, 3.f);
+    EXPECT_EQ(frame.sizes[0], cv::Size(640, 480));
+    EXPECT_FLOAT_EQ(frame.feature(2)[1], 2.f);
+
+    EXPECT_TRUE(frame.mask(1).empty());
+    cv::Mat mask = frame.mask(3);
+    EXPECT_EQ(mask.rows, 3);
+    EXPECT_EQ(mask.cols, 5);
+    EXPECT_EQ(mask.at<uchar>(2, 4), 13);
+    EXPECT_EQ(reader[0].mask_headers, nullptr);
+
+    // Column data is served straight from the mapping, 16-byte aligned
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.bboxes) % 16, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.features) % 16, 0u);
+}
+
+TEST_F(DetectionLogUtilsTest, FrameRange)
+{
+    {
+        DetectionLogWriter writer(path);
+        writer.write(batch);
+    }
+
+    DetectionLogReader reader(path);
+    EXPECT_EQ(reader.range(2, 3).size(), 2u);
+    EXPECT_EQ(reader.range(2, 3).begin()->frame_id, 2);
+    EXPECT_EQ(reader.range(0, 100).size(), 3u);
+    EXPECT_TRUE(reader.range(4, 10).empty());
+
+    DetectionBatch frame = reader.read(2, 2);
+    ASSERT_EQ(frame.size(), 4u);
+    EXPECT_EQ(frame.frame_ids, (std::pmr::vector<int64_t>{2, 2, 2, 2}));
+    EXPECT_EQ(frame.mask_ids, (std::pmr::vector<int>{0, -1, 1, 2}));
+    EXPECT_EQ(frame.masks[2].at<uchar>(0, 0), 13);
+    EXPECT_FLOAT_EQ(frame.feature(1)[1], 1.f);
+}
+
+TEST_F(DetectionLogUtilsTest, MotConversion)
+{
+    const std::string mot_path = testing::TempDir() + "detection_log_test.txt";
+    const std::string copy_path = testing::TempDir() + "detection_log_test_copy.txt";
+
+    std::ostringstream expected;
+    for (int64_t frame_id : {1, 2, 3})
+        for (size_t i = 0; i < batch.size(); ++i)
+            if (batch.frame_ids[i] == frame_id)
+                expected << batch[i] << "\n";
+    {
+        std::ofstream file(mot_path);
+        file << expected.str();
+    }
+
+    std::vector<MotParseError> errors;
+    EXPECT_EQ(convertMotToDetectionLog(mot_path, path, errors), 12u);
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(convertDetectionLogToMot(path, copy_path), 12u);
+
+    std::ifstream file(copy_path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(contents.str(), expected.str());
+
+    std::remove(mot_path.c_str());
+    std::remove(copy_path.c_str());
+}
+
+TEST_F(DetectionLogUtilsTest, RejectsInvalidFiles)
+{
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "1,1,0,0,10,10,1,0,0,0\n";
+    }
+    EXPECT_THROW(DetectionLogReader reader(path), std::runtime_error);
+
+    {
+        DetectionLogWriter writer(path);
+        writer.write(batch);
+    }
+    std::string contents;
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        contents = buffer.str();
+    }
+    {
+        // Truncated before the footer
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents.substr(0, contents.size() - 8);
+    }
+    EXPECT_THROW(DetectionLogReader reader(path), std::runtime_error);
+}
@@ -39,4 +39,15 @@ TEST(DetectionTest, StreamOperator)
     EXPECT_FLOAT_EQ(det.position.x, 1.0f);
     EXPECT_FLOAT_EQ(det.position.y, 2.0f);
     EXPECT_FLOAT_EQ(det.position.z, 3.0f);
+}
+
+TEST(DetectionTest, StreamOperatorMalformed)
+{
+    std::stringstream ss("1,2,10.0,20.0,30.0,40.0,0.9,1.0,2.0,3.0\n1,x,10.0\n");
+    Detection det;
+
+    EXPECT_TRUE(ss >> det);
+    EXPECT_FALSE(ss >> det);
+    EXPECT_EQ(det.frame_id, 1);
+    EXPECT_EQ(det.track_id, 2);
 }
\ No newline at end of file
@@ -110,4 +110,21 @@ TEST_F(DetectionUtilsTest, LetterboxScaleFillTest)
 
     EXPECT_EQ(output.size(), new_shape);
     EXPECT_EQ(output.type(), CV_8UC3);
-}
\ No newline at end of file
+}
+
+TEST_F(DetectionUtilsTest, LetterboxWithoutResizeTest)
+{
+    cv::Mat input(100, 200, CV_8UC3, cv::Scalar(1, 2, 3));
+    cv::Size new_shape(200, 200);
+    cv::Scalar color(114, 114, 114);
+
+    LetterboxInfo info;
+    cv::Mat output = letterbox(input, LetterboxParams{new_shape, color, false, false, true, 32}, &info);
+
+    // Input already at the target scale, only padded
+    EXPECT_EQ(output.size(), new_shape);
+    EXPECT_EQ(info.resized, input.size());
+    EXPECT_EQ(info.top, 50);
+    EXPECT_EQ(output.at<cv::Vec3b>(100, 100)[2], 3);
+    EXPECT_EQ(output.at<cv::Vec3b>(10, 100)[0], 114);
+}
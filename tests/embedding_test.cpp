@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <types/embedding.hpp>
+
+class EmbeddingTest : public testing::TestWithParam<simd::Level>
+{
+protected:
+    void SetUp() override
+    {
+        simd::setLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        simd::setLevel(simd::detectLevel());
+    }
+
+    template <size_t N>
+    static Embedding<N> make(float seed)
+    {
+        Embedding<N> embedding;
+        for (size_t i = 0; i < N; ++i)
+            embedding[i] = std::sin(seed * static_cast<float>(i + 1));
+        return embedding;
+    }
+
+    template <size_t N>
+    static void expectDotMatches()
+    {
+        auto a = make<N>(0.3f), b = make<N>(0.7f);
+        std::vector<float> va = a.toVector(), vb = b.toVector();
+        EXPECT_NEAR(a.dot(b), vector_ops::dot(va, vb), 1e-4f) << "N = " << N;
+        EXPECT_NEAR(cosineSimilarity(a, b), cosineSimilarity(va, vb), 1e-6f) << "N = " << N;
+    }
+};
+
+TEST_P(EmbeddingTest, DotMatchesDynamicApi)
+{
+    expectDotMatches<4>();
+    expectDotMatches<20>();
+    expectDotMatches<128>();
+    expectDotMatches<256>();
+    expectDotMatches<512>();
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, EmbeddingTest,
+                         testing::Values(simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512));
+
+TEST(EmbeddingTypeTest, Construction)
+{
+    EXPECT_EQ(Embedding<128>::size(), 128u);
+    EXPECT_EQ(alignof(Embedding<128>), 64u);
+    EXPECT_EQ(sizeof(Embedding<128>), 128 * sizeof(float));
+
+    std::vector<float> features(128, 0.5f);
+    Embedding<128> embedding(features);
+    EXPECT_EQ(embedding.toVector(), features);
+    EXPECT_EQ(Embedding<128>(features.data()), embedding);
+
+    EXPECT_THROW(Embedding<128>(std::vector<float>(64)), std::invalid_argument);
+}
+
+TEST(EmbeddingTypeTest, NormalizeAndCompose)
+{
+    Embedding<4> a(std::vector<float>{3.f, 0.f, 4.f, 0.f});
+    Embedding<4> b(std::vector<float>{0.f, 1.f, 0.f, 0.f});
+
+    auto unit = vector_ops::normalize(a);
+    EXPECT_FLOAT_EQ(unit.norm(), 1.f);
+    EXPECT_FLOAT_EQ(unit[0], 0.6f);
+    EXPECT_EQ(unit.toVector(), vector_ops::normalize(a.toVector()));
+
+    auto mixed = vector_ops::compose(a, b, 0.25f);
+    EXPECT_EQ(mixed.toVector(), vector_ops::compose(a.toVector(), b.toVector(), 0.25f));
+
+    Embedding<4> zero;
+    zero.normalize();
+    EXPECT_EQ(zero, Embedding<4>());
+    EXPECT_FLOAT_EQ(cosineSimilarity(zero, a), 0.f);
+    EXPECT_FLOAT_EQ(cosineSimilarity(a, a), 1.f);
+    EXPECT_FLOAT_EQ(cosineSimilarity(a, b), 0.5f);
+}
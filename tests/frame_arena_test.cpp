@@ -0,0 +1,242 @@
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <types/frame.hpp>
+#include <types/embedding.hpp>
+#include <types/detection_batch.hpp>
+#include <utils/ann_utils.hpp>
+#include <utils/nms_utils.hpp>
+#include <utils/vector_utils.hpp>
+#include <utils/spatial_utils.hpp>
+#include <utils/quantize_utils.hpp>
+
+// Every global operator new in this test executable goes through these, so a test can count the
+// heap allocations made by a block of code. All forms are replaced so that each new is paired
+// with a matching delete, also under sanitizers; the test is built as its own executable.
+namespace
+{
+    std::atomic<size_t> heap_allocations{0};
+
+    void *countedAlloc(std::size_t size, std::size_t alignment = 0) noexcept
+    {
+        heap_allocations.fetch_add(1, std::memory_order_relaxed);
+        size = std::max(size, size_t(1));
+        if (alignment == 0)
+            return std::malloc(size);
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void *countedAllocOrThrow(std::size_t size, std::size_t alignment = 0)
+    {
+        if (void *p = countedAlloc(size, alignment))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(std::size_t size) { return countedAllocOrThrow(size); }
+void *operator new[](std::size_t size) { return countedAllocOrThrow(size); }
+void *operator new(std::size_t size, std::align_val_t align) { return countedAllocOrThrow(size, static_cast<size_t>(align)); }
+void *operator new[](std::size_t size, std::align_val_t align) { return countedAllocOrThrow(size, static_cast<size_t>(align)); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<size_t>(align)); }
+void *operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept { return countedAlloc(size, static_cast<size_t>(align)); }
+
+// GCC flags free() on memory from operator new once these are inlined, here they are a matching pair
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+class FrameArenaTest : public ::testing::Test
+{
+protected:
+    // One frame of per-frame work: a batch, materialized detections with features and labels,
+    // NMS with a reused workspace and vector_ops temporaries, all allocated from resource
+    void processFrame(std::pmr::memory_resource *resource)
+    {
+        DetectionBatch batch(resource);
+        for (int i = 0; i < 64; ++i)
+        {
+            Detection det(resource);
+            det.class_id = i % 3;
+            det.class_name = i % 3 ? "car" : "person";
+            det.confidence = 0.5f + static_cast<float>(i % 7) * 0.05f;
+            det.bbox = cv::Rect2f(static_cast<float>(i % 8) * 20.f, static_cast<float>(i / 8) * 20.f, 30.f, 30.f);
+            det.features.assign(128, static_cast<float>(i));
+            batch.push_back(det);
+        }
+
+        nms(batch, NmsParams(), nms_ws, keep, keep_scores);
+
+        std::pmr::vector<Detection> detections(resource);
+        batch.toDetections(detections);
+        for (auto &det : detections)
+        {
+            for (int label = 0; label < 6; ++label)
+                det.labels[label] = "attribute";
+            auto probabilities = vector_ops::softmax(det.features);
+            det.confidence = probabilities[0];
+        }
+    }
+
+    NmsWorkspace nms_ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+};
+
+TEST_F(FrameArenaTest, SteadyStateWithoutHeapAllocations)
+{
+    const cv::Mat image(48, 64, CV_8UC3);
+    FrameArenaPool pool(4096);
+    std::array<Frame, 2> in_flight; // frames retire two frames later, as in a pipeline
+
+    size_t allocations = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        // Arenas grow over the first frames, then buffers and workspaces are only reused
+        if (i == 10)
+            allocations = heap_allocations.load();
+
+        Frame frame(image);
+        frame.arena = pool.acquire();
+        processFrame(frame.resource());
+        in_flight[i % in_flight.size()] = std::move(frame);
+    }
+    allocations = heap_allocations.load() - allocations;
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(pool.size(), 3u);
+
+    // The same work on the default resource allocates on every frame
+    allocations = heap_allocations.load();
+    processFrame(std::pmr::get_default_resource());
+    EXPECT_GT(heap_allocations.load() - allocations, 64u);
+}
+
+TEST(FrameArenaPoolTest, RecyclesRetiredArenas)
+{
+    FrameArenaPool pool;
+    Frame first;
+    first.arena = pool.acquire();
+    const FrameArena *arena = first.arena.get();
+    EXPECT_EQ(first.resource(), first.arena->resource());
+    EXPECT_EQ(Frame().resource(), std::pmr::get_default_resource());
+
+    // Still referenced by a copy of the frame
+    Frame copy = first;
+    first = Frame();
+    std::shared_ptr<FrameArena> other = pool.acquire();
+    EXPECT_NE(other.get(), arena);
+
+    copy = Frame();
+    EXPECT_EQ(pool.acquire().get(), arena);
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.bytes(), 2u * 64u * 1024u);
+}
+
+TEST_F(FrameArenaTest, GrowsBySpill)
+{
+    FrameArena arena(4096);
+    EXPECT_EQ(arena.capacity(), 4096u);
+
+    {
+        std::pmr::vector<float> values(10000, 1.f, arena.allocator());
+        EXPECT_GT(arena.overflow(), 0u);
+    }
+    arena.reset();
+    EXPECT_EQ(arena.overflow(), 0u);
+    EXPECT_GE(arena.capacity(), 4096u + 10000u * sizeof(float));
+
+    std::pmr::vector<float> again(10000, 1.f, arena.allocator());
+    EXPECT_EQ(arena.overflow(), 0u);
+}
+
+TEST_F(FrameArenaTest, AllocatorPropagation)
+{
+    FrameArena arena;
+    std::pmr::vector<Detection> detections(arena.resource());
+    detections.emplace_back();
+    detections[0].features = {1.f, 2.f};
+    detections[0].labels = {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}, {5, "e"}};
+    EXPECT_EQ(detections[0].get_allocator().resource(), arena.resource());
+    EXPECT_EQ(detections[0].labels.get_allocator().resource(), arena.resource());
+
+    // Copies into ordinary containers leave the arena
+    std::vector<Detection> copies(detections.begin(), detections.end());
+    EXPECT_EQ(copies[0].get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copies[0].labels, detections[0].labels);
+
+    DetectionBatch batch = DetectionBatch::fromDetections(copies, arena.allocator());
+    EXPECT_EQ(batch.features.get_allocator().resource(), arena.resource());
+    DetectionBatch copy = batch;
+    EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+
+    // Moved-from label sets are empty, whether they were inline or spilled
+    LabelSet moved = std::move(detections[0].labels);
+    EXPECT_EQ(moved.size(), 5u);
+    EXPECT_TRUE(detections[0].labels.empty());
+}
+
+TEST_F(FrameArenaTest, ArenaBackedInputsToVectorApis)
+{
+    FrameArena arena;
+    std::pmr::vector<Detection> detections(arena.resource());
+    for (int i = 0; i < 4; ++i)
+    {
+        Detection &det = detections.emplace_back();
+        det.class_id = 0;
+        det.confidence = 0.9f - 0.1f * static_cast<float>(i);
+        det.bbox = cv::Rect2f(static_cast<float>(i / 2) * 100.f + static_cast<float>(i % 2), 0.f, 50.f, 50.f);
+        det.features.assign(4, 0.f);
+        det.features[i] = 1.f;
+    }
+    const DetectionBatch batch = DetectionBatch::fromDetections(detections, arena.allocator());
+    const std::vector<float> plain = {0.f, 0.f, 1.f, 0.f};
+
+    // Features
+    EXPECT_EQ(quantizeHalf(detections[2].features).values, quantizeHalf(plain).values);
+    EXPECT_EQ(quantizeInt8(detections[2].features).values, quantizeInt8(plain).values);
+    EXPECT_EQ(Embedding<4>(detections[2].features).toVector(), plain);
+
+    HnswIndex index(4);
+    for (const auto &det : detections)
+        index.insert(static_cast<int64_t>(index.size()), det.features);
+    auto results = index.search(detections[2].features, 1);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].track_id, 2);
+
+    // Batch columns: rows 0/1 and 2/3 overlap
+    EXPECT_EQ(nms(batch.bboxes, batch.confidences, batch.class_ids), (std::vector<int>{0, 2}));
+
+    std::vector<float> iou(batch.size() * batch.size());
+    getIoUMatrix(batch.bboxes, batch.bboxes, iou.data());
+    EXPECT_FLOAT_EQ(iou[0], 1.f);
+    EXPECT_FLOAT_EQ(iou[2], 0.f);
+
+    std::vector<BoxOverlap> overlaps;
+    findOverlaps(batch.bboxes, 0.5f, overlaps);
+    EXPECT_EQ(overlaps.size(), 2u);
+    findOverlaps(batch.bboxes, batch.bboxes, 0.5f, overlaps);
+    EXPECT_EQ(overlaps.size(), 8u);
+    EXPECT_EQ(BoxGrid(batch.bboxes).size(), 4u);
+}
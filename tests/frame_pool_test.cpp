@@ -0,0 +1,163 @@
+#include <thread>
+#include <gtest/gtest.h>
+#include <types/frame_pool.hpp>
+
+// Synthetic source: frame i is an 8x8 image filled with i
+class CounterCapture : public cv::VideoCapture
+{
+public:
+    explicit CounterCapture(int num_frames) : num_frames_(num_frames) {}
+
+    bool grab() override { return index_ < num_frames_; }
+
+    bool retrieve(cv::OutputArray image, int = 0) override
+    {
+        image.create(8, 8, CV_8UC1);
+        image.setTo(cv::Scalar(index_++));
+        return true;
+    }
+
+private:
+    int num_frames_;
+    int index_{0};
+};
+
+TEST(FramePoolTest, RecyclesReleasedBuffers)
+{
+    FramePool pool;
+    const uchar *data;
+    {
+        cv::Mat image = pool.acquire(cv::Size(64, 48), CV_8UC3);
+        data = image.data;
+        EXPECT_EQ(pool.stats().misses, 1u);
+        EXPECT_EQ(pool.stats().in_use, 1u);
+        EXPECT_EQ(pool.stats().bytes, 64u * 48u * 3u);
+    }
+    EXPECT_EQ(pool.stats().in_use, 0u);
+    EXPECT_EQ(pool.stats().free, 1u);
+
+    cv::Mat image = pool.acquire(cv::Size(64, 48), CV_8UC3);
+    EXPECT_EQ(image.data, data);
+    EXPECT_EQ(pool.stats().hits, 1u);
+    EXPECT_EQ(pool.stats().free, 0u);
+
+    // A different size cannot reuse the buffer
+    cv::Mat other = pool.acquire(cv::Size(32, 32), CV_8UC1);
+    EXPECT_EQ(pool.stats().misses, 2u);
+    EXPECT_EQ(pool.stats().in_use, 2u);
+}
+
+TEST(FramePoolTest, LastFrameCopyReturnsBuffer)
+{
+    FramePool pool;
+    Frame first(pool.acquire(cv::Size(16, 16), CV_8UC3));
+    {
+        Frame copy = first;
+        first = Frame();
+        EXPECT_EQ(pool.stats().in_use, 1u);
+    }
+    EXPECT_EQ(pool.stats().in_use, 0u);
+    EXPECT_EQ(pool.stats().free, 1u);
+}
+
+TEST(FramePoolTest, ReserveAndEviction)
+{
+    FramePool pool(2);
+    pool.reserve(cv::Size(8, 8), CV_8UC3, 2);
+    EXPECT_EQ(pool.stats().free, 2u);
+    EXPECT_EQ(pool.stats().bytes, 2u * 8u * 8u * 3u);
+
+    {
+        cv::Mat a = pool.acquire(cv::Size(8, 8), CV_8UC3);
+        cv::Mat b = pool.acquire(cv::Size(8, 8), CV_8UC3);
+        cv::Mat c = pool.acquire(cv::Size(8, 8), CV_8UC3);
+        EXPECT_EQ(pool.stats().hits, 2u);
+        EXPECT_EQ(pool.stats().misses, 1u);
+    }
+    // Only max_free idle buffers are kept
+    EXPECT_EQ(pool.stats().free, 2u);
+    EXPECT_EQ(pool.stats().bytes, 2u * 8u * 8u * 3u);
+
+    pool.clear();
+    EXPECT_EQ(pool.stats().free, 0u);
+    EXPECT_EQ(pool.stats().bytes, 0u);
+}
+
+TEST(FramePoolTest, ImagesOutlivePoolAndThreads)
+{
+    cv::Mat image;
+    {
+        FramePool pool;
+        image = pool.acquire(cv::Size(4, 4), CV_8UC1);
+        image = cv::Scalar(7);
+
+        std::vector<cv::Mat> images(4);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < images.size(); ++t)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                                     for (int i = 0; i < 100; ++i)
+                                         images[t] = pool.acquire(cv::Size(4, 4), CV_8UC1); });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        EXPECT_EQ(pool.stats().in_use, 5u);
+        EXPECT_EQ(pool.stats().hits + pool.stats().misses, 401u);
+    }
+    EXPECT_EQ(image.at<uchar>(3, 3), 7);
+}
+
+TEST(FramePoolTest, ReadDecodesIntoPool)
+{
+    FramePool pool;
+    CounterCapture cap(3);
+    FrameStream stream;
+    Frame frame;
+
+    ASSERT_TRUE(pool.read(cap, frame, stream));
+    EXPECT_EQ(frame.image.at<uchar>(0, 0), 0);
+    EXPECT_EQ(pool.stats().misses, 1u);
+    EXPECT_EQ(pool.stats().in_use, 1u);
+
+    // The previous frame's buffer returns to the pool and is reused
+    const uchar *data = frame.image.data;
+    frame = Frame();
+    ASSERT_TRUE(pool.read(cap, frame));
+    EXPECT_EQ(frame.image.at<uchar>(0, 0), 1);
+    EXPECT_EQ(frame.image.data, data);
+    EXPECT_EQ(pool.stats().hits, 1u);
+
+    // A frame still in use is never overwritten
+    cv::Mat image;
+    ASSERT_TRUE(pool.retrieve(cap, image));
+    EXPECT_NE(image.data, frame.image.data);
+    EXPECT_EQ(frame.image.at<uchar>(0, 0), 1);
+    EXPECT_EQ(image.at<uchar>(0, 0), 2);
+
+    EXPECT_FALSE(pool.read(cap, frame));
+    EXPECT_EQ(pool.stats().in_use, 2u);
+}
+
+TEST(FramePoolTest, ReuseImagesAfterPoolIsGone)
+{
+    cv::Mat image;
+    Frame frame;
+    {
+        FramePool pool;
+        image = pool.acquire(cv::Size(4, 4), CV_8UC1);
+        CounterCapture cap(1);
+        ASSERT_TRUE(pool.read(cap, frame));
+    }
+
+    // Neither keeps a pointer to the destroyed allocator, so create() uses the default one
+    EXPECT_EQ(image.allocator, nullptr);
+    EXPECT_EQ(frame.image.allocator, nullptr);
+    image.release();
+    image.create(8, 8, CV_8UC3);
+    frame.image.release();
+    CounterCapture cap(1);
+    ASSERT_TRUE(cap.read(frame.image));
+    EXPECT_EQ(frame.image.at<uchar>(7, 7), 0);
+}
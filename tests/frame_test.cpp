@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <thread>
 #include <gtest/gtest.h>
 #include <types/frame.hpp>
 #include <types/detection.hpp>
@@ -156,4 +158,59 @@ TEST_F(FrameTest, ROIOperatorRelative)
     cv::Mat safe_roi = frame(oversized_rel_roi);
     EXPECT_GT(safe_roi.cols, 0);
     EXPECT_GT(safe_roi.rows, 0);
-}
\ No newline at end of file
+}
+
+TEST_F(FrameTest, FrameStreamTest)
+{
+    FrameStream camera1(1), camera2(2);
+
+    Frame a(test_image, camera1);
+    Frame b(test_image, camera2);
+    Frame c(test_image, camera1);
+
+    EXPECT_EQ(a.getStreamId(), 1);
+    EXPECT_EQ(b.getStreamId(), 2);
+    EXPECT_EQ(a.getId(), 0);
+    EXPECT_EQ(b.getId(), 0);
+    EXPECT_EQ(c.getId(), 1);
+    EXPECT_LE(a.getCaptureTime(), c.getCaptureTime());
+
+    // Frames without a stream stay on the default stream
+    EXPECT_EQ(Frame(test_image).getStreamId(), 0);
+
+    // Automatic stream ids are unique and never the default stream
+    FrameStream auto1, auto2;
+    EXPECT_GT(auto1.id(), 0);
+    EXPECT_NE(auto1.id(), auto2.id());
+
+    camera1.reset(100);
+    EXPECT_EQ(Frame(test_image, camera1).getId(), 100);
+}
+
+TEST_F(FrameTest, ConcurrentFrameIdsTest)
+{
+    FrameStream stream(7);
+    const size_t num_threads = 4, frames_per_thread = 1000;
+
+    std::vector<std::vector<int64_t>> ids(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+                                 for (size_t i = 0; i < frames_per_thread; ++i)
+                                 {
+                                     ids[t].push_back(Frame(test_image, stream).getId());
+                                     Frame unnumbered;
+                                 } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    std::vector<int64_t> all;
+    for (const auto &thread_ids : ids)
+        all.insert(all.end(), thread_ids.begin(), thread_ids.end());
+    std::sort(all.begin(), all.end());
+    for (size_t i = 0; i < all.size(); ++i)
+        EXPECT_EQ(all[i], static_cast<int64_t>(i));
+}
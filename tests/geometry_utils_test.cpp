@@ -61,4 +61,120 @@ TEST_F(GeometryUtilsTest, CosineSimilarityZeroVector)
 {
     float sim = cosineSimilarity(vec1, vec4);
     EXPECT_FLOAT_EQ(sim, 0.0f);
-}
\ No newline at end of file
+}
+
+TEST_F(GeometryUtilsTest, IoUVariantsKnownValues)
+{
+    // Enclosing box is 3x3, union is 7, centers are sqrt(2) apart, same aspect ratio
+    EXPECT_NEAR(getIoU(rect1, rect2, IoUType::GIoU), 1.f / 7.f - 2.f / 9.f, EPSILON);
+    EXPECT_NEAR(getIoU(rect1, rect2, IoUType::DIoU), 1.f / 7.f - 2.f / 18.f, EPSILON);
+    EXPECT_NEAR(getIoU(rect1, rect2, IoUType::CIoU), 1.f / 7.f - 2.f / 18.f, EPSILON);
+    EXPECT_FLOAT_EQ(getIoU(rect1, rect1, IoUType::CIoU), 1.0f);
+    EXPECT_LT(getIoU(rect1, rect3, IoUType::GIoU), 0.0f);
+    EXPECT_FLOAT_EQ(getIoU(rect1, rect2, IoUType::IoU), getIoU(rect1, rect2));
+}
+
+TEST_F(GeometryUtilsTest, IoUMatrixMatchesScalar)
+{
+    cv::RNG rng(42);
+    std::vector<cv::Rect2f> boxes1, boxes2;
+    for (int i = 0; i < 37; ++i)
+    {
+        boxes1.emplace_back(rng.uniform(0.f, 100.f), rng.uniform(0.f, 100.f), rng.uniform(0.f, 50.f), rng.uniform(0.f, 50.f));
+    }
+    for (int i = 0; i < 29; ++i)
+    {
+        boxes2.emplace_back(rng.uniform(0.f, 100.f), rng.uniform(0.f, 100.f), rng.uniform(0.f, 50.f), rng.uniform(0.f, 50.f));
+    }
+    boxes2.push_back(rect4);
+
+    const simd::Level supported = simd::level();
+    std::vector<float> matrix(boxes1.size() * boxes2.size());
+    for (auto type : {IoUType::IoU, IoUType::GIoU, IoUType::DIoU, IoUType::CIoU})
+    {
+        for (auto level : {simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2})
+        {
+            simd::setLevel(level);
+            getIoUMatrix(boxes1, boxes2, matrix.data(), type);
+            for (size_t i = 0; i < boxes1.size(); ++i)
+            {
+                for (size_t j = 0; j < boxes2.size(); ++j)
+                {
+                    EXPECT_NEAR(matrix[i * boxes2.size() + j], getIoU(boxes1[i], boxes2[j], type), EPSILON);
+                }
+            }
+        }
+    }
+    simd::setLevel(supported);
+}
+
+TEST_F(GeometryUtilsTest, IoURowRange)
+{
+    BoxArray boxes;
+    boxes.assign({rect1, rect2, rect3, rect4});
+
+    float row[2];
+    getIoURow(rect1, boxes, 1, 3, row);
+    EXPECT_NEAR(row[0], 0.14285714f, EPSILON);
+    EXPECT_FLOAT_EQ(row[1], 0.0f);
+}
+
+TEST_F(GeometryUtilsTest, IoURowCIoURequiresAspect)
+{
+    std::vector<cv::Rect2f> rects;
+    for (int i = 0; i < 16; ++i)
+        rects.push_back(i % 2 ? rect2 : rect3);
+
+    const simd::Level supported = simd::level();
+    float row[16];
+    for (auto level : {simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2})
+    {
+        simd::setLevel(level);
+        BoxArray boxes;
+        boxes.assign(rects);
+        EXPECT_THROW(getIoURow(rect1, boxes, 0, rects.size(), row, IoUType::CIoU), std::invalid_argument);
+        EXPECT_NO_THROW(getIoURow(rect1, boxes, 0, rects.size(), row, IoUType::DIoU));
+
+        boxes.assign(rects, true);
+        getIoURow(rect1, boxes, 0, rects.size(), row, IoUType::CIoU);
+        for (size_t j = 0; j < rects.size(); ++j)
+            EXPECT_NEAR(row[j], getIoU(rect1, rects[j], IoUType::CIoU), EPSILON);
+    }
+    simd::setLevel(supported);
+}
+
+TEST_F(GeometryUtilsTest, CosineSimilarityMatrixMatchesScalar)
+{
+    const size_t dim = 67, num_gallery = 11, num_query = 7;
+    cv::RNG rng(3);
+    std::vector<float> gallery(num_gallery * dim), query(num_query * dim);
+    for (auto &v : gallery)
+        v = rng.uniform(-1.f, 1.f);
+    for (auto &v : query)
+        v = rng.uniform(-1.f, 1.f);
+    std::fill(query.begin() + 2 * dim, query.begin() + 3 * dim, 0.f); // zero query row
+
+    std::vector<float> expected(num_gallery * num_query);
+    for (size_t i = 0; i < num_gallery; ++i)
+        for (size_t j = 0; j < num_query; ++j)
+            expected[i * num_query + j] = cosineSimilarity(gallery.data() + i * dim, query.data() + j * dim, dim);
+
+    normalizeRows(gallery.data(), num_gallery, dim);
+    normalizeRows(query.data(), num_query, dim);
+
+    const simd::Level supported = simd::level();
+    std::vector<float> matrix(num_gallery * num_query);
+    for (auto level : {simd::Level::Scalar, simd::Level::AVX2})
+    {
+        simd::setLevel(level);
+        for (size_t threads : {1, 3})
+        {
+            std::fill(matrix.begin(), matrix.end(), -1.f);
+            cosineSimilarityMatrix(gallery.data(), num_gallery, query.data(), num_query, dim, matrix.data(), threads);
+            for (size_t k = 0; k < matrix.size(); ++k)
+                EXPECT_NEAR(matrix[k], expected[k], 1e-5f);
+        }
+    }
+    simd::setLevel(supported);
+    EXPECT_FLOAT_EQ(matrix[2], 0.f);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <utils/json_utils.hpp>
+
+TEST(JsonUtilsTest, ClassRegistryFormats)
+{
+    ClassRegistry list = classRegistryFromJson(nlohmann::json::parse(R"(["person", "bicycle"])"));
+    EXPECT_EQ(list.size(), 2u);
+    EXPECT_EQ(list.name(1), "bicycle");
+
+    ClassRegistry sparse = classRegistryFromJson(nlohmann::json::parse(R"({"names": {"0": "person", "7": "train"}})"));
+    EXPECT_EQ(sparse.size(), 8u);
+    EXPECT_EQ(sparse.name(7), "train");
+    EXPECT_TRUE(sparse.name(3).empty());
+
+    EXPECT_THROW(classRegistryFromJson(nlohmann::json::parse(R"({"a": "person"})")), std::invalid_argument);
+    EXPECT_THROW(classRegistryFromJson(nlohmann::json::parse("3")), std::invalid_argument);
+}
+
+TEST(JsonUtilsTest, LoadClassRegistry)
+{
+    const std::string path = ::testing::TempDir() + "json_utils_test_labels.json";
+    {
+        std::ofstream file(path);
+        file << R"({"names": ["person", "bicycle", "car"]})";
+    }
+    ClassRegistry registry = loadClassRegistry(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(registry.size(), 3u);
+    EXPECT_EQ(registry.id("car"), 2);
+    EXPECT_THROW(loadClassRegistry(path), std::runtime_error);
+}
+
+TEST(JsonUtilsTest, DetectionToJson)
+{
+    ClassRegistry registry({"person", "bicycle", "car"});
+    Detection det;
+    det.class_id = 2;
+    det.confidence = 0.5f;
+    det.bbox = cv::Rect2f(1.f, 2.f, 3.f, 4.f);
+    det.frame_id = 7;
+    det.labels = {{0, ClassName()}, {1, "cyclist"}};
+
+    nlohmann::json data = toJson(det, registry);
+    EXPECT_EQ(data["class_id"], 2);
+    EXPECT_EQ(data["class_name"], "car");
+    EXPECT_FLOAT_EQ(data["confidence"].get<float>(), 0.5f);
+    EXPECT_EQ(data["bbox"], nlohmann::json({1.f, 2.f, 3.f, 4.f}));
+    EXPECT_EQ(data["frame_id"], 7);
+    EXPECT_EQ(data["track_id"], -1);
+    EXPECT_EQ(data["labels"]["0"], "person");
+    EXPECT_EQ(data["labels"]["1"], "cyclist");
+
+    det.class_name = "vehicle";
+    det.labels.clear();
+    nlohmann::json list = toJson(std::vector<Detection>{det, det}, registry);
+    ASSERT_EQ(list.size(), 2u);
+    EXPECT_EQ(list[1]["class_name"], "vehicle");
+    EXPECT_FALSE(list[1].contains("labels"));
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <utils/mask_utils.hpp>
+
+class MaskUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        box_mask = cv::Mat(12, 10, CV_32F);
+        for (int y = 0; y < box_mask.rows; ++y)
+            for (int x = 0; x < box_mask.cols; ++x)
+                box_mask.at<float>(y, x) = static_cast<float>((x * 7 + y * 3) % 10) / 10.f + 0.05f;
+    }
+
+    // Reference: full-size dense mask of the box pasted into the image
+    static cv::Mat denseMask(const cv::Mat &box_mask, const cv::Rect &box, cv::Size image_size)
+    {
+        cv::Mat resized = getAbsoluteMask(box_mask, box.size());
+        cv::Mat dense = cv::Mat::zeros(image_size, CV_8U);
+        for (int y = 0; y < box.height; ++y)
+            for (int x = 0; x < box.width; ++x)
+                if (cv::Rect(cv::Point(), image_size).contains(cv::Point(box.x + x, box.y + y)))
+                    dense.at<uchar>(box.y + y, box.x + x) = resized.at<uchar>(y, x);
+        return dense;
+    }
+
+    static size_t count(const cv::Mat &dense)
+    {
+        size_t result = 0;
+        for (int y = 0; y < dense.rows; ++y)
+            for (int x = 0; x < dense.cols; ++x)
+                result += dense.at<uchar>(y, x);
+        return result;
+    }
+
+    cv::Size image_size{200, 100};
+    cv::Mat box_mask;
+};
+
+TEST_F(MaskUtilsTest, PackMatchesDenseMask)
+{
+    // Inside, straddling a word boundary, and clipped by the image border
+    for (cv::Rect box : {cv::Rect(30, 20, 57, 43), cv::Rect(60, 5, 10, 10), cv::Rect(170, 80, 50, 40)})
+    {
+        BitMask mask = packMask(box_mask, box, image_size);
+        cv::Mat expected = denseMask(box_mask, box, image_size);
+        EXPECT_EQ(mask.roi, box & cv::Rect(cv::Point(), image_size));
+        EXPECT_EQ(mask.area(), count(expected));
+
+        cv::Mat dense = mask.toMat();
+        for (int y = 0; y < image_size.height; ++y)
+            for (int x = 0; x < image_size.width; ++x)
+                ASSERT_EQ(dense.at<uchar>(y, x), expected.at<uchar>(y, x)) << "box " << box << " at " << x << "," << y;
+    }
+
+    BitMask outside = packMask(box_mask, cv::Rect(300, 10, 20, 20), image_size);
+    EXPECT_TRUE(outside.empty());
+    EXPECT_EQ(outside.area(), 0u);
+}
+
+TEST_F(MaskUtilsTest, IoUByPopcount)
+{
+    const cv::Rect box1(30, 20, 57, 43), box2(50, 30, 90, 50);
+    BitMask mask1 = packMask(box_mask, box1, image_size);
+    BitMask mask2 = packMask(box_mask, box2, image_size);
+
+    cv::Mat dense1 = denseMask(box_mask, box1, image_size), dense2 = denseMask(box_mask, box2, image_size);
+    size_t intersection = 0, union_area = 0;
+    for (int y = 0; y < image_size.height; ++y)
+    {
+        for (int x = 0; x < image_size.width; ++x)
+        {
+            intersection += dense1.at<uchar>(y, x) & dense2.at<uchar>(y, x);
+            union_area += dense1.at<uchar>(y, x) | dense2.at<uchar>(y, x);
+        }
+    }
+    ASSERT_GT(intersection, 0u);
+    EXPECT_FLOAT_EQ(maskIoU(mask1, mask2), static_cast<float>(intersection) / static_cast<float>(union_area));
+    EXPECT_FLOAT_EQ(maskIoU(mask1, mask1), 1.f);
+
+    std::vector<BitMask> masks = {mask1, mask2, packMask(box_mask, cv::Rect(150, 0, 20, 10), image_size)};
+    std::vector<float> matrix(9);
+    maskIoUMatrix(masks, masks, matrix.data());
+    EXPECT_FLOAT_EQ(matrix[1], matrix[3]);
+    EXPECT_FLOAT_EQ(matrix[2], 0.f);
+    EXPECT_FLOAT_EQ(matrix[8], 1.f);
+
+    EXPECT_THROW(maskIoU(mask1, BitMask(cv::Size(10, 10), cv::Rect(0, 0, 5, 5))), std::invalid_argument);
+}
+
+TEST_F(MaskUtilsTest, RleRoundTrip)
+{
+    // Column 1 of a 3x3 image
+    BitMask column(cv::Size(3, 3), cv::Rect(1, 0, 1, 3));
+    for (int y = 0; y < 3; ++y)
+        column.set(1, y);
+    RleMask rle = encodeRle(column);
+    EXPECT_EQ(rle.counts, (std::vector<uint32_t>{3, 3, 3}));
+    EXPECT_EQ(rleToString(rle), "333");
+    EXPECT_EQ(rle.area(), 3u);
+
+    // Negative differences use the sign bit of the last character
+    EXPECT_EQ(rleToString(RleMask{cv::Size(6, 3), {5, 10, 2, 1}}), "5:2G");
+    EXPECT_EQ(rleFromString("5:2G", cv::Size(6, 3)).counts, (std::vector<uint32_t>{5, 10, 2, 1}));
+
+    BitMask mask = packMask(box_mask, cv::Rect(30, 20, 57, 43), image_size);
+    rle = encodeRle(mask);
+    EXPECT_EQ(rle.area(), mask.area());
+    RleMask parsed = rleFromString(rleToString(rle), image_size);
+    EXPECT_EQ(parsed.counts, rle.counts);
+
+    BitMask decoded = decodeRle(parsed);
+    EXPECT_EQ(decoded.area(), mask.area());
+    EXPECT_FLOAT_EQ(maskIoU(decoded, mask), 1.f);
+
+    EXPECT_TRUE(decodeRle(encodeRle(BitMask(image_size, cv::Rect()))).empty());
+    EXPECT_THROW(decodeRle(RleMask{image_size, {5, 5}}), std::invalid_argument);
+    EXPECT_THROW(rleFromString("3 3", image_size), std::invalid_argument);
+    EXPECT_THROW(rleFromString(std::string(12, 'o') + "O", image_size), std::invalid_argument);
+    EXPECT_THROW(rleFromString(std::string(7, 'o') + "0", image_size), std::invalid_argument);
+}
+
+TEST_F(MaskUtilsTest, DecodeFromPrototypes)
+{
+    // Two 16x16 prototypes over a 64x64 model input with no letterbox padding,
+    // so decoding equals a bilinear resize of the probability map
+    const cv::Size proto_size(16, 16);
+    std::vector<float> protos(2 * 16 * 16);
+    for (int y = 0; y < 16; ++y)
+    {
+        for (int x = 0; x < 16; ++x)
+        {
+            protos[y * 16 + x] = static_cast<float>(x - y) * 0.7f + 0.31f;
+            protos[256 + y * 16 + x] = static_cast<float>((x * y) % 5) - 2.13f;
+        }
+    }
+    const std::vector<float> coefficients = {1.f, 0.5f, -0.5f, 1.f};
+    const std::vector<cv::Rect2f> boxes = {cv::Rect2f(8.f, 4.f, 40.5f, 30.f), cv::Rect2f(0.f, 40.f, 64.f, 30.f)};
+
+    LetterboxParams letterbox_params;
+    letterbox_params.new_shape = cv::Size(64, 64);
+    const LetterboxInfo info = getLetterboxInfo(cv::Size(64, 64), letterbox_params);
+
+    MaskWorkspace ws;
+    std::vector<BitMask> masks;
+    decodeMasks(protos.data(), 2, proto_size, coefficients.data(), boxes.data(), boxes.size(), info, ws, masks);
+    ASSERT_EQ(masks.size(), 2u);
+    EXPECT_EQ(masks[0].roi, cv::Rect(8, 4, 41, 30));
+    EXPECT_EQ(masks[1].roi, cv::Rect(0, 40, 64, 24));
+
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        cv::Mat probabilities(proto_size, CV_32F);
+        for (int p = 0; p < 256; ++p)
+        {
+            const float logit = coefficients[2 * i] * protos[p] + coefficients[2 * i + 1] * protos[256 + p];
+            probabilities.at<float>(p / 16, p % 16) = 1.f / (1.f + std::exp(-logit));
+        }
+        cv::Mat expected = getAbsoluteMask(probabilities, info.source);
+
+        // Interpolation order differs from the reference, so allow values right at the threshold to flip
+        size_t mismatches = 0, checked = 0;
+        for (int y = 0; y < 64; ++y)
+        {
+            for (int x = 0; x < 64; ++x)
+            {
+                const bool inside = masks[i].roi.contains(cv::Point(x, y));
+                mismatches += masks[i].at(x, y) != (inside && expected.at<uchar>(y, x));
+                checked += inside;
+            }
+        }
+        EXPECT_GT(masks[i].area(), 0u);
+        EXPECT_LE(mismatches, checked / 100);
+    }
+
+    // Letterboxed source: a positive prototype fills the box
+    const std::vector<float> ones(16 * 16, 5.f);
+    const std::vector<float> coefficient = {1.f};
+    letterbox_params.new_shape = cv::Size(64, 64);
+    const LetterboxInfo boxed = getLetterboxInfo(cv::Size(200, 100), letterbox_params);
+    decodeMasks(ones.data(), 1, proto_size, coefficient.data(), boxes.data(), 1, boxed, ws, masks);
+    ASSERT_EQ(masks.size(), 1u);
+    EXPECT_EQ(masks[0].image_size, cv::Size(200, 100));
+    EXPECT_EQ(masks[0].area(), 41u * 30u);
+
+    EXPECT_THROW(decodeMasks(ones.data(), 1, proto_size, coefficient.data(), boxes.data(), 1, LetterboxInfo(), ws, masks),
+                 std::invalid_argument);
+}
@@ -0,0 +1,331 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+#include <utils/mot_utils.hpp>
+
+TEST(MotUtilsTest, ParseFields)
+{
+    const std::string text = "1,2,10.0,20.0,30.0,40.0,0.9,1.0,2.0,3.0\n"
+                             "2,-1,1359.1,413.27,120.26,362.77,2.3092,-1,-1,-1";
+    DetectionBatch batch;
+    std::vector<MotParseError> errors;
+
+    EXPECT_EQ(parseMot(text.data(), text.size(), batch, errors), 2u);
+    EXPECT_TRUE(errors.empty());
+    ASSERT_EQ(batch.size(), 2u);
+
+    EXPECT_EQ(batch.frame_ids[0], 1);
+    EXPECT_EQ(batch.track_ids[0], 2);
+    EXPECT_FLOAT_EQ(batch.bboxes[0].x, 10.f);
+    EXPECT_FLOAT_EQ(batch.bboxes[0].height, 40.f);
+    EXPECT_FLOAT_EQ(batch.confidences[0], 0.9f);
+    EXPECT_FLOAT_EQ(batch.positions[0].z, 3.f);
+    EXPECT_EQ(batch.sizes[0], cv::Size(30, 40));
+    EXPECT_EQ(batch.class_ids[0], -1);
+    EXPECT_EQ(batch.mask_ids[0], -1);
+
+    EXPECT_EQ(batch.track_ids[1], -1);
+    EXPECT_FLOAT_EQ(batch.bboxes[1].x, 1359.1f);
+    EXPECT_FLOAT_EQ(batch.confidences[1], 2.3092f);
+}
+
+TEST(MotUtilsTest, MatchesStreamOperator)
+{
+    const std::string text = "3,7,1.5,2.5,3.5,4.5,0.75,0.1,0.2,0.3\n";
+    DetectionBatch batch;
+    std::vector<MotParseError> errors;
+    parseMot(text.data(), text.size(), batch, errors);
+
+    Detection det;
+    std::stringstream ss(text);
+    ss >> det;
+
+    Detection row = batch[0];
+    EXPECT_EQ(row.frame_id, det.frame_id);
+    EXPECT_EQ(row.track_id, det.track_id);
+    EXPECT_EQ(row.bbox, det.bbox);
+    EXPECT_EQ(row.confidence, det.confidence);
+    EXPECT_EQ(row.position, det.position);
+    EXPECT_EQ(row.size, det.size);
+}
+
+TEST(MotUtilsTest, ReportsMalformedLines)
+{
+    const std::string text = "1,1,0,0,10,10,1,0,0,0\r\n"
+                             "\n"
+                             "1,x,0,0,10,10,1,0,0,0\n"
+                             "2,1,0,0,10,10,1\n"
+                             "  \n"
+                             "2,2,0,0,10,10,1,0,0,0,5\n"
+                             "3,1,0,0,10,10,1,0,0,0\n";
+    DetectionBatch batch;
+    std::vector<MotParseError> errors;
+
+    EXPECT_EQ(parseMot(text.data(), text.size(), batch, errors), 2u);
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.frame_ids[0], 1);
+    EXPECT_EQ(batch.frame_ids[1], 3);
+
+    ASSERT_EQ(errors.size(), 3u);
+    EXPECT_EQ(errors[0].line, 3u);
+    EXPECT_EQ(errors[1].line, 4u);
+    EXPECT_EQ(errors[2].line, 6u);
+    EXPECT_NE(errors[0].message.find("1,x,0"), std::string::npos);
+}
+
+TEST(MotUtilsTest, AppendsToBatch)
+{
+    DetectionBatch batch;
+    Detection det;
+    det.class_id = 4;
+    det.features = {1.f, 2.f};
+    batch.push_back(det);
+
+    const std::string text = "1,1,0,0,10,10,1,0,0,0\n";
+    std::vector<MotParseError> errors;
+    EXPECT_EQ(parseMot(text.data(), text.size(), batch, errors), 1u);
+
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.class_ids[0], 4);
+    EXPECT_EQ(batch.frame_ids[1], 1);
+    ASSERT_EQ(batch.features.size(), 4u);
+    EXPECT_FLOAT_EQ(batch.feature(1)[0], 0.f);
+}
+
+TEST(MotUtilsTest, ParallelMatchesSequential)
+{
+    // Large enough to be split into several chunks, with malformed lines spread across them
+    std::string text;
+    for (int i = 0; i < 60000; ++i)
+    {
+        if (i % 9973 == 5)
+            text += "garbage\n";
+        text += std::to_string(i / 10 + 1) + "," + std::to_string(i % 10) + ",100.25,200.5,30.75,60.125,0.875,-1,-1,-1\n";
+    }
+
+    DetectionBatch sequential, parallel;
+    std::vector<MotParseError> sequential_errors, parallel_errors;
+    parseMot(text.data(), text.size(), sequential, sequential_errors, 1);
+    parseMot(text.data(), text.size(), parallel, parallel_errors, 4);
+
+    ASSERT_EQ(sequential.size(), 60000u);
+    EXPECT_EQ(parallel.frame_ids, sequential.frame_ids);
+    EXPECT_EQ(parallel.track_ids, sequential.track_ids);
+    EXPECT_EQ(parallel.bboxes, sequential.bboxes);
+
+    ASSERT_EQ(parallel_errors.size(), sequential_errors.size());
+    ASSERT_EQ(parallel_errors.size(), 7u);
+    for (size_t i = 0; i < parallel_errors.size(); ++i)
+        EXPECT_EQ(parallel_errors[i].line, sequential_errors[i].line);
+    EXPECT_EQ(parallel_errors[0].line, 6u);
+}
+
+TEST(MotUtilsTest, LoadFile)
+{
+    const std::string path = testing::TempDir() + "mot_utils_test.txt";
+    {
+        std::ofstream file(path);
+        file << "1,1,10,20,30,40,0.5,0,0,0\n2,1,11,21,30,40,0.6,0,0,0\n";
+    }
+
+    DetectionBatch batch;
+    std::vector<MotParseError> errors;
+    EXPECT_EQ(loadMot(path, batch, errors), 2u);
+    std::remove(path.c_str());
+
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(batch.frame_ids, (std::pmr::vector<int64_t>{1, 2}));
+    EXPECT_FLOAT_EQ(batch.bboxes[1].x, 11.f);
+
+    EXPECT_THROW(loadMot(path, batch, errors), std::runtime_error);
+}
+
+TEST(MotUtilsTest, FormatMatchesStreamOperator)
+{
+    const std::vector<float> values{0.f, -0.f, 0.9f, 1.f / 3.f, -12.5f, 1359.1f, 123456789.f, 1e-7f, 2.3092f, 1e30f};
+    char line[MOT_MAX_LINE_SIZE];
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        Detection det;
+        det.frame_id = static_cast<int64_t>(i) * 1000000007;
+        det.track_id = -static_cast<int64_t>(i);
+        det.bbox = cv::Rect2f(values[i], values[(i + 1) % values.size()], values[(i + 2) % values.size()], 7.f);
+        det.confidence = values[(i + 3) % values.size()];
+        det.position = cv::Point3f(values[(i + 4) % values.size()], -1.f, values[(i + 5) % values.size()]);
+
+        std::ostringstream expected;
+        expected << det << "\n";
+
+        MotRecord record{det.frame_id, det.track_id, det.bbox.x, det.bbox.y, det.bbox.width, det.bbox.height,
+                         det.confidence, det.position.x, det.position.y, det.position.z};
+        char *end = formatMotRecord(line, line + sizeof(line), record);
+        EXPECT_EQ(std::string(line, end), expected.str());
+    }
+}
+
+TEST(MotUtilsTest, WriterRoundTrip)
+{
+    const std::string path = testing::TempDir() + "mot_writer_test.txt";
+
+    DetectionBatch batch;
+    std::ostringstream expected;
+    for (int i = 0; i < 5000; ++i)
+    {
+        Detection det;
+        det.frame_id = i / 10 + 1;
+        det.track_id = i % 10;
+        det.bbox = cv::Rect2f(i * 0.37f, i * 1.13f, 20.5f, 40.25f);
+        det.confidence = 1.f / static_cast<float>(i + 1);
+        batch.push_back(det);
+        expected << det << "\n";
+    }
+
+    MotWriterParams params;
+    params.buffer_size = 4096;
+    params.queue_capacity = 2;
+    {
+        MotWriter writer(path, params);
+        writer.write(batch);
+        writer.flush();
+        EXPECT_EQ(writer.stats().rows_written, batch.size());
+        writer.write(batch[0]);
+        writer.close();
+
+        EXPECT_EQ(writer.stats().rows_written, batch.size() + 1);
+        EXPECT_EQ(writer.stats().rows_dropped, 0u);
+        EXPECT_THROW(writer.write(batch[0]), std::runtime_error);
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::ostringstream first_row;
+    first_row << batch[0] << "\n";
+    EXPECT_EQ(contents.str(), expected.str() + first_row.str());
+
+    DetectionBatch loaded;
+    std::vector<MotParseError> errors;
+    loadMot(path, loaded, errors);
+    std::remove(path.c_str());
+    EXPECT_TRUE(errors.empty());
+    ASSERT_EQ(loaded.size(), batch.size() + 1);
+    EXPECT_EQ(loaded.frame_ids[4999], batch.frame_ids[4999]);
+}
+
+TEST(MotUtilsTest, WriterDropPolicyAccountsForEveryRow)
+{
+    const std::string path = testing::TempDir() + "mot_writer_drop_test.txt";
+
+    MotWriterParams params;
+    params.buffer_size = 64;
+    params.queue_capacity = 1;
+    params.policy = QueuePolicy::DropNewest;
+
+    MotWriter writer(path, params);
+    Detection det;
+    for (int i = 0; i < 2000; ++i)
+        writer.write(det);
+    writer.close();
+    std::remove(path.c_str());
+
+    auto stats = writer.stats();
+    EXPECT_EQ(stats.rows_written + stats.rows_dropped, 2000u);
+    EXPECT_GT(stats.rows_written, 0u);
+}
+
+class MotFrameReaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path = testing::TempDir() + "mot_frame_reader_test.txt";
+        std::ofstream file(path);
+        for (int frame_id = 1; frame_id <= 50; ++frame_id)
+        {
+            if (frame_id == 7)
+                file << "not,a,mot,line," << std::string(100, 'x') << "\n\n";
+            for (int i = 0; i < frame_id % 4 + 1; ++i)
+                file << frame_id << "," << i << "," << frame_id * 1.5 << ",2,30,40,0.5,-1,-1,-1\n";
+        }
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::vector<DetectionBatch> readAll(const MotReaderParams &params)
+    {
+        std::vector<DetectionBatch> frames;
+        MotFrameReader reader(path, params);
+        DetectionBatch frame;
+        while (reader.next(frame))
+            frames.push_back(frame);
+        errors = reader.errors();
+        return frames;
+    }
+
+    std::string path;
+    std::vector<MotParseError> errors;
+};
+
+TEST_F(MotFrameReaderTest, GroupsByFrame)
+{
+    MotReaderParams params;
+    params.buffer_size = 64; // the minimum: refills every couple of lines, the long malformed line grows the buffer
+    auto frames = readAll(params);
+
+    ASSERT_EQ(frames.size(), 50u);
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        const int64_t frame_id = static_cast<int64_t>(f) + 1;
+        ASSERT_EQ(frames[f].size(), static_cast<size_t>(frame_id % 4 + 1));
+        EXPECT_EQ(frames[f].frame_ids, std::pmr::vector<int64_t>(frames[f].size(), frame_id));
+        EXPECT_EQ(frames[f].track_ids.back(), static_cast<int64_t>(frames[f].size()) - 1);
+        EXPECT_FLOAT_EQ(frames[f].bboxes[0].x, frame_id * 1.5f);
+    }
+
+    ASSERT_EQ(errors.size(), 1u);
+    EXPECT_EQ(errors[0].line, 16u);
+}
+
+TEST_F(MotFrameReaderTest, ReadAheadMatchesOnDemand)
+{
+    auto expected = readAll({});
+
+    MotReaderParams params;
+    params.read_ahead = 2;
+    auto frames = readAll(params);
+
+    ASSERT_EQ(frames.size(), expected.size());
+    for (size_t f = 0; f < frames.size(); ++f)
+    {
+        EXPECT_EQ(frames[f].frame_ids, expected[f].frame_ids);
+        EXPECT_EQ(frames[f].bboxes, expected[f].bboxes);
+    }
+    EXPECT_EQ(errors.size(), 1u);
+
+    // Stopping early joins the read-ahead thread
+    MotFrameReader reader(path, params);
+    DetectionBatch frame;
+    EXPECT_TRUE(reader.next(frame));
+}
+
+TEST_F(MotFrameReaderTest, VerifySorted)
+{
+    {
+        std::ofstream file(path, std::ios::app);
+        file << "3,0,0,0,10,10,1,-1,-1,-1\n";
+    }
+
+    MotReaderParams params;
+    EXPECT_EQ(readAll(params).size(), 51u);
+
+    params.verify_sorted = true;
+    EXPECT_THROW(readAll(params), std::runtime_error);
+
+    params.read_ahead = 4;
+    EXPECT_THROW(readAll(params), std::runtime_error);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <utils/nms_utils.hpp>
+
+class NmsUtilsTest : public ::testing::Test
+{
+protected:
+    // Two overlapping boxes of class 0, one box of class 1 on top of them and a separate box
+    std::vector<cv::Rect2f> boxes{
+        {0.f, 0.f, 10.f, 10.f},
+        {1.f, 1.f, 10.f, 10.f},
+        {0.f, 0.f, 10.f, 10.f},
+        {50.f, 50.f, 10.f, 10.f}};
+    std::vector<float> scores{0.9f, 0.8f, 0.7f, 0.6f};
+    std::vector<int> class_ids{0, 0, 1, 0};
+};
+
+TEST_F(NmsUtilsTest, GreedyClassAware)
+{
+    auto keep = nms(boxes, scores, class_ids);
+    EXPECT_EQ(keep, (std::vector<int>{0, 2, 3}));
+}
+
+TEST_F(NmsUtilsTest, GreedyClassAgnostic)
+{
+    NmsParams params;
+    params.class_agnostic = true;
+    auto keep = nms(boxes, scores, class_ids, params);
+    EXPECT_EQ(keep, (std::vector<int>{0, 3}));
+}
+
+TEST_F(NmsUtilsTest, BatchedMatchesClassAware)
+{
+    NmsParams params;
+    params.mode = NmsMode::Batched;
+    EXPECT_EQ(nms(boxes, scores, class_ids, params), nms(boxes, scores, class_ids));
+}
+
+TEST_F(NmsUtilsTest, ScoreThresholdAndMaxDet)
+{
+    NmsParams params;
+    params.score_threshold = 0.75f;
+    EXPECT_EQ(nms(boxes, scores, class_ids, params), (std::vector<int>{0}));
+
+    params.score_threshold = 0.f;
+    params.max_det = 2;
+    EXPECT_EQ(nms(boxes, scores, class_ids, params), (std::vector<int>{0, 2}));
+}
+
+TEST_F(NmsUtilsTest, ClassAwareMaxDetIsGlobal)
+{
+    // Classes stop early once they cannot reach the top max_det, the result is still the
+    // best max_det survivors over all classes
+    cv::RNG rng(5);
+    std::vector<cv::Rect2f> many_boxes;
+    std::vector<float> many_scores;
+    std::vector<int> many_classes;
+    for (int i = 0; i < 500; ++i)
+    {
+        many_boxes.emplace_back(rng.uniform(0.f, 200.f), rng.uniform(0.f, 200.f), rng.uniform(5.f, 40.f), rng.uniform(5.f, 40.f));
+        many_scores.push_back(static_cast<float>(rng.uniform(0, 50)) / 50.f);
+        many_classes.push_back(rng.uniform(0, 6));
+    }
+
+    NmsParams params;
+    params.score_threshold = 0.f;
+    params.max_det = 1000;
+    const std::vector<int> all = nms(many_boxes, many_scores, many_classes, params);
+    ASSERT_GT(all.size(), 40u);
+
+    for (size_t max_det : {1, 7, 40})
+    {
+        params.max_det = max_det;
+        EXPECT_EQ(nms(many_boxes, many_scores, many_classes, params), std::vector<int>(all.begin(), all.begin() + max_det));
+    }
+}
+
+TEST_F(NmsUtilsTest, SoftNmsDecaysOverlaps)
+{
+    NmsParams params;
+    params.mode = NmsMode::Soft;
+    params.score_threshold = 0.1f;
+    params.iou_threshold = 0.3f;
+
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+    nms(boxes.data(), scores.data(), class_ids.data(), boxes.size(), params, ws, keep, keep_scores);
+
+    ASSERT_EQ(keep.size(), 4u);
+    EXPECT_EQ(keep[0], 0);
+    EXPECT_FLOAT_EQ(keep_scores[0], 0.9f);
+
+    // Box 1 overlaps box 0 with IoU 81/119 and is decayed linearly
+    auto it = std::find(keep.begin(), keep.end(), 1);
+    ASSERT_NE(it, keep.end());
+    EXPECT_NEAR(keep_scores[it - keep.begin()], 0.8f * (1.f - 81.f / 119.f), 1e-5f);
+    EXPECT_TRUE(std::is_sorted(keep_scores.rbegin(), keep_scores.rend()));
+
+    params.decay = NmsDecay::Gaussian;
+    nms(boxes.data(), scores.data(), class_ids.data(), boxes.size(), params, ws, keep, keep_scores);
+    it = std::find(keep.begin(), keep.end(), 1);
+    ASSERT_NE(it, keep.end());
+    float iou = 81.f / 119.f;
+    EXPECT_NEAR(keep_scores[it - keep.begin()], 0.8f * std::exp(-iou * iou / params.sigma), 1e-5f);
+}
+
+TEST_F(NmsUtilsTest, MatrixNms)
+{
+    NmsParams params;
+    params.mode = NmsMode::Matrix;
+    params.score_threshold = 0.1f;
+
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+    nms(boxes.data(), scores.data(), class_ids.data(), boxes.size(), params, ws, keep, keep_scores);
+
+    ASSERT_EQ(keep.size(), 4u);
+    EXPECT_EQ(keep[0], 0);
+    EXPECT_FLOAT_EQ(keep_scores[0], 0.9f);
+    auto it = std::find(keep.begin(), keep.end(), 1);
+    ASSERT_NE(it, keep.end());
+    EXPECT_NEAR(keep_scores[it - keep.begin()], 0.8f * (1.f - 81.f / 119.f), 1e-5f);
+}
+
+TEST_F(NmsUtilsTest, DetectionOverloads)
+{
+    std::vector<Detection> detections(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+        detections[i].bbox = boxes[i];
+        detections[i].confidence = scores[i];
+        detections[i].class_id = class_ids[i];
+    }
+
+    auto kept = nms(detections);
+    ASSERT_EQ(kept.size(), 3u);
+    EXPECT_EQ(kept[1].class_id, 1);
+
+    auto batch = DetectionBatch::fromDetections(detections);
+    NmsWorkspace ws;
+    std::vector<int> keep;
+    std::vector<float> keep_scores;
+    nms(batch, NmsParams(), ws, keep, keep_scores);
+    EXPECT_EQ(keep, (std::vector<int>{0, 2, 3}));
+}
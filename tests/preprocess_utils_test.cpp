@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <utils/preprocess_utils.hpp>
+
+class PreprocessUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        input = cv::Mat(100, 200, CV_8UC3);
+        for (int y = 0; y < input.rows; ++y)
+        {
+            for (int x = 0; x < input.cols; ++x)
+            {
+                uchar *pixel = input.ptr<uchar>(y) + 3 * x;
+                pixel[0] = static_cast<uchar>(x);
+                pixel[1] = static_cast<uchar>(2 * y);
+                pixel[2] = static_cast<uchar>((x + y) % 256);
+            }
+        }
+        params.new_shape = cv::Size(320, 320);
+    }
+
+    // letterbox() then BGR to RGB, normalization and HWC to CHW
+    std::vector<float> reference(const TensorParams &tensor_params) const
+    {
+        cv::Mat boxed = letterbox(input, params);
+        const size_t plane = boxed.total();
+        std::vector<float> tensor(3 * plane);
+        for (int y = 0; y < boxed.rows; ++y)
+        {
+            for (int x = 0; x < boxed.cols; ++x)
+            {
+                const uchar *pixel = boxed.ptr<uchar>(y) + 3 * x;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float value = pixel[tensor_params.swap_rb ? 2 - c : c];
+                    tensor[c * plane + y * boxed.cols + x] =
+                        static_cast<float>((value - tensor_params.mean[c]) * tensor_params.scale / tensor_params.std[c]);
+                }
+            }
+        }
+        return tensor;
+    }
+
+    cv::Mat input;
+    LetterboxParams params;
+};
+
+TEST_F(PreprocessUtilsTest, LetterboxInfo)
+{
+    LetterboxInfo info = getLetterboxInfo(input.size(), params);
+    EXPECT_FLOAT_EQ(info.scale_x, 1.6f);
+    EXPECT_EQ(info.resized, cv::Size(320, 160));
+    EXPECT_EQ(info.shape, cv::Size(320, 320));
+    EXPECT_EQ(info.top, 80);
+    EXPECT_EQ(info.bottom, 80);
+    EXPECT_EQ(info.left, 0);
+    EXPECT_EQ(getTensorSize(input.size(), params), 3u * 320u * 320u);
+
+    cv::Rect2f box = info.toSource(cv::Rect2f(16.f, 96.f, 32.f, 16.f));
+    EXPECT_FLOAT_EQ(box.x, 10.f);
+    EXPECT_FLOAT_EQ(box.y, 10.f);
+    EXPECT_FLOAT_EQ(box.width, 20.f);
+    EXPECT_FLOAT_EQ(box.height, 10.f);
+
+    params.auto_size = true;
+    info = getLetterboxInfo(input.size(), params);
+    EXPECT_EQ(info.shape, cv::Size(320, 160));
+}
+
+TEST_F(PreprocessUtilsTest, MatchesLetterboxAndBlob)
+{
+    TensorParams tensor_params;
+    tensor_params.mean = cv::Scalar(0.485 * 255, 0.456 * 255, 0.406 * 255);
+    tensor_params.std = cv::Scalar(0.229, 0.224, 0.225);
+
+    for (cv::Size new_shape : {cv::Size(320, 320), cv::Size(96, 64), cv::Size(200, 100)})
+    {
+        params.new_shape = new_shape;
+        std::vector<float> expected = reference(tensor_params);
+        std::vector<float> tensor(getTensorSize(input.size(), params), -1.f);
+        letterboxToTensor(input, tensor.data(), params, tensor_params);
+
+        ASSERT_EQ(tensor.size(), expected.size());
+        // cv::resize rounds to 8 bits with fixed-point weights
+        const float tolerance = 1.01f * tensor_params.scale / 0.224f;
+        for (size_t i = 0; i < tensor.size(); ++i)
+            ASSERT_NEAR(tensor[i], expected[i], tolerance) << "shape " << new_shape.width << "x" << new_shape.height << " index " << i;
+    }
+}
+
+TEST_F(PreprocessUtilsTest, PaddingAndHalf)
+{
+    TensorParams tensor_params;
+    tensor_params.swap_rb = false;
+    params.color = cv::Scalar(10, 20, 30);
+
+    std::vector<float> tensor(getTensorSize(input.size(), params));
+    LetterboxInfo info = letterboxToTensor(input, tensor.data(), params, tensor_params);
+    const size_t plane = static_cast<size_t>(info.shape.area());
+    EXPECT_FLOAT_EQ(tensor[0], 10.f / 255.f);
+    EXPECT_FLOAT_EQ(tensor[plane], 20.f / 255.f);
+    EXPECT_FLOAT_EQ(tensor[3 * plane - 1], 30.f / 255.f);
+    // First content pixel is the unscaled top-left input pixel
+    EXPECT_FLOAT_EQ(tensor[info.top * info.shape.width], 0.f);
+
+    std::vector<uint16_t> half(tensor.size());
+    letterboxToTensor(input, half.data(), params, tensor_params);
+    for (size_t i = 0; i < tensor.size(); ++i)
+        ASSERT_EQ(half[i], quantize::floatToHalf(tensor[i])) << "index " << i;
+}
+
+TEST_F(PreprocessUtilsTest, InvalidInput)
+{
+    std::vector<float> tensor(3 * 320 * 320);
+    EXPECT_THROW(letterboxToTensor(cv::Mat(), tensor.data(), params), std::invalid_argument);
+    EXPECT_THROW(letterboxToTensor(cv::Mat(10, 10, CV_8UC1), tensor.data(), params), std::invalid_argument);
+}
+
+TEST_F(PreprocessUtilsTest, BatchMatchesSingleImage)
+{
+    // Different sizes and aspect ratios in one batch
+    std::vector<Frame> frames;
+    frames.emplace_back(input);
+    frames.emplace_back(input(cv::Rect(10, 5, 60, 90)).clone());
+    cv::Mat tall, large;
+    cv::resize(input, tall, cv::Size(50, 150));
+    cv::resize(input, large, cv::Size(1000, 700));
+    frames.emplace_back(tall);
+    frames.emplace_back(large);
+
+    BatchPreprocessParams batch_params;
+    batch_params.letterbox = params;
+    batch_params.num_threads = 3;
+    batch_params.min_band_rows = 8;
+    BatchPreprocessor preprocessor(batch_params);
+    EXPECT_EQ(preprocessor.numThreads(), 3u);
+
+    // One image is split into bands, four images are not
+    for (size_t batch_size : {1u, 4u})
+    {
+        std::vector<Frame> batch(frames.begin(), frames.begin() + batch_size);
+        std::vector<float> tensor(preprocessor.tensorSize(batch_size), -1.f);
+        std::vector<LetterboxInfo> infos = preprocessor.process(batch, tensor.data());
+        ASSERT_EQ(infos.size(), batch_size);
+
+        std::vector<float> expected(preprocessor.imageSize());
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            LetterboxInfo info = letterboxToTensor(batch[i].image, expected.data(), params);
+            EXPECT_EQ(infos[i].shape, info.shape);
+            EXPECT_EQ(infos[i].resized, info.resized);
+            EXPECT_EQ(infos[i].top, info.top);
+            EXPECT_EQ(infos[i].left, info.left);
+            for (size_t v = 0; v < expected.size(); ++v)
+                ASSERT_EQ(tensor[i * expected.size() + v], expected[v]) << "image " << i << " index " << v;
+        }
+    }
+
+    std::vector<uint16_t> half(preprocessor.tensorSize(frames.size()));
+    std::vector<float> tensor(half.size());
+    preprocessor.process(frames, half.data());
+    preprocessor.process(frames, tensor.data());
+    for (size_t i = 0; i < tensor.size(); ++i)
+        ASSERT_EQ(half[i], quantize::floatToHalf(tensor[i])) << "index " << i;
+}
+
+TEST_F(PreprocessUtilsTest, BatchInvalidInput)
+{
+    BatchPreprocessParams batch_params;
+    batch_params.letterbox.auto_size = true;
+    EXPECT_THROW(BatchPreprocessor{batch_params}, std::invalid_argument);
+
+    BatchPreprocessor preprocessor;
+    std::vector<float> tensor(preprocessor.tensorSize(2));
+    EXPECT_TRUE(preprocessor.process(std::vector<cv::Mat>{}, tensor.data()).empty());
+    EXPECT_THROW(preprocessor.process(std::vector<cv::Mat>{input, cv::Mat()}, tensor.data()), std::invalid_argument);
+}
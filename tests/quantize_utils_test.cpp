@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <utils/quantize_utils.hpp>
+
+class QuantizeTest : public testing::TestWithParam<simd::Level>
+{
+protected:
+    void SetUp() override
+    {
+        simd::setLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        simd::setLevel(simd::detectLevel());
+    }
+
+    static std::vector<float> makeFeatures(size_t size, float seed)
+    {
+        std::vector<float> features(size);
+        for (size_t i = 0; i < size; ++i)
+            features[i] = std::sin(seed * static_cast<float>(i + 1)) * 0.2f;
+        return features;
+    }
+};
+
+TEST_P(QuantizeTest, HalfConversionMatchesScalar)
+{
+    std::vector<float> values = {0.f, -0.f, 1.f, -2.f, 0.1f, 65504.f, 65519.f, 65520.f, 1e6f, -1e6f,
+                                 5.9604645e-8f, 2.9802322e-8f, 6.1e-5f, 1.0009766f, 1.0004883f, 1.0014648f, 3.14159f};
+    std::vector<uint16_t> half(values.size());
+    quantize::toHalf(values.data(), values.size(), half.data());
+
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(half[i], quantize::floatToHalf(values[i])) << "value " << values[i];
+
+    std::vector<float> restored(values.size());
+    quantize::fromHalf(half.data(), half.size(), restored.data());
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(restored[i], quantize::halfToFloat(half[i])) << "value " << values[i];
+}
+
+TEST_P(QuantizeTest, DotMatchesFloat)
+{
+    for (size_t size : {3u, 20u, 128u, 512u, 515u})
+    {
+        auto a = makeFeatures(size, 0.3f), b = makeFeatures(size, 0.7f);
+        const float expected = vector_ops::dot(a, b);
+
+        HalfFeatures ha = quantizeHalf(a), hb = quantizeHalf(b);
+        EXPECT_NEAR(quantize::dot(ha.values.data(), hb.values.data(), size), expected, 1e-3f) << "size " << size;
+
+        Int8Features ia = quantizeInt8(a), ib = quantizeInt8(b);
+        int32_t exact = 0;
+        for (size_t i = 0; i < size; ++i)
+            exact += ia.values[i] * ib.values[i];
+        EXPECT_EQ(quantize::dot(ia.values.data(), ib.values.data(), size), exact) << "size " << size;
+        EXPECT_NEAR(static_cast<float>(exact) * ia.scale * ib.scale, expected, 1e-2f) << "size " << size;
+    }
+}
+
+TEST_P(QuantizeTest, CosineSimilarityMatchesFloat)
+{
+    auto a = makeFeatures(512, 0.3f), b = makeFeatures(512, 0.31f);
+    const float expected = cosineSimilarity(a, b);
+
+    EXPECT_NEAR(cosineSimilarity(quantizeHalf(a), quantizeHalf(b)), expected, 1e-4f);
+    EXPECT_NEAR(cosineSimilarity(quantizeInt8(a), quantizeInt8(b)), expected, 5e-3f);
+    EXPECT_NEAR(cosineSimilarity(quantizeInt8(a), quantizeInt8(a)), 1.f, 1e-6f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, QuantizeTest,
+                         testing::Values(simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512));
+
+TEST(QuantizeHalfTest, ScalarConversion)
+{
+    EXPECT_EQ(quantize::floatToHalf(1.f), 0x3c00);
+    EXPECT_EQ(quantize::floatToHalf(-2.f), 0xc000);
+    EXPECT_EQ(quantize::floatToHalf(0.1f), 0x2e66);
+    EXPECT_EQ(quantize::floatToHalf(65504.f), 0x7bff);
+    EXPECT_EQ(quantize::floatToHalf(65520.f), 0x7c00);
+    EXPECT_EQ(quantize::floatToHalf(-INFINITY), 0xfc00);
+    EXPECT_EQ(quantize::floatToHalf(5.9604645e-8f), 0x0001);
+    EXPECT_EQ(quantize::floatToHalf(2.9802322e-8f), 0x0000); // tie rounds to even
+    EXPECT_EQ(quantize::floatToHalf(1.0004883f), 0x3c00);    // tie rounds to even
+    EXPECT_EQ(quantize::floatToHalf(1.0014648f), 0x3c02);
+    EXPECT_TRUE(std::isnan(quantize::halfToFloat(quantize::floatToHalf(NAN))));
+
+    for (uint32_t half = 0; half < 0x10000; ++half)
+    {
+        const float value = quantize::halfToFloat(static_cast<uint16_t>(half));
+        if (!std::isnan(value))
+        {
+            EXPECT_EQ(quantize::floatToHalf(value), half);
+        }
+    }
+    EXPECT_EQ(quantize::halfToFloat(0x0001), 5.9604645e-8f);
+    EXPECT_EQ(quantize::halfToFloat(0x7bff), 65504.f);
+    EXPECT_EQ(quantize::halfToFloat(0x7c00), INFINITY);
+}
+
+TEST(QuantizeInt8Test, SymmetricScale)
+{
+    std::vector<float> features = {0.5f, -1.f, 0.25f, 0.f};
+    Int8Features quantized = quantizeInt8(features);
+    EXPECT_FLOAT_EQ(quantized.scale, 1.f / 127.f);
+    EXPECT_EQ(quantized.values, (std::vector<int8_t>{64, -127, 32, 0}));
+
+    auto restored = dequantize(quantized);
+    for (size_t i = 0; i < features.size(); ++i)
+        EXPECT_NEAR(restored[i], features[i], quantized.scale / 2.f);
+
+    Int8Features zero = quantizeInt8(std::vector<float>(8, 0.f));
+    EXPECT_EQ(zero.scale, 0.f);
+    EXPECT_EQ(zero.values, std::vector<int8_t>(8, 0));
+    EXPECT_FLOAT_EQ(cosineSimilarity(zero, zero), 0.f);
+
+    EXPECT_THROW(cosineSimilarity(quantized, zero), std::invalid_argument);
+    EXPECT_THROW(cosineSimilarity(quantizeHalf(features), quantizeHalf({1.f})), std::invalid_argument);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <utils/render_utils.hpp>
+
+class OverlayRendererTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        image = cv::Mat(100, 100, CV_8UC3, cv::Scalar(100, 100, 100));
+
+        // Absolute box with a mask covering its left half
+        Detection det;
+        det.bbox = cv::Rect2f(20.f, 30.f, 40.f, 40.f);
+        det.size = cv::Size(40, 40);
+        det.class_id = 3;
+        det.class_name = "car";
+        det.confidence = 0.5f;
+        det.mask = cv::Mat::zeros(10, 10, CV_32F);
+        det.mask(cv::Rect(0, 0, 5, 10)) = 1.0f;
+        detections.push_back(det);
+    }
+
+    cv::Mat image;
+    std::vector<Detection> detections;
+};
+
+TEST_F(OverlayRendererTest, InPlace)
+{
+    OverlayParams params;
+    params.draw_labels = false;
+    OverlayRenderer renderer(params);
+    renderer.render(image, detections);
+
+    const cv::Scalar &color = detections[0].getClassColor();
+    const float alpha = params.mask_alpha;
+
+    // Box outline
+    EXPECT_EQ(image.at<cv::Vec3b>(50, 20)[0], static_cast<uchar>(color[0]));
+    EXPECT_EQ(image.at<cv::Vec3b>(30, 40)[2], static_cast<uchar>(color[2]));
+
+    // Mask blended inside the box only
+    for (int c = 0; c < 3; ++c)
+        EXPECT_EQ(image.at<cv::Vec3b>(50, 30)[c], cv::saturate_cast<uchar>((1.f - alpha) * 100.f + alpha * color[c]));
+    EXPECT_EQ(image.at<cv::Vec3b>(50, 50), cv::Vec3b(100, 100, 100));
+    EXPECT_EQ(image.at<cv::Vec3b>(90, 90), cv::Vec3b(100, 100, 100));
+    EXPECT_EQ(image.at<cv::Vec3b>(10, 10), cv::Vec3b(100, 100, 100));
+}
+
+TEST_F(OverlayRendererTest, ReusesOutputBuffer)
+{
+    OverlayRenderer renderer;
+    cv::Mat output;
+    renderer.render(image, detections, output);
+    const uchar *data = output.data;
+
+    renderer.render(image, detections, output);
+    EXPECT_EQ(output.data, data);
+    EXPECT_EQ(output.size(), image.size());
+
+    // Source untouched, label background drawn above the box
+    EXPECT_EQ(image.at<cv::Vec3b>(50, 20), cv::Vec3b(100, 100, 100));
+    EXPECT_EQ(output.at<cv::Vec3b>(22, 22)[1], static_cast<uchar>(detections[0].getClassColor()[1]));
+}
+
+TEST_F(OverlayRendererTest, LabelCache)
+{
+    OverlayParams params;
+    params.max_cached_labels = 2;
+    OverlayRenderer renderer(params);
+
+    renderer.render(image, detections);
+    renderer.render(image, detections);
+    EXPECT_EQ(renderer.cachedLabels(), 1u);
+
+    for (int64_t track_id = 0; track_id < 5; ++track_id)
+    {
+        detections[0].track_id = track_id;
+        renderer.render(image, detections);
+        EXPECT_LE(renderer.cachedLabels(), 2u);
+    }
+}
+
+TEST_F(OverlayRendererTest, EmptyAndInvalid)
+{
+    OverlayRenderer renderer;
+    cv::Mat output;
+    renderer.render(image, {}, output);
+    EXPECT_EQ(output.at<cv::Vec3b>(50, 50), cv::Vec3b(100, 100, 100));
+
+    cv::Mat gray(100, 100, CV_8UC1, cv::Scalar(0));
+    EXPECT_THROW(renderer.render(gray, detections), std::invalid_argument);
+
+    detections[0].mask = cv::Mat();
+    EXPECT_NO_THROW(renderer.render(gray, detections));
+}
+
+TEST_F(OverlayRendererTest, MaskCrossingImageBorder)
+{
+    OverlayParams params;
+    params.draw_labels = false;
+    params.thickness = 1;
+    OverlayRenderer renderer(params);
+
+    // The box sticks out 20 pixels past the left and top edges, the mask covers its left half,
+    // so only image columns 0-19 of the box are foreground
+    detections[0].bbox = cv::Rect2f(-20.f, -20.f, 80.f, 80.f);
+    detections[0].size = cv::Size(80, 80);
+    detections[0].mask = cv::Mat::zeros(8, 8, CV_32F);
+    detections[0].mask(cv::Rect(0, 0, 4, 8)) = 1.0f;
+    renderer.render(image, detections);
+
+    const cv::Scalar &color = detections[0].getClassColor();
+    const float alpha = params.mask_alpha;
+    for (int c = 0; c < 3; ++c)
+    {
+        EXPECT_EQ(image.at<cv::Vec3b>(30, 5)[c], cv::saturate_cast<uchar>((1.f - alpha) * 100.f + alpha * color[c]));
+        EXPECT_EQ(image.at<cv::Vec3b>(30, 18)[c], cv::saturate_cast<uchar>((1.f - alpha) * 100.f + alpha * color[c]));
+    }
+    EXPECT_EQ(image.at<cv::Vec3b>(30, 22), cv::Vec3b(100, 100, 100));
+    EXPECT_EQ(image.at<cv::Vec3b>(30, 40), cv::Vec3b(100, 100, 100));
+    EXPECT_EQ(image.at<cv::Vec3b>(70, 5), cv::Vec3b(100, 100, 100));
+}
+
+TEST(ColorPaletteTest, StableColors)
+{
+    EXPECT_EQ(&Detection::getColorById(7), &Detection::getColorById(7));
+    EXPECT_EQ(Detection::getColorById(7), Detection::getColorById(7 + 256));
+    EXPECT_NE(Detection::getColorById(1), Detection::getColorById(2));
+    for (int64_t id = -1; id < 300; ++id)
+    {
+        const cv::Scalar &color = Detection::getColorById(id);
+        for (int c = 0; c < 3; ++c)
+        {
+            EXPECT_GE(color[c], 0.);
+            EXPECT_LT(color[c], 256.);
+        }
+    }
+}
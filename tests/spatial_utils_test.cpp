@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <utils/spatial_utils.hpp>
+
+class SpatialUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        cv::RNG rng(7);
+        for (int i = 0; i < 300; ++i)
+        {
+            boxes1.emplace_back(rng.uniform(0.f, 500.f), rng.uniform(0.f, 500.f), rng.uniform(2.f, 40.f), rng.uniform(2.f, 40.f));
+            boxes2.emplace_back(rng.uniform(0.f, 500.f), rng.uniform(0.f, 500.f), rng.uniform(2.f, 40.f), rng.uniform(2.f, 40.f));
+        }
+        // A large box spanning many cells
+        boxes2.emplace_back(100.f, 100.f, 300.f, 300.f);
+    }
+
+    static std::vector<std::pair<int, int>> pairs(const std::vector<BoxOverlap> &overlaps)
+    {
+        std::vector<std::pair<int, int>> result;
+        for (const auto &overlap : overlaps)
+            result.emplace_back(overlap.first, overlap.second);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<cv::Rect2f> boxes1;
+    std::vector<cv::Rect2f> boxes2;
+};
+
+TEST_F(SpatialUtilsTest, EmptyGrid)
+{
+    BoxGrid grid;
+    std::vector<BoxOverlap> out;
+    grid.query(cv::Rect2f(0.f, 0.f, 10.f, 10.f), 0.f, out);
+    EXPECT_TRUE(grid.empty());
+    EXPECT_TRUE(out.empty());
+}
+
+TEST_F(SpatialUtilsTest, MatchesBruteForce)
+{
+    for (float threshold : {0.f, 0.3f})
+    {
+        std::vector<BoxOverlap> overlaps;
+        findOverlaps(boxes1, boxes2, threshold, overlaps);
+
+        std::vector<std::pair<int, int>> expected;
+        for (size_t i = 0; i < boxes1.size(); ++i)
+            for (size_t j = 0; j < boxes2.size(); ++j)
+                if (getIoU(boxes1[i], boxes2[j]) > threshold)
+                    expected.emplace_back(static_cast<int>(i), static_cast<int>(j));
+
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(pairs(overlaps), expected);
+        for (const auto &overlap : overlaps)
+            EXPECT_FLOAT_EQ(overlap.iou, getIoU(boxes1[overlap.first], boxes2[overlap.second]));
+    }
+}
+
+TEST_F(SpatialUtilsTest, SelfOverlaps)
+{
+    std::vector<BoxOverlap> overlaps;
+    findOverlaps(boxes2, 0.f, overlaps);
+
+    std::vector<std::pair<int, int>> expected;
+    for (size_t i = 0; i < boxes2.size(); ++i)
+        for (size_t j = i + 1; j < boxes2.size(); ++j)
+            if (getIoU(boxes2[i], boxes2[j]) > 0.f)
+                expected.emplace_back(static_cast<int>(i), static_cast<int>(j));
+
+    EXPECT_EQ(pairs(overlaps), expected);
+}
+
+TEST_F(SpatialUtilsTest, QueryOutsideGrid)
+{
+    BoxGrid grid(boxes1);
+    std::vector<BoxOverlap> out;
+    grid.query(cv::Rect2f(-100.f, -100.f, 10.f, 10.f), 0.f, out);
+    grid.query(cv::Rect2f(1000.f, 1000.f, 10.f, 10.f), 0.f, out);
+    EXPECT_TRUE(out.empty());
+
+    grid.query(cv::Rect2f(-1000.f, -1000.f, 3000.f, 3000.f), 0.f, out, 5);
+    EXPECT_EQ(out.size(), boxes1.size());
+    EXPECT_EQ(out.front().first, 5);
+}
+
+TEST_F(SpatialUtilsTest, FarOutsideCoordinates)
+{
+    // Cell indices of these would overflow int before clamping
+    BoxGrid grid(boxes1);
+    std::vector<BoxOverlap> out;
+    grid.query(cv::Rect2f(1e12f, 1e12f, 10.f, 10.f), 0.f, out);
+    grid.query(cv::Rect2f(-1e12f, -1e12f, 10.f, 10.f), 0.f, out);
+    EXPECT_TRUE(out.empty());
+
+    grid.query(cv::Rect2f(-1e12f, -1e12f, 2e12f, 2e12f), 0.f, out);
+    EXPECT_EQ(out.size(), boxes1.size());
+
+    // A far away box in the indexed set bounds the cell count, its neighbours are still found
+    std::vector<cv::Rect2f> boxes = boxes1;
+    boxes.emplace_back(3e9f, 3e9f, 10.f, 10.f);
+    std::vector<BoxOverlap> expected;
+    findOverlaps(boxes1, boxes1, 0.f, expected);
+    findOverlaps(boxes1, boxes, 0.f, out);
+    EXPECT_EQ(pairs(out), pairs(expected));
+}
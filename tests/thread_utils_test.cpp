@@ -0,0 +1,103 @@
+#include <atomic>
+#include <gtest/gtest.h>
+#include <utils/thread_utils.hpp>
+
+TEST(ThreadUtilsTest, ParallelForCoversRange)
+{
+    std::vector<std::atomic<int>> hits(1000);
+    parallelFor(0, hits.size(), 4, [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                        ++hits[i];
+                });
+    for (const auto &hit : hits)
+        EXPECT_EQ(hit.load(), 1);
+}
+
+TEST(ThreadUtilsTest, BoundedQueueDropPolicies)
+{
+    BoundedQueue<int> newest(2, QueuePolicy::DropNewest);
+    EXPECT_FALSE(newest.push(1));
+    EXPECT_FALSE(newest.push(2));
+    bool closed = true;
+    EXPECT_EQ(newest.push(3, closed), 3);
+    EXPECT_FALSE(closed);
+    EXPECT_EQ(newest.dropped(), 1u);
+    newest.close();
+    EXPECT_EQ(newest.push(4, closed), 4);
+    EXPECT_TRUE(closed);
+    EXPECT_EQ(newest.dropped(), 1u);
+
+    BoundedQueue<int> oldest(2, QueuePolicy::DropOldest);
+    oldest.push(1);
+    oldest.push(2);
+    EXPECT_EQ(oldest.push(3), 1);
+
+    int item = 0;
+    ASSERT_TRUE(oldest.tryPop(item));
+    EXPECT_EQ(item, 2);
+    ASSERT_TRUE(oldest.tryPop(item));
+    EXPECT_EQ(item, 3);
+    EXPECT_FALSE(oldest.tryPop(item));
+}
+
+TEST(ThreadUtilsTest, BoundedQueueBlocksAndCloses)
+{
+    BoundedQueue<int> queue(4);
+    std::thread producer([&queue]()
+                         {
+                             for (int i = 0; i < 1000; ++i)
+                                 queue.push(i);
+                             queue.close(); });
+
+    int item = 0, expected = 0;
+    while (queue.pop(item))
+        EXPECT_EQ(item, expected++);
+    producer.join();
+
+    EXPECT_EQ(expected, 1000);
+    EXPECT_EQ(queue.dropped(), 0u);
+    EXPECT_EQ(queue.push(1), 1);
+}
+
+TEST(ThreadUtilsTest, ThreadPoolRunsEveryTask)
+{
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.size(), 4u);
+
+    // Repeated runs on the same workers, each index exactly once
+    for (size_t count : {0u, 1u, 3u, 1000u})
+    {
+        std::vector<std::atomic<int>> hits(count);
+        pool.run(count, [&hits](size_t i)
+                 { hits[i].fetch_add(1); });
+        for (size_t i = 0; i < count; ++i)
+            EXPECT_EQ(hits[i].load(), 1) << "count " << count << " index " << i;
+    }
+
+    ThreadPool single(1);
+    EXPECT_EQ(single.size(), 1u);
+    size_t sum = 0;
+    single.run(10, [&sum](size_t i)
+               { sum += i; });
+    EXPECT_EQ(sum, 45u);
+}
+
+TEST(ThreadUtilsTest, ThreadPoolRethrows)
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> done{0};
+    EXPECT_THROW(pool.run(100, [&done](size_t i)
+                          {
+                              if (i == 42)
+                                  throw std::runtime_error("task failed");
+                              done.fetch_add(1); }),
+                 std::runtime_error);
+    EXPECT_EQ(done.load(), 99u);
+
+    // Still usable afterwards
+    done = 0;
+    pool.run(10, [&done](size_t)
+             { done.fetch_add(1); });
+    EXPECT_EQ(done.load(), 10u);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <utils/vector_utils.hpp>
+#include <opencv2/opencv.hpp>
 #include <vector>
 
 class VectorUtilsTest : public testing::Test
@@ -206,4 +207,146 @@ TEST_F(VectorUtilsTest, ArgmaxNegativeNumbers)
 {
     std::vector<float> input{-4.0f, -1.0f, -3.0f, -2.0f};
     EXPECT_EQ(vector_ops::argmax(input), 1);
-}
\ No newline at end of file
+}
+
+TEST_F(VectorUtilsTest, PointerKernelsMatchVectorApi)
+{
+    float out[3];
+
+    vector_ops::add(vec1.data(), vec2.data(), 3, out);
+    EXPECT_EQ(std::vector<float>(out, out + 3), vector_ops::add(vec1, vec2));
+
+    vector_ops::mul(vec1.data(), 3, scalar, out);
+    EXPECT_EQ(std::vector<float>(out, out + 3), vector_ops::mul(vec1, scalar));
+
+    vector_ops::compose(vec1.data(), vec2.data(), 3, 0.3f, out);
+    EXPECT_EQ(std::vector<float>(out, out + 3), vector_ops::compose(vec1, vec2, 0.3f));
+
+    vector_ops::sigmoid(vec1.data(), 3, out);
+    EXPECT_EQ(std::vector<float>(out, out + 3), vector_ops::sigmoid(vec1));
+
+    EXPECT_FLOAT_EQ(vector_ops::sum(vec2.data(), 3), 15.0f);
+    EXPECT_FLOAT_EQ(vector_ops::mean(vec2.data(), 3), 5.0f);
+    EXPECT_EQ(vector_ops::argmax(vec2.data(), 3), 2u);
+}
+
+TEST_F(VectorUtilsTest, InPlace)
+{
+    std::vector<float> values = vec1;
+    vector_ops::addInPlace(values, vec2);
+    vector_ops::mulInPlace(values, 0.5f);
+    EXPECT_EQ(values, (std::vector<float>{2.5f, 3.5f, 4.5f}));
+
+    values = vec1;
+    vector_ops::normalizeInPlace(values);
+    EXPECT_EQ(values, vector_ops::normalize(vec1));
+
+    values = vec1;
+    vector_ops::composeInPlace(values, vec2, 0.3f);
+    EXPECT_EQ(values, vector_ops::compose(vec1, vec2, 0.3f));
+
+    values = vec1;
+    vector_ops::softmaxInPlace(values);
+    EXPECT_NEAR(values[0], 0.090031f, 1e-6);
+    EXPECT_NEAR(values[2], 0.665241f, 1e-6);
+
+    EXPECT_THROW(vector_ops::addInPlace(values, empty), std::invalid_argument);
+}
+
+TEST_F(VectorUtilsTest, SoftmaxRows)
+{
+    // Rows with large logits stay finite thanks to the max subtraction
+    std::vector<float> logits{1.0f, 2.0f, 3.0f, 1000.0f, 1000.0f, 1000.0f};
+    std::vector<float> out(logits.size());
+    vector_ops::softmaxRows(logits.data(), 2, 3, out.data());
+
+    EXPECT_NEAR(out[0], 0.090031f, 1e-6);
+    EXPECT_NEAR(out[2], 0.665241f, 1e-6);
+    for (size_t i = 3; i < 6; ++i)
+        EXPECT_NEAR(out[i], 1.0f / 3.0f, 1e-6);
+}
+
+class VectorUtilsSimdTest : public testing::TestWithParam<simd::Level>
+{
+protected:
+    void SetUp() override
+    {
+        simd::setLevel(GetParam());
+        // Odd sizes exercise both the vector bodies and the scalar tails
+        cv::RNG rng(7);
+        a.resize(1037);
+        b.resize(a.size());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            a[i] = rng.uniform(-20.f, 20.f);
+            b[i] = rng.uniform(-1.f, 1.f);
+        }
+    }
+
+    void TearDown() override
+    {
+        simd::setLevel(simd::detectLevel());
+    }
+
+    std::vector<float> a, b;
+};
+
+TEST_P(VectorUtilsSimdTest, Reductions)
+{
+    for (size_t size : {0, 1, 3, 15, 33, 100, 1037})
+    {
+        double dot = 0.0, sum = 0.0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            dot += static_cast<double>(a[i]) * b[i];
+            sum += a[i];
+        }
+        EXPECT_NEAR(vector_ops::dot(a.data(), b.data(), size), dot, 1e-4 * (1.0 + std::abs(dot)));
+        EXPECT_NEAR(vector_ops::sum(a.data(), size), sum, 1e-4 * (1.0 + std::abs(sum)));
+        if (size > 0)
+        {
+            EXPECT_EQ(vector_ops::max(a.data(), size), *std::max_element(a.begin(), a.begin() + size));
+        }
+    }
+}
+
+TEST_P(VectorUtilsSimdTest, ExpSigmoidSoftmax)
+{
+    std::vector<float> out(a.size());
+
+    vector_ops::exp(a.data(), a.size(), out.data());
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_NEAR(out[i], std::exp(static_cast<double>(a[i])), 1.2e-7 * std::exp(static_cast<double>(a[i])));
+
+    vector_ops::sigmoid(a.data(), a.size(), out.data());
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_NEAR(out[i], 1.f / (1.f + std::exp(-a[i])), 1e-6f);
+
+    vector_ops::softmax(a.data(), a.size(), out.data());
+    const float max_logit = *std::max_element(a.begin(), a.end());
+    double sum_exp = 0.0;
+    for (float x : a)
+        sum_exp += std::exp(static_cast<double>(x - max_logit));
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_NEAR(out[i], std::exp(static_cast<double>(a[i] - max_logit)) / sum_exp, 1e-6);
+}
+
+TEST_P(VectorUtilsSimdTest, ExpLimits)
+{
+    std::vector<float> x{-1000.f, -87.f, 0.f, 88.f, 1000.f, std::numeric_limits<float>::quiet_NaN()};
+    std::vector<float> out(x.size());
+    vector_ops::exp(x.data(), x.size(), out.data());
+
+    EXPECT_LT(out[0], 1e-37f);
+    EXPECT_NEAR(out[1], std::exp(-87.f), 1e-6f * std::exp(-87.f));
+    EXPECT_EQ(out[2], 1.f);
+    if (simd::level() != simd::Level::Scalar)
+    {
+        // The polynomial path saturates instead of overflowing
+        EXPECT_TRUE(std::isfinite(out[4]));
+    }
+    EXPECT_TRUE(std::isnan(out[5]));
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, VectorUtilsSimdTest,
+                         testing::Values(simd::Level::Scalar, simd::Level::SSE4, simd::Level::AVX2, simd::Level::AVX512));